@@ -0,0 +1,140 @@
+// Input throughput benchmark: every file is parsed with its input read through
+// std::ifstream into a buffer (Stream) and through a memory mapping (Mapped),
+// the two ByteSource backings a parser can be given.
+//
+//   vv_input_bench <mesh>... [--repeat N]
+//
+// Formats whose parsers read their input themselves are covered: Carto,
+// FreeSurfer, JSON, LS-DYNA, PLY, STL and DIF XML.
+#include "ByteSource.h"
+#include "CartoMeshParser.h"
+#include "FSurfMeshParser.h"
+#include "JsonMeshParser.h"
+#include "LSDynaMeshParser.h"
+#include "MeshParser.h"
+#include "PlyMeshParser.h"
+#include "StlMeshParser.h"
+#include "XMLMeshParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+struct ParserKind {
+  const char* name;
+  std::function<std::unique_ptr<MeshParser>()> make;
+};
+
+const std::vector<ParserKind>& parserKinds() {
+  static const std::vector<ParserKind> kinds = {
+      {"xml", [] { return std::make_unique<XMLMeshParser>(); }},
+      {"json", [] { return std::make_unique<JsonMeshParser>(); }},
+      {"carto", [] { return std::make_unique<CartoMeshParser>(); }},
+      {"fsurf", [] { return std::make_unique<FSurfMeshParser>(); }},
+      {"ply", [] { return std::make_unique<PlyMeshParser>(); }},
+      {"stl", [] { return std::make_unique<StlMeshParser>(); }},
+      {"lsdyna", [] { return std::make_unique<LSDynaMeshParser>(); }},
+  };
+  return kinds;
+}
+
+// Detection order matches loadMeshes for these formats.
+const ParserKind* detect(const std::string& path) {
+  const FileHead head = FileHead::read(path);
+  for (const ParserKind& kind : parserKinds()) {
+    if (kind.make()->canParse(head)) {
+      return &kind;
+    }
+  }
+  return nullptr;
+}
+
+// A fresh parser per run, so nothing read by canParse or an earlier run is
+// reused.
+double secondsToParse(const ParserKind& kind,
+                      ByteSource::Backing backing,
+                      const std::string& path,
+                      int repeat) {
+  double best = 1e300;
+  for (int i = 0; i < repeat; ++i) {
+    auto parser = kind.make();
+    parser->setInputBacking(backing);
+    const auto start = std::chrono::steady_clock::now();
+    const auto meshes = parser->parse(path);
+    const auto stop = std::chrono::steady_clock::now();
+    if (meshes.empty()) {
+      std::cerr << "vv_input_bench: parse produced no meshes: " << path << '\n';
+      std::exit(1);
+    }
+    best = std::min(best, std::chrono::duration<double>(stop - start).count());
+  }
+  return best;
+}
+
+void printRow(const std::string& format,
+              const std::string& backing,
+              double seconds,
+              double megabytes) {
+  std::cout << std::left << std::setw(8) << format << std::setw(9) << backing << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3) << seconds << std::setw(12)
+            << std::setprecision(1) << megabytes / seconds << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> paths;
+  int repeat = 3;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty()) {
+    std::cerr << "Usage: vv_input_bench <mesh>... [--repeat N]\n";
+    return 1;
+  }
+
+  for (const std::string& path : paths) {
+    std::error_code ec;
+    const auto bytes = std::filesystem::file_size(path, ec);
+    if (ec) {
+      std::cerr << "vv_input_bench: cannot stat " << path << '\n';
+      return 1;
+    }
+    const ParserKind* kind = detect(path);
+    if (!kind) {
+      std::cerr << "vv_input_bench: no byte-level parser for " << path << '\n';
+      return 1;
+    }
+
+    const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << path << ": " << std::fixed << std::setprecision(1) << megabytes
+              << " MB, best of " << repeat << "\n\n";
+    std::cout << std::left << std::setw(8) << "format" << std::setw(9) << "input" << std::right
+              << std::setw(12) << "seconds" << std::setw(12) << "MB/s" << '\n';
+    printRow(kind->name,
+             "stream",
+             secondsToParse(*kind, ByteSource::Backing::Stream, path, repeat),
+             megabytes);
+    printRow(kind->name,
+             "mapped",
+             secondsToParse(*kind, ByteSource::Backing::Mapped, path, repeat),
+             megabytes);
+    std::cout << '\n';
+  }
+  return 0;
+}
@@ -0,0 +1,198 @@
+// Throughput benchmark for LSDynaMeshParser: the single-threaded streamed
+// (std::getline) reader versus the mapped, chunked reader at increasing thread
+// counts. Both share the current card parser and part assembly, so the
+// baseline measures line-by-line reading, not the parser vv shipped before.
+//
+//   vv_lsdyna_bench <deck.k> [--repeat N] [--include]
+//   vv_lsdyna_bench --generate <nodes> [--repeat N] [--include]   (synthetic deck in $TMPDIR)
+//
+// --include parses a small main deck that *INCLUDEs the deck next to a second,
+// tiny include, so the deck is read as one task of a multi-file include wave;
+// its mapped throughput should still scale with the thread count.
+#include "LSDynaMeshParser.h"
+#include "parallel_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+  const char* tmpDir = std::getenv("TMPDIR");
+  return std::string(tmpDir && *tmpDir ? tmpDir : "/tmp") + "/" + name;
+}
+
+std::string writeSyntheticDeck(long long nodeCount) {
+  const std::string path = tempPath("vv_lsdyna_bench.k");
+  std::ofstream out(path);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> coord(-500.0, 500.0);
+  std::uniform_int_distribution<long long> node(1, nodeCount);
+
+  out << "*KEYWORD\n*PART\nsynthetic\n       1       1\n*NODE\n";
+  char line[128];
+  for (long long nid = 1; nid <= nodeCount; ++nid) {
+    std::snprintf(
+        line, sizeof(line), "%8lld%16.6f%16.6f%16.6f\n", nid, coord(rng), coord(rng), coord(rng));
+    out << line;
+  }
+  out << "*ELEMENT_SOLID\n";
+  for (long long eid = 1; eid <= nodeCount / 2; ++eid) {
+    const long long a = node(rng), b = node(rng), c = node(rng), d = node(rng);
+    std::snprintf(line, sizeof(line), "%8lld%8d\n", eid, 1);
+    out << line;
+    std::snprintf(line,
+                  sizeof(line),
+                  "%8lld%8lld%8lld%8lld%8lld%8lld%8lld%8lld\n",
+                  a, b, c, d, d, d, d, d);
+    out << line;
+  }
+  out << "*END\n";
+  return path;
+}
+
+// The largest node id in the *NODE cards of `deck` (fixed or comma format).
+long long maxNodeId(const std::string& deck) {
+  std::ifstream in(deck);
+  std::string line;
+  bool inNodes = false;
+  long long maxId = 0;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '$') {
+      continue;
+    }
+    if (line[0] == '*') {
+      inNodes = line.compare(0, 5, "*NODE") == 0 &&
+                (line.size() == 5 || line[5] == ' ' || line[5] == '\r');
+      continue;
+    }
+    if (inNodes) {
+      maxId = std::max(maxId, std::atoll(line.substr(0, line.find(',')).substr(0, 8).c_str()));
+    }
+  }
+  return maxId;
+}
+
+// A main deck including `deck` and a one-part sibling deck, both in one wave.
+// The sibling's nodes are numbered just past `deck`'s last node, so the node id
+// span stays dense and assembly takes the same path as for `deck` alone.
+std::string writeIncludingDeck(const std::string& deck, long long lastNodeId) {
+  const std::string sibling = tempPath("vv_lsdyna_bench_sibling.k");
+  {
+    std::ofstream out(sibling);
+    out << "*KEYWORD\n*PART\nsibling\n       2       2\n*NODE\n";
+    char line[128];
+    for (long long nid = lastNodeId + 1; nid <= lastNodeId + 3; ++nid) {
+      std::snprintf(line, sizeof(line), "%8lld%16.6f%16.6f%16.6f\n", nid, 0.0, 0.0, 0.0);
+      out << line;
+    }
+    out << "*END\n";
+  }
+  const std::string path = tempPath("vv_lsdyna_bench_main.k");
+  std::ofstream out(path);
+  out << "*KEYWORD\n*INCLUDE\n"
+      << std::filesystem::absolute(deck).string() << '\n'
+      << sibling << "\n*END\n";
+  return path;
+}
+
+double secondsToParse(LSDynaMeshParser::ReadMode mode, const std::string& path, int repeat) {
+  double best = 1e300;
+  for (int i = 0; i < repeat; ++i) {
+    LSDynaMeshParser parser(mode);
+    const auto start = std::chrono::steady_clock::now();
+    const auto meshes = parser.parse(path);
+    const auto stop = std::chrono::steady_clock::now();
+    if (meshes.empty()) {
+      std::cerr << "vv_lsdyna_bench: parse produced no parts: " << path << '\n';
+      std::exit(1);
+    }
+    best = std::min(best, std::chrono::duration<double>(stop - start).count());
+  }
+  return best;
+}
+
+void printRow(const std::string& label, unsigned threads, double seconds, double megabytes) {
+  const double mbps = megabytes / seconds;
+  std::cout << std::left << std::setw(10) << label << std::right << std::setw(8) << threads
+            << std::setw(12) << std::fixed << std::setprecision(3) << seconds << std::setw(12)
+            << std::setprecision(1) << mbps << std::setw(14) << mbps / threads << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::string path;
+  int repeat = 3;
+  bool include = false;
+  long long generatedNodes = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--generate" && i + 1 < argc) {
+      generatedNodes = std::max(8LL, std::atoll(argv[++i]));
+      path = writeSyntheticDeck(generatedNodes);
+    } else if (arg == "--include") {
+      include = true;
+    } else {
+      path = arg;
+    }
+  }
+  if (path.empty()) {
+    std::cerr << "Usage: vv_lsdyna_bench <deck.k> | --generate <nodes> [--repeat N] [--include]\n";
+    return 1;
+  }
+
+  std::error_code ec;
+  const auto bytes = std::filesystem::file_size(path, ec);
+  if (ec) {
+    std::cerr << "vv_lsdyna_bench: cannot stat " << path << '\n';
+    return 1;
+  }
+  const double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+  if (include) {
+    // Throughput stays relative to the included deck, which is nearly all the bytes.
+    const long long lastNodeId = generatedNodes > 0 ? generatedNodes : maxNodeId(path);
+    std::cout << "included from " << (path = writeIncludingDeck(path, lastNodeId)) << '\n';
+  }
+  std::cout << path << ": " << std::fixed << std::setprecision(1) << megabytes << " MB, best of "
+            << repeat << "\n\n";
+  std::cout << std::left << std::setw(10) << "mode" << std::right << std::setw(8) << "threads"
+            << std::setw(12) << "seconds" << std::setw(12) << "MB/s" << std::setw(14)
+            << "MB/s/thread" << '\n';
+
+  setWorkerThreadLimit(1);
+  printRow("streamed",
+           1,
+           secondsToParse(LSDynaMeshParser::ReadMode::Streamed, path, repeat),
+           megabytes);
+
+  setWorkerThreadLimit(0);
+  // Powers of two up to the core count, plus the core count itself.
+  const unsigned maxThreads = workerThreadCount();
+  std::vector<unsigned> threadCounts;
+  for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  for (unsigned threads : threadCounts) {
+    setWorkerThreadLimit(threads);
+    printRow("mapped",
+             threads,
+             secondsToParse(LSDynaMeshParser::ReadMode::Mapped, path, repeat),
+             megabytes);
+  }
+  return 0;
+}
@@ -0,0 +1,689 @@
+// Headless benchmark over the core library: writes the same synthetic surface
+// in every text and binary format vv reads, then reports as JSON, per format,
+// the load throughput (format detection and parsing through loadMeshes, cache
+// off), the process peak RSS so far and the time analyzeScalar /
+// computeScalarGlobalRange take on the loaded scalar. With --temporal, the
+// per-frame read latency of a time series (.vtkhdf, d3plot) is measured too,
+// reading every array and then only its first point array and its first cell
+// array, then the latency of scrubbing back and forth over its first frames
+// through FramePrefetcher, with the frame cache counters (--frame-cache sizes
+// the cache, e.g. 4G).
+//
+//   vv_bench [--size N] [--repeat N] [--formats stl,ply,...] [--temporal <file>]
+//            [--frames N] [--frame-cache SIZE] [--output results.json]
+//
+// The surface is an N x N vertex grid (2 (N-1)^2 triangles) with a `pressure`
+// point scalar where the format can carry one. processPeakRssBytes is the
+// high-water mark of the whole process up to that row, not of the row alone:
+// it never drops, so a format measured after a larger one repeats that
+// figure. Run one format per process (--formats) for per-format figures.
+#include "FrameCache.h"
+#include "FramePrefetcher.h"
+#include "MeshLoading.h"
+#include "ScalarVizUtils.h"
+#include "TemporalSource.h"
+#include "parallel_utils.h"
+#include "version.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkPointData.h>
+#ifdef _WIN32
+#include <windows.h>
+// psapi.h needs windows.h first.
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#if defined(__GNUC__)
+#define VV_BENCH_PRINTF(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define VV_BENCH_PRINTF(fmt, args)
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Process-cumulative: the largest resident set since the process started.
+uint64_t processPeakRssBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss); // bytes
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024u; // kilobytes
+#endif
+#endif
+}
+
+// The synthetic surface: a gently waved unit square.
+struct Grid {
+  uint32_t side;
+
+  size_t points() const {
+    return size_t{side} * side;
+  }
+  size_t triangles() const {
+    return size_t{side - 1} * (side - 1) * 2u;
+  }
+  std::array<float, 3> point(size_t k) const {
+    const float x = static_cast<float>(k % side) / static_cast<float>(side - 1);
+    const float y = static_cast<float>(k / side) / static_cast<float>(side - 1);
+    return {x, y, 0.1f * std::sin(6.0f * x) * std::cos(6.0f * y)};
+  }
+  float pressure(size_t k) const {
+    return 10.0f * point(k)[2];
+  }
+  // Zero-based corners of triangle t, counter-clockwise.
+  std::array<uint32_t, 3> triangle(size_t t) const {
+    const size_t quad = t / 2;
+    const auto i = static_cast<uint32_t>(quad % (side - 1));
+    const auto j = static_cast<uint32_t>(quad / (side - 1));
+    const uint32_t a = j * side + i;
+    const uint32_t b = a + 1;
+    const uint32_t c = a + side;
+    const uint32_t d = c + 1;
+    if (t % 2 == 0)
+      return {a, b, d};
+    return {a, d, c};
+  }
+};
+
+// Text output goes through a line buffer; the formats below are one record per
+// line.
+class LineWriter {
+public:
+  explicit LineWriter(const std::string& path) : out_(path, std::ios::binary) {}
+
+  void line(const char* format, ...) VV_BENCH_PRINTF(2, 3) {
+    va_list args;
+    va_start(args, format);
+    const int n = std::vsnprintf(buffer_, sizeof(buffer_), format, args);
+    va_end(args);
+    if (n > 0) {
+      out_.write(buffer_, std::min<std::streamsize>(n, kBufferBytes - 1));
+    }
+  }
+  void text(const std::string& s) {
+    out_ << s;
+  }
+  bool ok() const {
+    return static_cast<bool>(out_);
+  }
+  std::ofstream& stream() {
+    return out_;
+  }
+
+private:
+  static constexpr std::streamsize kBufferBytes = 256;
+  std::ofstream out_;
+  char buffer_[kBufferBytes];
+};
+
+void putBigEndian32(std::ofstream& out, uint32_t value) {
+  const char bytes[4] = {static_cast<char>(value >> 24),
+                         static_cast<char>(value >> 16),
+                         static_cast<char>(value >> 8),
+                         static_cast<char>(value)};
+  out.write(bytes, 4);
+}
+
+void putBigEndianFloat(std::ofstream& out, float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  putBigEndian32(out, bits);
+}
+
+template <typename T> void putLittleEndian(std::ofstream& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  // Every platform vv is built for is little-endian.
+  out.write(bytes, sizeof(T));
+}
+
+bool writeLegacyVtk(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.line("# vtk DataFile Version 3.0\nvv_bench\nBINARY\nDATASET POLYDATA\nPOINTS %zu float\n",
+         grid.points());
+  for (size_t k = 0; k < grid.points(); ++k) {
+    for (const float v : grid.point(k))
+      putBigEndianFloat(w.stream(), v);
+  }
+  w.line("\nPOLYGONS %zu %zu\n", grid.triangles(), grid.triangles() * 4);
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    putBigEndian32(w.stream(), 3);
+    for (const uint32_t id : grid.triangle(t))
+      putBigEndian32(w.stream(), id);
+  }
+  w.line("\nPOINT_DATA %zu\nSCALARS pressure float 1\nLOOKUP_TABLE default\n", grid.points());
+  for (size_t k = 0; k < grid.points(); ++k)
+    putBigEndianFloat(w.stream(), grid.pressure(k));
+  w.text("\n");
+  return w.ok();
+}
+
+bool writeVtp(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.text("<?xml version=\"1.0\"?>\n"
+         "<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n"
+         "<PolyData>\n");
+  w.line("<Piece NumberOfPoints=\"%zu\" NumberOfPolys=\"%zu\">\n", grid.points(), grid.triangles());
+  w.text("<PointData Scalars=\"pressure\">\n"
+         "<DataArray type=\"Float32\" Name=\"pressure\" format=\"ascii\">\n");
+  for (size_t k = 0; k < grid.points(); ++k)
+    w.line("%g\n", static_cast<double>(grid.pressure(k)));
+  w.text("</DataArray>\n</PointData>\n<Points>\n"
+         "<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n");
+  for (size_t k = 0; k < grid.points(); ++k) {
+    const auto p = grid.point(k);
+    w.line("%g %g %g\n",
+           static_cast<double>(p[0]),
+           static_cast<double>(p[1]),
+           static_cast<double>(p[2]));
+  }
+  w.text("</DataArray>\n</Points>\n<Polys>\n"
+         "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n");
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    const auto c = grid.triangle(t);
+    w.line("%u %u %u\n", c[0], c[1], c[2]);
+  }
+  w.text("</DataArray>\n<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n");
+  for (size_t t = 1; t <= grid.triangles(); ++t)
+    w.line("%zu\n", t * 3);
+  w.text("</DataArray>\n</Polys>\n</Piece>\n</PolyData>\n</VTKFile>\n");
+  return w.ok();
+}
+
+bool writePly(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.line("ply\nformat binary_little_endian 1.0\nelement vertex %zu\n", grid.points());
+  w.text("property float x\nproperty float y\nproperty float z\nproperty float pressure\n");
+  w.line("element face %zu\nproperty list uchar int vertex_indices\nend_header\n",
+         grid.triangles());
+  for (size_t k = 0; k < grid.points(); ++k) {
+    for (const float v : grid.point(k))
+      putLittleEndian(w.stream(), v);
+    putLittleEndian(w.stream(), grid.pressure(k));
+  }
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    putLittleEndian(w.stream(), uint8_t{3});
+    for (const uint32_t id : grid.triangle(t))
+      putLittleEndian(w.stream(), static_cast<int32_t>(id));
+  }
+  return w.ok();
+}
+
+bool writeStl(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  const std::string header(80, ' ');
+  w.stream().write(header.data(), 80);
+  putLittleEndian(w.stream(), static_cast<uint32_t>(grid.triangles()));
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    for (int i = 0; i < 3; ++i)
+      putLittleEndian(w.stream(), 0.0f); // normal
+    for (const uint32_t id : grid.triangle(t)) {
+      for (const float v : grid.point(id))
+        putLittleEndian(w.stream(), v);
+    }
+    putLittleEndian(w.stream(), uint16_t{0});
+  }
+  return w.ok();
+}
+
+bool writeJson(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.text("{\"name\": \"vv_bench\",\n\"vertices\": [");
+  for (size_t k = 0; k < grid.points(); ++k) {
+    const auto p = grid.point(k);
+    w.line(k == 0 ? "%g,%g,%g" : ",%g,%g,%g",
+           static_cast<double>(p[0]),
+           static_cast<double>(p[1]),
+           static_cast<double>(p[2]));
+  }
+  w.text("],\n\"indices\": [");
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    const auto c = grid.triangle(t);
+    w.line(t == 0 ? "%u,%u,%u" : ",%u,%u,%u", c[0], c[1], c[2]);
+  }
+  w.text("]}\n");
+  return w.ok();
+}
+
+bool writeCarto(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.text("#TriangulatedMeshVersion2.0\n[GeneralAttributes]\n");
+  w.line("NumVertex = %zu\nNumTriangle = %zu\n\n[VerticesSection]\n",
+         grid.points(),
+         grid.triangles());
+  for (size_t k = 0; k < grid.points(); ++k) {
+    const auto p = grid.point(k);
+    w.line("%zu = %g %g %g 0 0 1 0\n",
+           k,
+           static_cast<double>(p[0]),
+           static_cast<double>(p[1]),
+           static_cast<double>(p[2]));
+  }
+  w.text("\n[TrianglesSection]\n");
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    const auto c = grid.triangle(t);
+    w.line("%zu = %u %u %u 0 0 1 0\n", t, c[0], c[1], c[2]);
+  }
+  return w.ok();
+}
+
+bool writeDifXml(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.text("<?xml version=\"1.0\"?>\n<DIF>\n<DIFBody>\n<Volumes>\n<Volume name=\"vv_bench\">\n"
+         "<Vertices>\n");
+  for (size_t k = 0; k < grid.points(); ++k) {
+    const auto p = grid.point(k);
+    w.line("%g %g %g\n",
+           static_cast<double>(p[0]),
+           static_cast<double>(p[1]),
+           static_cast<double>(p[2]));
+  }
+  w.text("</Vertices>\n<Polygons>\n");
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    const auto c = grid.triangle(t);
+    w.line("%u %u %u\n", c[0] + 1, c[1] + 1, c[2] + 1); // one-based
+  }
+  w.text("</Polygons>\n</Volume>\n</Volumes>\n</DIFBody>\n</DIF>\n");
+  return w.ok();
+}
+
+bool writeFreeSurfer(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.stream().write("\xff\xff\xfe", 3);
+  w.text("created by vv_bench\n\n");
+  putBigEndian32(w.stream(), static_cast<uint32_t>(grid.points()));
+  putBigEndian32(w.stream(), static_cast<uint32_t>(grid.triangles()));
+  for (size_t k = 0; k < grid.points(); ++k) {
+    for (const float v : grid.point(k))
+      putBigEndianFloat(w.stream(), v);
+  }
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    for (const uint32_t id : grid.triangle(t))
+      putBigEndian32(w.stream(), id);
+  }
+  return w.ok();
+}
+
+bool writeLsDyna(const Grid& grid, const std::string& path) {
+  LineWriter w(path);
+  w.text("*KEYWORD\n*PART\nvv_bench\n       1       1\n*NODE\n");
+  for (size_t k = 0; k < grid.points(); ++k) {
+    const auto p = grid.point(k);
+    w.line("%8zu%16.6f%16.6f%16.6f\n",
+           k + 1,
+           static_cast<double>(p[0]),
+           static_cast<double>(p[1]),
+           static_cast<double>(p[2]));
+  }
+  w.text("*ELEMENT_SHELL\n");
+  for (size_t t = 0; t < grid.triangles(); ++t) {
+    const auto c = grid.triangle(t);
+    // Triangles as degenerate quads (n4 = n3), as LS-DYNA writes them.
+    w.line("%8zu%8d%8u%8u%8u%8u\n", t + 1, 1, c[0] + 1, c[1] + 1, c[2] + 1, c[2] + 1);
+  }
+  w.text("*END\n");
+  return w.ok();
+}
+
+struct Format {
+  const char* name;
+  const char* file; // FreeSurfer surfaces are recognised by name
+  std::function<bool(const Grid&, const std::string&)> write;
+};
+
+const std::vector<Format>& formats() {
+  static const std::vector<Format> all = {
+      {"vtk", "surface.vtk", writeLegacyVtk},
+      {"vtp", "surface.vtp", writeVtp},
+      {"ply", "surface.ply", writePly},
+      {"stl", "surface.stl", writeStl},
+      {"json", "surface.json", writeJson},
+      {"carto", "surface.mesh", writeCarto},
+      {"xml", "surface.xml", writeDifXml},
+      {"fsurf", "lh.white", writeFreeSurfer},
+      {"lsdyna", "surface.k", writeLsDyna},
+  };
+  return all;
+}
+
+std::vector<vtkDataSet*> rawPointers(const LoadedMeshes& meshes) {
+  std::vector<vtkDataSet*> ptrs;
+  for (const auto& mesh : meshes.meshes)
+    ptrs.push_back(mesh.GetPointer());
+  return ptrs;
+}
+
+// The first named array with the given association.
+bool firstArray(vtkDataSet* mesh, FieldAssociation association, std::string& name) {
+  vtkDataSetAttributes* data = association == FieldAssociation::Point
+                                   ? static_cast<vtkDataSetAttributes*>(mesh->GetPointData())
+                                   : static_cast<vtkDataSetAttributes*>(mesh->GetCellData());
+  for (int i = 0; data && i < data->GetNumberOfArrays(); ++i) {
+    if (vtkDataArray* array = data->GetArray(i); array && array->GetName()) {
+      name = array->GetName();
+      return true;
+    }
+  }
+  return false;
+}
+
+// The first named array of the first part, point data before cell data.
+bool firstScalar(vtkDataSet* mesh, std::string& name, FieldAssociation& association) {
+  for (const FieldAssociation candidate : {FieldAssociation::Point, FieldAssociation::Cell}) {
+    if (firstArray(mesh, candidate, name)) {
+      association = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+nlohmann::json benchFormat(const Format& format,
+                           const Grid& grid,
+                           const std::filesystem::path& dir,
+                           int repeat) {
+  nlohmann::json row;
+  row["format"] = format.name;
+  const std::string path = (dir / format.file).string();
+  const auto writeStart = Clock::now();
+  if (!format.write(grid, path)) {
+    row["error"] = "cannot write " + path;
+    return row;
+  }
+  row["writeSeconds"] = secondsSince(writeStart);
+  std::error_code ec;
+  const auto bytes = std::filesystem::file_size(path, ec);
+  row["bytes"] = ec ? 0 : static_cast<uint64_t>(bytes);
+
+  MeshLoadOptions options;
+  options.useCache = false;
+  MeshLoadResult loaded;
+  double best = 1e300;
+  for (int i = 0; i < repeat; ++i) {
+    const auto start = Clock::now();
+    loaded = loadMeshes({path}, false, options);
+    best = std::min(best, secondsSince(start));
+    if (!loaded.ok) {
+      row["error"] = loaded.error;
+      std::filesystem::remove(path, ec);
+      return row;
+    }
+  }
+  row["parseSeconds"] = best;
+  row["megabytesPerSecond"] = static_cast<double>(bytes) / (1024.0 * 1024.0) / best;
+  row["processPeakRssBytes"] = processPeakRssBytes();
+
+  vtkIdType points = 0;
+  vtkIdType cells = 0;
+  for (const auto& mesh : loaded.meshes.meshes) {
+    points += mesh->GetNumberOfPoints();
+    cells += mesh->GetNumberOfCells();
+  }
+  row["points"] = points;
+  row["cells"] = cells;
+
+  std::string scalar;
+  FieldAssociation association = FieldAssociation::Point;
+  if (!loaded.meshes.meshes.empty() &&
+      firstScalar(loaded.meshes.meshes.front(), scalar, association)) {
+    const std::vector<vtkDataSet*> meshes = rawPointers(loaded.meshes);
+    auto start = Clock::now();
+    const ScalarAnalysis analysis = analyzeScalar(meshes, scalar, association);
+    const double analyzeSeconds = secondsSince(start);
+    double range[2] = {0.0, 0.0};
+    start = Clock::now();
+    computeScalarGlobalRange(meshes, scalar, association, range);
+    const double rangeSeconds = secondsSince(start);
+    row["scalar"] = {{"name", scalar},
+                     {"association", association == FieldAssociation::Point ? "point" : "cell"},
+                     {"categorical", analysis.categorical},
+                     {"analyzeSeconds", analyzeSeconds},
+                     {"rangeSeconds", rangeSeconds}};
+  }
+  std::filesystem::remove(path, ec);
+  return row;
+}
+
+// Scrub forward and back over the first `frames` steps `passes` times, the way
+// a slider is dragged, showing each step as soon as the prefetcher has it.
+nlohmann::json benchScrub(const TemporalSource& source,
+                          vtkDataSet* mesh,
+                          int frames,
+                          uint64_t cacheBytes) {
+  constexpr int passes = 3;
+  std::mutex mutex;
+  std::condition_variable arrived;
+  int arrivedStep = -1;
+  FramePrefetcher prefetcher(
+      source,
+      mesh,
+      [&](int step) {
+        {
+          const std::lock_guard<std::mutex> lock(mutex);
+          arrivedStep = step;
+        }
+        arrived.notify_all();
+      },
+      cacheBytes);
+  nlohmann::json row;
+  if (!prefetcher.valid()) {
+    row["error"] = "source cannot be cloned";
+    return row;
+  }
+  prefetcher.setLoop(false);
+
+  std::vector<int> order;
+  for (int pass = 0; pass < passes; ++pass) {
+    for (int step = 0; step < frames; ++step) {
+      order.push_back(step);
+    }
+    for (int step = frames - 2; step > 0; --step) {
+      order.push_back(step);
+    }
+  }
+  double total = 0.0;
+  double worst = 0.0;
+  for (const int step : order) {
+    const auto start = Clock::now();
+    while (!prefetcher.take(step, mesh)) {
+      std::unique_lock<std::mutex> lock(mutex);
+      arrived.wait_for(lock, std::chrono::milliseconds(10), [&]() { return arrivedStep == step; });
+    }
+    const double ms = secondsSince(start) * 1000.0;
+    total += ms;
+    worst = std::max(worst, ms);
+  }
+  const FrameCache::Stats stats = prefetcher.cacheStats();
+  row["framesShown"] = order.size();
+  row["meanFrameMs"] = order.empty() ? 0.0 : total / static_cast<double>(order.size());
+  row["maxFrameMs"] = worst;
+  row["cacheBudgetBytes"] = cacheBytes;
+  row["cacheHits"] = stats.hits;
+  row["cacheMisses"] = stats.misses;
+  row["cacheFrames"] = stats.frames;
+  row["cacheBytes"] = stats.bytes;
+  return row;
+}
+
+// Read the first `count` steps into `mesh`, recording the mean and worst time
+// per frame. False, with an error in `row`, if a step cannot be read.
+bool timeFrames(TemporalSource& source, vtkDataSet* mesh, int count, nlohmann::json& row) {
+  double total = 0.0;
+  double worst = 0.0;
+  for (int step = 0; step < count; ++step) {
+    const auto start = Clock::now();
+    if (!source.readStepInto(step, mesh)) {
+      row["error"] = "cannot read step " + std::to_string(step);
+      return false;
+    }
+    const double ms = secondsSince(start) * 1000.0;
+    total += ms;
+    worst = std::max(worst, ms);
+  }
+  row["meanFrameMs"] = count > 0 ? total / count : 0.0;
+  row["maxFrameMs"] = worst;
+  return true;
+}
+
+nlohmann::json benchTemporal(const std::string& path, int frames, uint64_t cacheBytes) {
+  nlohmann::json row;
+  row["file"] = path;
+  MeshLoadOptions options;
+  options.useCache = false;
+  MeshLoadResult loaded = loadMeshes({path}, false, options);
+  if (!loaded.ok || !loaded.temporal || loaded.meshes.meshes.empty()) {
+    row["error"] = loaded.ok ? "not a time series" : loaded.error;
+    return row;
+  }
+  TemporalSource& source = *loaded.temporal;
+  vtkDataSet* mesh = loaded.meshes.meshes.front();
+  const int count = std::min(frames, source.steps());
+  row["steps"] = source.steps();
+  row["framesRead"] = count;
+  if (!timeFrames(source, mesh, count, row)) {
+    return row;
+  }
+
+  // The same frames with reads restricted to one array, as while a scalar is
+  // shown: the first point array and the first cell array.
+  for (const FieldAssociation association : {FieldAssociation::Point, FieldAssociation::Cell}) {
+    ScalarField field;
+    field.association = association;
+    if (!firstArray(mesh, association, field.name)) {
+      continue;
+    }
+    nlohmann::json active;
+    active["name"] = field.name;
+    source.setActiveArray(field);
+    timeFrames(source, mesh, count, active);
+    source.setActiveArray({});
+    // Put back the arrays the restricted reads dropped.
+    source.readStepInto(0, mesh);
+    row[association == FieldAssociation::Point ? "pointArray" : "cellArray"] = active;
+  }
+  row["scrub"] = benchScrub(source, mesh, count, cacheBytes);
+  row["processPeakRssBytes"] = processPeakRssBytes();
+  return row;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ','))
+    if (!item.empty())
+      items.push_back(item);
+  return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t side = 1000;
+  int repeat = 3;
+  int frames = 50;
+  uint64_t frameCacheBytes = 0;
+  std::vector<std::string> selected;
+  std::string temporalPath;
+  std::string outputPath;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--size" && i + 1 < argc) {
+      side = static_cast<uint32_t>(std::max(2L, std::atol(argv[++i])));
+    } else if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--formats" && i + 1 < argc) {
+      selected = splitList(argv[++i]);
+    } else if (arg == "--temporal" && i + 1 < argc) {
+      temporalPath = argv[++i];
+    } else if (arg == "--frames" && i + 1 < argc) {
+      frames = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--frame-cache" && i + 1 < argc &&
+               parseByteSize(argv[i + 1], frameCacheBytes)) {
+      ++i;
+    } else if (arg == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else {
+      std::cerr << "Usage: vv_bench [--size N] [--repeat N] [--formats stl,ply,...] "
+                   "[--temporal <file>] [--frames N] [--frame-cache SIZE] "
+                   "[--output results.json]\n";
+      return 1;
+    }
+  }
+
+  const char* tmpDir = std::getenv("TMPDIR");
+  const std::filesystem::path dir =
+      std::filesystem::path(tmpDir && *tmpDir ? tmpDir : "/tmp") / "vv_bench";
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+
+  const Grid grid{side};
+  nlohmann::json report;
+  report["version"] = VV_VERSION;
+  report["threads"] = workerThreadCount();
+  report["gridSide"] = side;
+  report["repeat"] = repeat;
+  report["formats"] = nlohmann::json::array();
+  for (const Format& format : formats()) {
+    if (!selected.empty() &&
+        std::find(selected.begin(), selected.end(), format.name) == selected.end())
+      continue;
+    std::cerr << "vv_bench: " << format.name << '\n';
+    report["formats"].push_back(benchFormat(format, grid, dir, repeat));
+  }
+  if (!temporalPath.empty()) {
+    report["temporal"] = benchTemporal(temporalPath, frames, frameCacheBytes);
+  }
+  std::filesystem::remove(dir, ec);
+
+  const std::string text = report.dump(2);
+  if (outputPath.empty()) {
+    std::cout << text << '\n';
+  } else {
+    std::ofstream out(outputPath);
+    out << text << '\n';
+    if (!out) {
+      std::cerr << "vv_bench: cannot write " << outputPath << '\n';
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include "ByteSource.h"
+
+#include <fstream>
+#include <utility>
+
+ByteSource::ByteSource(ByteSource&& other) noexcept {
+  *this = std::move(other);
+}
+
+ByteSource& ByteSource::operator=(ByteSource&& other) noexcept {
+  if (this != &other) {
+    // A moved vector keeps its heap block and a moved mapping its address, so
+    // data_ stays valid.
+    mapped_ = std::move(other.mapped_);
+    buffer_ = std::move(other.buffer_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    open_ = std::exchange(other.open_, false);
+    backing_ = std::exchange(other.backing_, Backing::Mapped);
+    other.buffer_.clear();
+  }
+  return *this;
+}
+
+bool ByteSource::open(const std::string& path, Backing backing) {
+  close();
+  if (backing == Backing::Mapped) {
+    if (!mapped_.open(path)) {
+      return false;
+    }
+    data_ = mapped_.data();
+    size_ = mapped_.size();
+    open_ = true;
+    backing_ = Backing::Mapped;
+    return true;
+  }
+
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  const std::streamoff length = in.tellg();
+  if (length < 0) {
+    return false;
+  }
+  std::vector<char> bytes(static_cast<size_t>(length));
+  in.seekg(0);
+  if (!bytes.empty() && !in.read(bytes.data(), static_cast<std::streamsize>(length))) {
+    return false;
+  }
+  buffer_ = std::move(bytes);
+  data_ = buffer_.empty() ? nullptr : buffer_.data();
+  size_ = buffer_.size();
+  open_ = true;
+  backing_ = Backing::Stream;
+  return true;
+}
+
+void ByteSource::close() {
+  mapped_.close();
+  buffer_ = {};
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+  backing_ = Backing::Mapped;
+}
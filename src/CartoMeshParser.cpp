@@ -1,158 +1,274 @@
 #include "CartoMeshParser.h"
 
-#include "mesh_utils.h"
+#include "ByteSource.h"
+#include "parallel_utils.h"
+#include "text_scan.h"
 
-#include <cctype>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 
-CartoMeshParser::~CartoMeshParser() = default;
+namespace {
+
+std::string_view trim(std::string_view s) {
+  const size_t a = s.find_first_not_of(" \t\r\n\f\v");
+  if (a == std::string_view::npos)
+    return {};
+  return s.substr(a, s.find_last_not_of(" \t\r\n\f\v") - a + 1);
+}
+
+bool isSectionHeader(std::string_view line) {
+  return line.length() > 2 && line.front() == '[' && line.back() == ']';
+}
 
-static std::string trim(const std::string& str) {
-  size_t first = str.find_first_not_of(" \t\n\r\f\v");
-  if (first == std::string::npos)
-    return "";
-  size_t last = str.find_last_not_of(" \t\n\r\f\v");
-  return str.substr(first, (last - first + 1));
+// Non-empty, non-comment line of a section body.
+bool isDataLine(std::string_view line) {
+  const std::string_view t = trim(line);
+  return !t.empty() && t[0] != ';';
 }
 
-static bool isSectionHeader(const std::string& line) {
-  return line.length() > 2 && line[0] == '[' && line[line.length() - 1] == ']';
+// Rows start with "<index> = "; return the position after the '='.
+bool skipRowIndex(const char*& p, const char* end) {
+  long long index = 0;
+  if (!scanInt(p, end, index))
+    return false;
+  p = skipBlanks(p, end);
+  if (p < end && *p == '=')
+    ++p;
+  return true;
 }
 
-static bool parseVertexLine(const std::string& line,
-                            double& x,
-                            double& y,
-                            double& z,
-                            double& nx,
-                            double& ny,
-                            double& nz,
-                            int& groupId) {
-  std::string processedLine = line;
-  size_t equalsPos = processedLine.find(" = ");
-  if (equalsPos != std::string::npos) {
-    processedLine.replace(equalsPos, 3, " ");
+// "<index> = x y z nx ny nz group"
+bool parseVertexLine(std::string_view line, float* xyz, float* normal, float& group) {
+  const char* p = line.data();
+  const char* end = p + line.size();
+  int groupId = 0;
+  if (!skipRowIndex(p, end) || !scanReal(p, end, xyz[0]) || !scanReal(p, end, xyz[1]) ||
+      !scanReal(p, end, xyz[2]) || !scanReal(p, end, normal[0]) ||
+      !scanReal(p, end, normal[1]) || !scanReal(p, end, normal[2]) ||
+      !scanInt(p, end, groupId))
+    return false;
+  group = static_cast<float>(groupId);
+  return true;
+}
+
+// "<index> = v0 v1 v2 nx ny nz group" (the face normal is not kept)
+bool parseTriangleLine(std::string_view line, vtkIdType* ids, int& group) {
+  const char* p = line.data();
+  const char* end = p + line.size();
+  double normal[3];
+  return skipRowIndex(p, end) && scanInt(p, end, ids[0]) && scanInt(p, end, ids[1]) &&
+         scanInt(p, end, ids[2]) && scanReal(p, end, normal[0]) &&
+         scanReal(p, end, normal[1]) && scanReal(p, end, normal[2]) && scanInt(p, end, group);
+}
+
+// A section body split into line-aligned chunks, with the output row each
+// chunk starts at (from a quick count of its data lines), so every chunk can
+// parse straight into its slice of the final arrays.
+struct SectionChunks {
+  std::vector<std::pair<const char*, const char*>> ranges;
+  std::vector<size_t> firstRow;
+  size_t rows = 0;
+};
+
+SectionChunks chunkSection(const char* begin, const char* end) {
+  SectionChunks chunks;
+  chunks.ranges = splitSection(begin, end, chunkCountFor(begin, end), acceptAnyLine);
+  std::vector<size_t> counts(chunks.ranges.size());
+  parallelFor(chunks.ranges.size(), [&](size_t i) {
+    LineReader lines(chunks.ranges[i].first, chunks.ranges[i].second);
+    std::string_view line;
+    while (lines.next(line)) {
+      if (isDataLine(line))
+        ++counts[i];
+    }
+  });
+  chunks.firstRow.resize(counts.size());
+  for (size_t i = 0; i < counts.size(); ++i) {
+    chunks.firstRow[i] = chunks.rows;
+    chunks.rows += counts[i];
   }
-  std::istringstream iss(processedLine);
-  long long index;
-  if (iss >> index >> x >> y >> z >> nx >> ny >> nz >> groupId)
-    return true;
-  return false;
+  return chunks;
 }
 
-static bool parseTriangleLine(const std::string& line,
-                              int& v0,
-                              int& v1,
-                              int& v2,
-                              double& nx,
-                              double& ny,
-                              double& nz,
-                              int& groupId) {
-  std::string processedLine = line;
-  size_t equalsPos = processedLine.find(" = ");
-  if (equalsPos != std::string::npos) {
-    processedLine.replace(equalsPos, 3, " ");
+// Run parseRow(row, line) over every data line, chunks in parallel. A line that
+// does not parse is skipped, as the old reader did; the gaps this leaves at the
+// end of a chunk are closed afterwards with moveRow(from, to). Returns the
+// number of rows kept. Chunks report their bytes to the parser's progress and
+// are skipped once the load is cancelled.
+template <typename ParseRow, typename MoveRow>
+size_t parseRows(const MeshParser& parser,
+                 const SectionChunks& chunks,
+                 ParseRow parseRow,
+                 MoveRow moveRow) {
+  std::vector<size_t> parsed(chunks.ranges.size());
+  parallelFor(chunks.ranges.size(), [&](size_t i) {
+    if (parser.cancelled())
+      return;
+    LineReader lines(chunks.ranges[i].first, chunks.ranges[i].second);
+    std::string_view line;
+    size_t row = chunks.firstRow[i];
+    while (lines.next(line)) {
+      if (isDataLine(line) && parseRow(row, line))
+        ++row;
+    }
+    parsed[i] = row - chunks.firstRow[i];
+    parser.advance(static_cast<uint64_t>(chunks.ranges[i].second - chunks.ranges[i].first));
+  });
+
+  size_t kept = 0;
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    if (kept != chunks.firstRow[i]) {
+      for (size_t r = 0; r < parsed[i]; ++r)
+        moveRow(chunks.firstRow[i] + r, kept + r);
+    }
+    kept += parsed[i];
   }
-  std::istringstream iss(processedLine);
-  long long index;
-  if (iss >> index >> v0 >> v1 >> v2 >> nx >> ny >> nz >> groupId)
-    return true;
-  return false;
+  return kept;
+}
+
+} // namespace
+
+CartoMeshParser::~CartoMeshParser() = default;
+
+std::string CartoMeshParser::cacheTag() const {
+  return "carto/2";
 }
 
 std::vector<vtkSmartPointer<vtkDataSet>> CartoMeshParser::parse(const std::string& filename) {
   std::vector<vtkSmartPointer<vtkDataSet>> polys;
-  std::ifstream file(filename);
-  if (!file.is_open()) {
+  ByteSource file;
+  if (!openInput(file, filename)) {
     return polys;
   }
-  std::string line;
-  std::vector<std::array<double, 3>> vertices, normals;
-  std::vector<std::array<int, 3>> triangles;
-  std::vector<int> vertexGroups;
-  bool inVerticesSection = false, inTrianglesSection = false;
-  while (std::getline(file, line)) {
-    line = trim(line);
-    if (line.empty() || line[0] == ';')
-      continue;
-    if (isSectionHeader(line)) {
-      inVerticesSection = (line == "[VerticesSection]");
-      inTrianglesSection = (line == "[TrianglesSection]");
-      continue;
-    }
-    if (inVerticesSection) {
-      double x, y, z, nx, ny, nz;
-      int groupId;
-      if (parseVertexLine(line, x, y, z, nx, ny, nz, groupId)) {
-        vertices.push_back({x, y, z});
-        normals.push_back({nx, ny, nz});
-        vertexGroups.push_back(groupId);
-      }
-    } else if (inTrianglesSection) {
-      int v0, v1, v2;
-      double nx, ny, nz;
-      int groupId;
-      if (parseTriangleLine(line, v0, v1, v2, nx, ny, nz, groupId)) {
-        triangles.push_back({v0, v1, v2});
+
+  // Locate the two sections this reader needs; everything else is skipped.
+  const char* verticesBegin = nullptr;
+  const char* verticesEnd = nullptr;
+  const char* trianglesBegin = nullptr;
+  const char* trianglesEnd = nullptr;
+  {
+    LineReader lines(file.begin(), file.end());
+    std::string_view line;
+    const char* lineStart = lines.position();
+    const char** openEnd = nullptr;
+    while (lines.next(line)) {
+      const std::string_view t = trim(line);
+      if (isSectionHeader(t)) {
+        if (openEnd)
+          *openEnd = lineStart;
+        openEnd = nullptr;
+        if (t == "[VerticesSection]") {
+          verticesBegin = lines.position();
+          openEnd = &verticesEnd;
+        } else if (t == "[TrianglesSection]") {
+          trianglesBegin = lines.position();
+          openEnd = &trianglesEnd;
+        }
       }
+      lineStart = lines.position();
     }
+    if (openEnd)
+      *openEnd = file.end();
   }
-  file.close();
-  if (vertices.empty() || triangles.empty())
+  if (!verticesBegin || !trianglesBegin)
+    return polys;
+
+  const SectionChunks vertexChunks = chunkSection(verticesBegin, verticesEnd);
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(static_cast<vtkIdType>(vertexChunks.rows));
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(static_cast<vtkIdType>(vertexChunks.rows));
+  vtkNew<vtkFloatArray> vertexGroups;
+  vertexGroups->SetName("GroupID");
+  vertexGroups->SetNumberOfValues(static_cast<vtkIdType>(vertexChunks.rows));
+  float* xyz = coords->GetPointer(0);
+  float* nxyz = normals->GetPointer(0);
+  float* vgroup = vertexGroups->GetPointer(0);
+  const size_t vertexCount = parseRows(
+      *this,
+      vertexChunks,
+      [&](size_t row, std::string_view line) {
+        return parseVertexLine(line, xyz + row * 3, nxyz + row * 3, vgroup[row]);
+      },
+      [&](size_t from, size_t to) {
+        std::copy_n(xyz + from * 3, 3, xyz + to * 3);
+        std::copy_n(nxyz + from * 3, 3, nxyz + to * 3);
+        vgroup[to] = vgroup[from];
+      });
+
+  const SectionChunks triangleChunks = chunkSection(trianglesBegin, trianglesEnd);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(triangleChunks.rows * 3));
+  vtkNew<vtkIntArray> triangleGroups;
+  triangleGroups->SetName("GroupID");
+  triangleGroups->SetNumberOfValues(static_cast<vtkIdType>(triangleChunks.rows));
+  vtkIdType* ids = connectivity->GetPointer(0);
+  int* tgroup = triangleGroups->GetPointer(0);
+  const size_t triangleCount = parseRows(
+      *this,
+      triangleChunks,
+      [&](size_t row, std::string_view line) {
+        return parseTriangleLine(line, ids + row * 3, tgroup[row]);
+      },
+      [&](size_t from, size_t to) {
+        std::copy_n(ids + from * 3, 3, ids + to * 3);
+        tgroup[to] = tgroup[from];
+      });
+
+  if (vertexCount == 0 || triangleCount == 0 || cancelled())
+    return polys;
+  coords->SetNumberOfTuples(static_cast<vtkIdType>(vertexCount));
+  normals->SetNumberOfTuples(static_cast<vtkIdType>(vertexCount));
+  vertexGroups->SetNumberOfValues(static_cast<vtkIdType>(vertexCount));
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(triangleCount * 3));
+  triangleGroups->SetNumberOfValues(static_cast<vtkIdType>(triangleCount));
+
+  ids = connectivity->GetPointer(0);
+  const auto pointCount = static_cast<vtkIdType>(vertexCount);
+  if (!std::all_of(ids, ids + triangleCount * 3, [pointCount](vtkIdType id) {
+        return id >= 0 && id < pointCount;
+      })) {
+    std::cerr << "Carto mesh has out-of-range triangle index in " << filename << '\n';
     return polys;
-  vtkNew<vtkPolyData> poly;
-  vtkNew<vtkPoints> points;
-  points->SetNumberOfPoints(static_cast<vtkIdType>(vertices.size()));
-  for (size_t i = 0; i < vertices.size(); ++i) {
-    points->SetPoint(static_cast<vtkIdType>(i), vertices[i][0], vertices[i][1], vertices[i][2]);
   }
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(triangleCount + 1));
+  vtkIdType* offset = offsets->GetPointer(0);
+  for (size_t i = 0; i <= triangleCount; ++i)
+    offset[i] = static_cast<vtkIdType>(i * 3);
+  vtkNew<vtkCellArray> triangles;
+  triangles->SetData(offsets, connectivity);
+
+  vtkNew<vtkPoints> points;
+  points->SetData(coords);
+  vtkNew<vtkPolyData> poly;
   poly->SetPoints(points);
-  vtkNew<vtkCellArray> trianglesArray;
-  for (const auto& tri : triangles) {
-    vtkIdType triangle[3] = {static_cast<vtkIdType>(tri[0]),
-                             static_cast<vtkIdType>(tri[1]),
-                             static_cast<vtkIdType>(tri[2])};
-    trianglesArray->InsertNextCell(3, triangle);
-  }
-  poly->SetPolys(trianglesArray);
-  if (!normals.empty() && normals.size() == vertices.size()) {
-    vtkNew<vtkFloatArray> normalArray;
-    normalArray->SetName("Normals");
-    normalArray->SetNumberOfComponents(3);
-    normalArray->SetNumberOfTuples(static_cast<vtkIdType>(normals.size()));
-    for (size_t i = 0; i < normals.size(); ++i) {
-      const float tuple[3] = {static_cast<float>(normals[i][0]),
-                              static_cast<float>(normals[i][1]),
-                              static_cast<float>(normals[i][2])};
-      normalArray->SetTypedTuple(static_cast<vtkIdType>(i), tuple);
-    }
-    poly->GetPointData()->SetNormals(normalArray);
-    poly->GetPointData()->AddArray(normalArray);
-  }
-  if (!vertexGroups.empty()) {
-    vtkNew<vtkFloatArray> groupArray;
-    groupArray->SetName("GroupID");
-    groupArray->SetNumberOfComponents(1);
-    groupArray->SetNumberOfTuples(static_cast<vtkIdType>(vertexGroups.size()));
-    for (size_t i = 0; i < vertexGroups.size(); ++i) {
-      groupArray->SetValue(static_cast<vtkIdType>(i), static_cast<float>(vertexGroups[i]));
-    }
-    poly->GetPointData()->AddArray(groupArray);
-  }
+  poly->SetPolys(triangles);
+  poly->GetPointData()->SetNormals(normals);
+  poly->GetPointData()->AddArray(normals);
+  poly->GetPointData()->AddArray(vertexGroups);
+  poly->GetCellData()->AddArray(triangleGroups);
   polys.push_back(poly);
   return polys;
 }
 
-bool CartoMeshParser::canParse(const std::string& filename) {
-  std::string header = readHeader(filename, 200);
-  return header.find("#TriangulatedMeshVersion2.0") != std::string::npos;
+bool CartoMeshParser::canParse(const FileHead& head) {
+  return head.prefix(200).find("#TriangulatedMeshVersion2.0") != std::string_view::npos;
 }
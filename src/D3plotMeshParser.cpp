@@ -0,0 +1,186 @@
+#include "D3plotMeshParser.h"
+
+#include "D3plotReader.h"
+#include "D3plotTemporalSource.h"
+#include "lsdyna_cells.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+namespace {
+
+bool startsWithIgnoreCase(const std::string& value, const std::string& prefix) {
+  if (value.size() < prefix.size()) {
+    return false;
+  }
+  return std::equal(prefix.begin(), prefix.end(), value.begin(), [](char a, char b) {
+    return std::tolower(static_cast<unsigned char>(a)) ==
+           std::tolower(static_cast<unsigned char>(b));
+  });
+}
+
+// Flattened cells of the whole model, in D3plotReader element order.
+struct CellBuffers {
+  std::vector<vtkIdType> connectivity;
+  std::vector<vtkIdType> offsets;
+  std::vector<unsigned char> types;
+  std::vector<int> materials;
+  std::vector<uint32_t> elements; // reader element index of each cell
+
+  void add(int type, const int* nodes, int count, int material, size_t element) {
+    offsets.push_back(static_cast<vtkIdType>(connectivity.size()));
+    connectivity.insert(connectivity.end(), nodes, nodes + count);
+    types.push_back(static_cast<unsigned char>(type));
+    materials.push_back(material);
+    elements.push_back(static_cast<uint32_t>(element));
+  }
+};
+
+bool validNodes(const int* nodes, int count, size_t nodeCount) {
+  return std::all_of(nodes, nodes + count, [nodeCount](int n) {
+    return n >= 0 && static_cast<size_t>(n) < nodeCount;
+  });
+}
+
+// Solids and thick shells store 8 nodes with repeats for degenerate shapes;
+// lsdynaSolidCell works on 1-based ids (0 = missing), d3plot indices are 0-based.
+void addSolidBlock(const D3plotReader::ElementBlock& block,
+                   size_t firstElement,
+                   size_t nodeCount,
+                   CellBuffers& cells) {
+  const auto stride = static_cast<size_t>(block.nodesPerElement);
+  for (size_t e = 0; e < block.size(); ++e) {
+    int ids[8];
+    for (size_t k = 0; k < 8; ++k) {
+      ids[k] = block.nodes[e * stride + k] + 1;
+    }
+    int out[8];
+    int count = 0;
+    const int type = lsdynaSolidCell(ids, out, count);
+    if (type == VTK_EMPTY_CELL) {
+      continue;
+    }
+    for (int k = 0; k < count; ++k) {
+      --out[k];
+    }
+    if (validNodes(out, count, nodeCount)) {
+      cells.add(type, out, count, block.materials[e], firstElement + e);
+    }
+  }
+}
+
+} // namespace
+
+D3plotMeshParser::D3plotMeshParser() = default;
+D3plotMeshParser::~D3plotMeshParser() = default;
+
+bool D3plotMeshParser::canParse(const FileHead& head) {
+  const std::string base = std::filesystem::path(head.path).filename().string();
+  if (!startsWithIgnoreCase(base, "d3plot")) {
+    return false;
+  }
+  return D3plotReader::looksLikeD3plot(std::string(head.prefix(512)));
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> D3plotMeshParser::parse(const std::string& filename) {
+  temporal_.reset();
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+
+  auto reader = std::make_shared<D3plotReader>();
+  if (!reader->open(filename)) {
+    return meshes;
+  }
+  const size_t nodeCount = reader->nodeCount();
+
+  CellBuffers cells;
+  cells.types.reserve(reader->elementCount());
+  cells.materials.reserve(reader->elementCount());
+  size_t firstElement = 0;
+  addSolidBlock(reader->solids(), firstElement, nodeCount, cells);
+  firstElement += reader->solids().size();
+  addSolidBlock(reader->thickShells(), firstElement, nodeCount, cells);
+  firstElement += reader->thickShells().size();
+
+  const D3plotReader::ElementBlock& beams = reader->beams();
+  for (size_t e = 0; e < beams.size(); ++e) {
+    const int* nodes = beams.nodes.data() + e * static_cast<size_t>(beams.nodesPerElement);
+    if (validNodes(nodes, 2, nodeCount)) {
+      cells.add(VTK_LINE, nodes, 2, beams.materials[e], firstElement + e);
+    }
+  }
+  firstElement += beams.size();
+
+  const D3plotReader::ElementBlock& shells = reader->shells();
+  for (size_t e = 0; e < shells.size(); ++e) {
+    const int* nodes = shells.nodes.data() + e * static_cast<size_t>(shells.nodesPerElement);
+    // Triangular shells repeat their third node.
+    const bool triangle = nodes[2] == nodes[3];
+    const int count = triangle ? 3 : 4;
+    if (validNodes(nodes, count, nodeCount)) {
+      cells.add(triangle ? VTK_TRIANGLE : VTK_QUAD,
+                nodes,
+                count,
+                shells.materials[e],
+                firstElement + e);
+    }
+  }
+
+  if (nodeCount == 0 || cells.types.empty()) {
+    std::cerr << "d3plot: no elements in " << filename << '\n';
+    return meshes;
+  }
+  cells.offsets.push_back(static_cast<vtkIdType>(cells.connectivity.size()));
+
+  const std::vector<float>& xyz = reader->initialCoordinates();
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(static_cast<vtkIdType>(nodeCount));
+  std::copy(xyz.begin(), xyz.end(), coords->GetPointer(0));
+  vtkNew<vtkPoints> pts;
+  pts->SetData(coords);
+
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(cells.connectivity.size()));
+  std::copy(cells.connectivity.begin(), cells.connectivity.end(), connectivity->GetPointer(0));
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(cells.offsets.size()));
+  std::copy(cells.offsets.begin(), cells.offsets.end(), offsets->GetPointer(0));
+  vtkNew<vtkCellArray> cellArray;
+  cellArray->SetData(offsets, connectivity);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(static_cast<vtkIdType>(cells.types.size()));
+  std::copy(cells.types.begin(), cells.types.end(), types->GetPointer(0));
+
+  auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(pts);
+  grid->SetCells(types, cellArray);
+
+  vtkNew<vtkIntArray> materials;
+  materials->SetName("Material");
+  materials->SetNumberOfValues(static_cast<vtkIdType>(cells.materials.size()));
+  std::copy(cells.materials.begin(), cells.materials.end(), materials->GetPointer(0));
+  grid->GetCellData()->AddArray(materials);
+
+  // State 0 supplies the initial result arrays; playback streams the others.
+  auto source = std::make_shared<D3plotTemporalSource>(reader, std::move(cells.elements));
+  if (reader->stateCount() > 0) {
+    source->readStepInto(0, grid);
+  }
+  meshes.push_back(grid);
+
+  if (reader->stateCount() > 1) {
+    temporal_ = std::move(source);
+  }
+  return meshes;
+}
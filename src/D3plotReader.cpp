@@ -0,0 +1,455 @@
+#include "D3plotReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace {
+
+// Word indices of the 64-word control section.
+constexpr size_t kNdim = 15;
+constexpr size_t kNumnp = 16;
+constexpr size_t kNglbv = 18;
+constexpr size_t kIt = 19;
+constexpr size_t kIu = 20;
+constexpr size_t kIv = 21;
+constexpr size_t kIa = 22;
+constexpr size_t kNel8 = 23;
+constexpr size_t kNv3d = 27;
+constexpr size_t kNel2 = 28;
+constexpr size_t kNv1d = 30;
+constexpr size_t kNel4 = 31;
+constexpr size_t kNv2d = 33;
+constexpr size_t kNeips = 35;
+constexpr size_t kMaxint = 36;
+constexpr size_t kNmsph = 37;
+constexpr size_t kNarbs = 39;
+constexpr size_t kNelt = 40;
+constexpr size_t kNv3dt = 42;
+constexpr size_t kIoshl1 = 43;
+constexpr size_t kIoshl2 = 44;
+constexpr size_t kIalemat = 47;
+constexpr size_t kNcfdv1 = 48;
+constexpr size_t kNadapt = 50;
+constexpr size_t kNpefg = 54;
+constexpr size_t kIdtdt = 56;
+constexpr size_t kExtra = 57;
+constexpr size_t kControlWords = 64;
+
+// Written after the geometry section and after the last state of each file.
+constexpr double kEndOfFileMarker = -999999.0;
+// NTYPE codes of the title sections that may follow the geometry: the
+// database title, and the part titles (NUMPROP records of an id and a title).
+constexpr int64_t kHeaderTitle = 90000;
+constexpr int64_t kPartTitles = 90001;
+constexpr size_t kTitleWords = 18;
+// IRBTYP value of rigid materials; rigid shells carry no element data.
+constexpr int64_t kRigidMaterialType = 20;
+
+int64_t headerInt(const std::string& header, size_t wordSize, size_t word) {
+  if (wordSize == 4) {
+    int32_t v = 0;
+    std::memcpy(&v, header.data() + word * 4, 4);
+    return v;
+  }
+  int64_t v = 0;
+  std::memcpy(&v, header.data() + word * 8, 8);
+  return v;
+}
+
+bool plausibleControl(const std::string& header, size_t wordSize) {
+  if (header.size() < kControlWords * wordSize) {
+    return false;
+  }
+  const int64_t ndim = headerInt(header, wordSize, kNdim);
+  const int64_t numnp = headerInt(header, wordSize, kNumnp);
+  const int64_t nglbv = headerInt(header, wordSize, kNglbv);
+  return ndim >= 2 && ndim <= 7 && numnp > 0 && numnp < (int64_t{1} << 40) && nglbv >= 0 &&
+         nglbv < (int64_t{1} << 30);
+}
+
+std::string familyFileName(const std::string& base, size_t index) {
+  return base + (index < 10 ? "0" : "") + std::to_string(index);
+}
+
+float vonMises(const float* s) {
+  const double sx = s[0], sy = s[1], sz = s[2], txy = s[3], tyz = s[4], tzx = s[5];
+  const double v = 0.5 * ((sx - sy) * (sx - sy) + (sy - sz) * (sy - sz) + (sz - sx) * (sz - sx)) +
+                   3.0 * (txy * txy + tyz * tyz + tzx * tzx);
+  return static_cast<float>(std::sqrt(std::max(0.0, v)));
+}
+
+} // namespace
+
+bool D3plotReader::looksLikeD3plot(const std::string& header) {
+  return plausibleControl(header, 4) || plausibleControl(header, 8);
+}
+
+int64_t D3plotReader::intWord(size_t file, size_t word) const {
+  const char* p = files_[file].data() + word * wordSize_;
+  if (wordSize_ == 4) {
+    int32_t v = 0;
+    std::memcpy(&v, p, 4);
+    return v;
+  }
+  int64_t v = 0;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+double D3plotReader::floatWord(size_t file, size_t word) const {
+  const char* p = files_[file].data() + word * wordSize_;
+  if (wordSize_ == 4) {
+    float v = 0.0f;
+    std::memcpy(&v, p, 4);
+    return static_cast<double>(v);
+  }
+  double v = 0.0;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+size_t D3plotReader::fileWords(size_t file) const {
+  return files_[file].size() / wordSize_;
+}
+
+void D3plotReader::copyFloats(size_t file, size_t word, size_t count, float* out) const {
+  const char* p = files_[file].data() + word * wordSize_;
+  if (wordSize_ == 4) {
+    std::memcpy(out, p, count * sizeof(float));
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    double v = 0.0;
+    std::memcpy(&v, p + i * 8, 8);
+    out[i] = static_cast<float>(v);
+  }
+}
+
+bool D3plotReader::open(const std::string& path) {
+  files_.clear();
+  states_.clear();
+
+  MappedFile first;
+  if (!first.open(path)) {
+    std::cerr << "d3plot: cannot open " << path << '\n';
+    return false;
+  }
+  const std::string header(first.data(), std::min<size_t>(first.size(), kControlWords * 8));
+  if (plausibleControl(header, 4)) {
+    wordSize_ = 4;
+  } else if (plausibleControl(header, 8)) {
+    wordSize_ = 8;
+  } else {
+    std::cerr << "d3plot: not a d3plot database: " << path << '\n';
+    return false;
+  }
+  files_.push_back(std::move(first));
+  for (size_t i = 1;; ++i) {
+    const std::string name = familyFileName(path, i);
+    std::error_code ec;
+    if (!std::filesystem::exists(name, ec)) {
+      break;
+    }
+    MappedFile family;
+    if (!family.open(name)) {
+      std::cerr << "d3plot: cannot open " << name << '\n';
+      break;
+    }
+    files_.push_back(std::move(family));
+  }
+
+  size_t geometryEnd = 0;
+  if (!readControl() || !readGeometry(geometryEnd)) {
+    std::cerr << "d3plot: unsupported or truncated database: " << path << '\n';
+    return false;
+  }
+
+  indexStates(firstStateWord(geometryEnd));
+  return true;
+}
+
+size_t D3plotReader::firstStateWord(size_t geometryEnd) const {
+  // The geometry and the optional title sections each may end with an EOF
+  // marker; states follow, in this file or from the next family file on. Only
+  // those words are looked at, so a large first file is not paged in here.
+  const size_t total = fileWords(0);
+  auto skipMarker = [&](size_t w) {
+    return w < total && floatWord(0, w) == kEndOfFileMarker ? w + 1 : w;
+  };
+  size_t w = skipMarker(geometryEnd);
+  if (w < total && intWord(0, w) == kHeaderTitle) {
+    w = std::min(total, w + 1 + kTitleWords);
+  }
+  if (w + 1 < total && intWord(0, w) == kPartTitles) {
+    const auto parts = static_cast<size_t>(std::max<int64_t>(0, intWord(0, w + 1)));
+    w = parts > (total - w - 2) / (1 + kTitleWords) ? total : w + 2 + parts * (1 + kTitleWords);
+  }
+  return skipMarker(w);
+}
+
+bool D3plotReader::readControl() {
+  const int64_t ndim = intWord(0, kNdim);
+  if (ndim < 4) {
+    return false; // packed connectivity
+  }
+  if (ndim == 7) {
+    return false; // rigid road surfaces
+  }
+  materialTypes_ = (ndim == 5);
+  if (intWord(0, kNmsph) > 0 || intWord(0, kNpefg) > 0 || intWord(0, kNadapt) > 0 ||
+      intWord(0, kNcfdv1) != 0) {
+    return false;
+  }
+
+  numNodes_ = static_cast<size_t>(intWord(0, kNumnp));
+  numGlobals_ = static_cast<size_t>(intWord(0, kNglbv));
+  tempFlag_ = static_cast<int>(intWord(0, kIt));
+  idtdt_ = static_cast<int>(intWord(0, kIdtdt));
+  hasCoords_ = intWord(0, kIu) != 0;
+  hasVelocity_ = intWord(0, kIv) != 0;
+  hasAcceleration_ = intWord(0, kIa) != 0;
+  // NEL8 < 0 flags ten-node solids, which carry two extra connectivity words.
+  numSolids_ = intWord(0, kNel8);
+  numThickShells_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNelt)));
+  numBeams_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNel2)));
+  numShells_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNel4)));
+  nv3d_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNv3d)));
+  nv3dt_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNv3dt)));
+  nv1d_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNv1d)));
+  nv2d_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNv2d)));
+  neips_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNeips)));
+  numArbs_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kNarbs)));
+  extraWords_ = static_cast<size_t>(std::max<int64_t>(0, intWord(0, kExtra)));
+  ioshlStress_ = intWord(0, kIoshl1) == 1000;
+  ioshlPlastic_ = intWord(0, kIoshl2) == 1000;
+
+  // MAXINT also encodes which deletion flags each state carries.
+  const int64_t maxint = intWord(0, kMaxint);
+  if (maxint >= 0) {
+    deletionMode_ = 0;
+    maxInt_ = static_cast<size_t>(maxint);
+  } else if (maxint > -10000) {
+    deletionMode_ = 1;
+    maxInt_ = static_cast<size_t>(-maxint);
+  } else {
+    deletionMode_ = 2;
+    maxInt_ = static_cast<size_t>(-maxint - 10000);
+  }
+  return true;
+}
+
+bool D3plotReader::readGeometry(size_t& endWord) {
+  const size_t total = fileWords(0);
+  size_t w = kControlWords + extraWords_;
+
+  std::vector<int64_t> materialType;
+  if (materialTypes_) {
+    if (w + 2 > total) {
+      return false;
+    }
+    const auto numMaterials = static_cast<size_t>(std::max<int64_t>(0, intWord(0, w + 1)));
+    if (w + 2 + numMaterials > total) {
+      return false;
+    }
+    for (size_t i = 0; i < numMaterials; ++i) {
+      materialType.push_back(intWord(0, w + 2 + i));
+    }
+    w += 2 + numMaterials;
+  }
+  w += static_cast<size_t>(std::max<int64_t>(0, intWord(0, kIalemat)));
+
+  const size_t solidCount = static_cast<size_t>(numSolids_ < 0 ? -numSolids_ : numSolids_);
+  const size_t needed = 3 * numNodes_ + 9 * solidCount + (numSolids_ < 0 ? 2 * solidCount : 0) +
+                        9 * numThickShells_ + 6 * numBeams_ + 5 * numShells_ + numArbs_;
+  if (w + needed > total) {
+    return false;
+  }
+
+  coordinates_.resize(3 * numNodes_);
+  copyFloats(0, w, 3 * numNodes_, coordinates_.data());
+  w += 3 * numNodes_;
+
+  // Connectivity records: node numbers (1-based), unused words, material last.
+  auto readBlock = [&](ElementBlock& block, size_t count, size_t recordWords, int nodes) {
+    block.nodesPerElement = nodes;
+    block.nodes.resize(count * static_cast<size_t>(nodes));
+    block.materials.resize(count);
+    for (size_t e = 0; e < count; ++e) {
+      const size_t record = w + e * recordWords;
+      for (size_t k = 0; k < static_cast<size_t>(nodes); ++k) {
+        block.nodes[e * static_cast<size_t>(nodes) + k] =
+            static_cast<int>(intWord(0, record + k) - 1);
+      }
+      block.materials[e] = static_cast<int>(intWord(0, record + recordWords - 1));
+    }
+    w += count * recordWords;
+  };
+  readBlock(solids_, solidCount, 9, 8);
+  if (numSolids_ < 0) {
+    w += 2 * solidCount;
+  }
+  readBlock(thickShells_, numThickShells_, 9, 8);
+  readBlock(beams_, numBeams_, 6, 2);
+  readBlock(shells_, numShells_, 5, 4);
+  w += numArbs_;
+
+  rigidShell_.assign(numShells_, false);
+  numRigidShells_ = 0;
+  for (size_t e = 0; e < numShells_; ++e) {
+    const auto mat = static_cast<size_t>(std::max(1, shells_.materials[e]));
+    if (mat <= materialType.size() && materialType[mat - 1] == kRigidMaterialType) {
+      rigidShell_[e] = true;
+      ++numRigidShells_;
+    }
+  }
+
+  // State record layout.
+  size_t o = 1 + numGlobals_;
+  nodalOffset_ = o;
+  static const size_t kTemperatureWords[4] = {0, 1, 4, 3};
+  o += numNodes_ * kTemperatureWords[std::clamp(tempFlag_ % 10, 0, 3)];
+  o += (tempFlag_ / 10 == 1) ? numNodes_ : 0;      // mass scaling
+  o += (idtdt_ % 10 == 1) ? numNodes_ : 0;         // dT/dt
+  o += ((idtdt_ / 10) % 10 == 1) ? 6 * numNodes_ : 0; // residual forces and moments
+  coordsOffset_ = o;
+  o += hasCoords_ ? 3 * numNodes_ : 0;
+  velocityOffset_ = o;
+  o += hasVelocity_ ? 3 * numNodes_ : 0;
+  accelerationOffset_ = o;
+  o += hasAcceleration_ ? 3 * numNodes_ : 0;
+  elementOffset_ = o;
+  o += solidCount * nv3d_ + numThickShells_ * nv3dt_ + numBeams_ * nv1d_ +
+       (numShells_ - numRigidShells_) * nv2d_;
+  if (deletionMode_ == 1) {
+    o += numNodes_;
+  } else if (deletionMode_ == 2) {
+    o += solidCount + numThickShells_ + numShells_ + numBeams_;
+  }
+  stateWords_ = o;
+
+  endWord = w;
+  return true;
+}
+
+void D3plotReader::indexStates(size_t firstStateWord) {
+  for (size_t file = 0; file < files_.size(); ++file) {
+    size_t w = (file == 0) ? firstStateWord : 0;
+    const size_t words = fileWords(file);
+    while (w + stateWords_ <= words) {
+      const double time = floatWord(file, w);
+      if (time == kEndOfFileMarker || !std::isfinite(time)) {
+        break;
+      }
+      // Padding at the end of a family file reads as a state going back in time.
+      if (!states_.empty() && time < states_.back().time) {
+        break;
+      }
+      states_.push_back({file, w, time});
+      w += stateWords_;
+    }
+  }
+}
+
+bool D3plotReader::hasNodalField(NodalField field) const {
+  switch (field) {
+  case NodalField::Coordinates:
+    return hasCoords_;
+  case NodalField::Velocity:
+    return hasVelocity_;
+  case NodalField::Acceleration:
+    return hasAcceleration_;
+  case NodalField::Temperature:
+    return tempFlag_ % 10 == 1;
+  }
+  return false;
+}
+
+bool D3plotReader::readNodalField(size_t state, NodalField field, float* out) const {
+  if (state >= states_.size() || !hasNodalField(field)) {
+    return false;
+  }
+  const StateLocation& at = states_[state];
+  switch (field) {
+  case NodalField::Coordinates:
+    copyFloats(at.file, at.word + coordsOffset_, 3 * numNodes_, out);
+    break;
+  case NodalField::Velocity:
+    copyFloats(at.file, at.word + velocityOffset_, 3 * numNodes_, out);
+    break;
+  case NodalField::Acceleration:
+    copyFloats(at.file, at.word + accelerationOffset_, 3 * numNodes_, out);
+    break;
+  case NodalField::Temperature:
+    copyFloats(at.file, at.word + nodalOffset_, numNodes_, out);
+    break;
+  }
+  return true;
+}
+
+bool D3plotReader::readElementStress(size_t state, float* vonMisesOut, float* plasticOut) const {
+  if (state >= states_.size()) {
+    return false;
+  }
+  const StateLocation& at = states_[state];
+  size_t w = at.word + elementOffset_;
+  size_t element = 0;
+  std::vector<float> record;
+
+  // Solids: six stress components, then effective plastic strain.
+  record.resize(nv3d_);
+  for (size_t e = 0; e < solids_.size(); ++e, ++element, w += nv3d_) {
+    vonMisesOut[element] = 0.0f;
+    plasticOut[element] = 0.0f;
+    if (nv3d_ >= 7) {
+      copyFloats(at.file, w, 7, record.data());
+      vonMisesOut[element] = vonMises(record.data());
+      plasticOut[element] = record[6];
+    }
+  }
+
+  // Thick shells and shells: per integration point the stresses (IOSHL(1))
+  // and the plastic strain (IOSHL(2)), followed by element-level values.
+  const size_t perPoint = (ioshlStress_ ? size_t{6} : 0) + (ioshlPlastic_ ? size_t{1} : 0) + neips_;
+  auto layered = [&](size_t recordWords, float& vm, float& eps) {
+    vm = 0.0f;
+    eps = 0.0f;
+    if (perPoint == 0 || maxInt_ * perPoint > recordWords) {
+      return;
+    }
+    record.resize(recordWords);
+    copyFloats(at.file, w, recordWords, record.data());
+    for (size_t ip = 0; ip < maxInt_; ++ip) {
+      const float* p = record.data() + ip * perPoint;
+      if (ioshlStress_) {
+        vm = std::max(vm, vonMises(p));
+      }
+      if (ioshlPlastic_) {
+        eps = std::max(eps, p[ioshlStress_ ? 6 : 0]);
+      }
+    }
+  };
+  for (size_t e = 0; e < thickShells_.size(); ++e, ++element, w += nv3dt_) {
+    layered(nv3dt_, vonMisesOut[element], plasticOut[element]);
+  }
+
+  for (size_t e = 0; e < beams_.size(); ++e, ++element) {
+    vonMisesOut[element] = 0.0f;
+    plasticOut[element] = 0.0f;
+  }
+  w += beams_.size() * nv1d_;
+
+  for (size_t e = 0; e < shells_.size(); ++e, ++element) {
+    if (rigidShell_[e]) {
+      vonMisesOut[element] = 0.0f;
+      plasticOut[element] = 0.0f;
+      continue;
+    }
+    layered(nv2d_, vonMisesOut[element], plasticOut[element]);
+    w += nv2d_;
+  }
+  return true;
+}
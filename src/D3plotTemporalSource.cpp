@@ -0,0 +1,261 @@
+#include "D3plotTemporalSource.h"
+
+#include "D3plotReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+
+namespace {
+
+const char* const kDisplacement = "Displacement";
+const char* const kVelocity = "Velocity";
+const char* const kAcceleration = "Acceleration";
+const char* const kTemperature = "Temperature";
+const char* const kVonMises = "Von Mises stress";
+const char* const kPlasticStrain = "Plastic strain";
+
+vtkSmartPointer<vtkFloatArray> newArray(const char* name, size_t tuples) {
+  auto arr = vtkSmartPointer<vtkFloatArray>::New();
+  arr->SetName(name);
+  arr->SetNumberOfComponents(1);
+  arr->SetNumberOfTuples(static_cast<vtkIdType>(tuples));
+  return arr;
+}
+
+// |v| per node of an x y z per node buffer.
+void magnitudes(const float* xyz, size_t count, float* out) {
+  for (size_t i = 0; i < count; ++i) {
+    const float* v = xyz + 3 * i;
+    out[i] = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  }
+}
+
+} // namespace
+
+D3plotTemporalSource::D3plotTemporalSource(std::shared_ptr<const D3plotReader> reader,
+                                           std::vector<uint32_t> cellElements)
+    : reader_(std::move(reader)), cellElements_(std::move(cellElements)) {}
+
+D3plotTemporalSource::~D3plotTemporalSource() = default;
+
+int D3plotTemporalSource::steps() const {
+  return static_cast<int>(reader_->stateCount());
+}
+
+double D3plotTemporalSource::timeAt(int step) const {
+  if (step < 0 || step >= steps()) {
+    return 0.0;
+  }
+  return reader_->stateTime(static_cast<size_t>(step));
+}
+
+void D3plotTemporalSource::setActiveArray(const ScalarField& field) {
+  activeArray_ = field;
+}
+
+std::unique_ptr<TemporalSource> D3plotTemporalSource::clone() const {
+  auto copy = std::make_unique<D3plotTemporalSource>(reader_, cellElements_);
+  copy->activeArray_ = activeArray_;
+  return copy;
+}
+
+std::vector<std::string> D3plotTemporalSource::pointArrayNames() const {
+  using Field = D3plotReader::NodalField;
+  std::vector<std::string> names;
+  if (reader_->hasNodalField(Field::Coordinates)) {
+    names.emplace_back(kDisplacement);
+  }
+  if (reader_->hasNodalField(Field::Velocity)) {
+    names.emplace_back(kVelocity);
+  }
+  if (reader_->hasNodalField(Field::Acceleration)) {
+    names.emplace_back(kAcceleration);
+  }
+  if (reader_->hasNodalField(Field::Temperature)) {
+    names.emplace_back(kTemperature);
+  }
+  return names;
+}
+
+vtkSmartPointer<vtkFloatArray> D3plotTemporalSource::pointArray(
+    size_t state, const std::string& name, const std::vector<float>& coords) const {
+  using Field = D3plotReader::NodalField;
+  const size_t n = reader_->nodeCount();
+  if (name == kDisplacement) {
+    if (coords.size() != 3 * n) {
+      return nullptr;
+    }
+    const std::vector<float>& initial = reader_->initialCoordinates();
+    std::vector<float> delta(3 * n);
+    for (size_t i = 0; i < 3 * n; ++i) {
+      delta[i] = coords[i] - initial[i];
+    }
+    auto arr = newArray(kDisplacement, n);
+    magnitudes(delta.data(), n, arr->GetPointer(0));
+    return arr;
+  }
+  if (name == kVelocity || name == kAcceleration) {
+    std::vector<float> xyz(3 * n);
+    if (!reader_->readNodalField(
+            state, name == kVelocity ? Field::Velocity : Field::Acceleration, xyz.data())) {
+      return nullptr;
+    }
+    auto arr = newArray(name == kVelocity ? kVelocity : kAcceleration, n);
+    magnitudes(xyz.data(), n, arr->GetPointer(0));
+    return arr;
+  }
+  if (name == kTemperature) {
+    auto arr = newArray(kTemperature, n);
+    if (!reader_->readNodalField(state, Field::Temperature, arr->GetPointer(0))) {
+      return nullptr;
+    }
+    return arr;
+  }
+  return nullptr;
+}
+
+void D3plotTemporalSource::cellArrays(size_t state,
+                                      vtkSmartPointer<vtkFloatArray>& vonMises,
+                                      vtkSmartPointer<vtkFloatArray>& plasticStrain) const {
+  const size_t elements = reader_->elementCount();
+  std::vector<float> vm(elements);
+  std::vector<float> eps(elements);
+  if (!reader_->readElementStress(state, vm.data(), eps.data())) {
+    return;
+  }
+  vonMises = newArray(kVonMises, cellElements_.size());
+  plasticStrain = newArray(kPlasticStrain, cellElements_.size());
+  float* vmOut = vonMises->GetPointer(0);
+  float* epsOut = plasticStrain->GetPointer(0);
+  for (size_t c = 0; c < cellElements_.size(); ++c) {
+    vmOut[c] = vm[cellElements_[c]];
+    epsOut[c] = eps[cellElements_[c]];
+  }
+}
+
+bool D3plotTemporalSource::readStepInto(int step, vtkDataSet* target) {
+  auto* grid = vtkPointSet::SafeDownCast(target);
+  if (!grid || step < 0 || step >= steps()) {
+    return false;
+  }
+  const auto state = static_cast<size_t>(step);
+
+  std::vector<float> coords;
+  if (reader_->hasNodalField(D3plotReader::NodalField::Coordinates)) {
+    const size_t n = reader_->nodeCount();
+    auto xyz = vtkSmartPointer<vtkFloatArray>::New();
+    xyz->SetNumberOfComponents(3);
+    xyz->SetNumberOfTuples(static_cast<vtkIdType>(n));
+    coords.resize(3 * n);
+    reader_->readNodalField(state, D3plotReader::NodalField::Coordinates, coords.data());
+    std::copy(coords.begin(), coords.end(), xyz->GetPointer(0));
+    vtkNew<vtkPoints> pts;
+    pts->SetData(xyz);
+    grid->SetPoints(pts);
+  }
+
+  // Arrays other than the active one are dropped rather than left over from an
+  // earlier frame, out of sync.
+  const bool all = activeArray_.name.empty();
+  const auto wanted = [&](const char* name, FieldAssociation association) {
+    return all || (activeArray_.association == association && activeArray_.name == name);
+  };
+
+  vtkPointData* pd = grid->GetPointData();
+  for (const std::string& name : pointArrayNames()) {
+    if (!wanted(name.c_str(), FieldAssociation::Point)) {
+      pd->RemoveArray(name.c_str());
+      continue;
+    }
+    if (auto arr = pointArray(state, name, coords)) {
+      pd->AddArray(arr);
+    }
+  }
+
+  vtkCellData* cd = grid->GetCellData();
+  vtkSmartPointer<vtkFloatArray> vonMises;
+  vtkSmartPointer<vtkFloatArray> plasticStrain;
+  if (wanted(kVonMises, FieldAssociation::Cell) || wanted(kPlasticStrain, FieldAssociation::Cell)) {
+    cellArrays(state, vonMises, plasticStrain);
+  }
+  const std::pair<const char*, vtkFloatArray*> cellFields[] = {{kVonMises, vonMises},
+                                                               {kPlasticStrain, plasticStrain}};
+  for (const auto& [name, arr] : cellFields) {
+    if (arr && wanted(name, FieldAssociation::Cell)) {
+      cd->AddArray(arr);
+    } else if (!all) {
+      cd->RemoveArray(name);
+    }
+  }
+  grid->Modified();
+  return true;
+}
+
+bool D3plotTemporalSource::sampledScalarRange(const ScalarField& field,
+                                              double out[2],
+                                              int maxSamples) {
+  const std::string& scalarName = field.name;
+  const int numSteps = steps();
+  if (numSteps <= 0 || scalarName.empty()) {
+    return false;
+  }
+  const bool isCellArray = field.association == FieldAssociation::Cell;
+  if (isCellArray && scalarName != kVonMises && scalarName != kPlasticStrain) {
+    return false;
+  }
+  const int sampleCount = std::min(numSteps, std::max(1, maxSamples));
+  double lo = 0.0;
+  double hi = 0.0;
+  bool any = false;
+  for (int s = 0; s < sampleCount; ++s) {
+    // Evenly spaced steps including first and last.
+    const int step =
+        sampleCount == 1
+            ? 0
+            : static_cast<int>((static_cast<long long>(s) * (numSteps - 1)) / (sampleCount - 1));
+    const auto state = static_cast<size_t>(step);
+    vtkSmartPointer<vtkFloatArray> arr;
+    if (isCellArray) {
+      vtkSmartPointer<vtkFloatArray> vonMises;
+      vtkSmartPointer<vtkFloatArray> plasticStrain;
+      cellArrays(state, vonMises, plasticStrain);
+      arr = (scalarName == kVonMises) ? vonMises : plasticStrain;
+    } else {
+      std::vector<float> coords;
+      if (scalarName == kDisplacement) {
+        coords.resize(3 * reader_->nodeCount());
+        if (!reader_->readNodalField(
+                state, D3plotReader::NodalField::Coordinates, coords.data())) {
+          continue;
+        }
+      }
+      arr = pointArray(state, scalarName, coords);
+    }
+    if (!arr || arr->GetNumberOfTuples() == 0) {
+      continue;
+    }
+    double range[2];
+    arr->GetRange(range);
+    if (!any) {
+      lo = range[0];
+      hi = range[1];
+      any = true;
+    } else {
+      lo = std::min(lo, range[0]);
+      hi = std::max(hi, range[1]);
+    }
+  }
+  if (!any) {
+    return false;
+  }
+  out[0] = lo;
+  out[1] = hi;
+  return true;
+}
@@ -1,32 +1,67 @@
 #include "FSurfMeshParser.h"
 
+#include "ByteSource.h"
+#include "FSurfOverlays.h"
+#include "byte_order.h"
+#include "parallel_utils.h"
+
+#include <algorithm>
 #include <cstdint>
-#include <cstring>
-#include <fstream>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
-#if defined(_MSC_VER)
-#include <intrin.h>
-#endif
 #include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
+#include <vtkTypeInt32Array.h>
 
 namespace {
-uint32_t bswap32(uint32_t value) {
-#if defined(_MSC_VER)
-  return _byteswap_ulong(value);
-#elif defined(__clang__) || defined(__GNUC__)
-  return __builtin_bswap32(value);
-#else
-  return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
-         ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
-#endif
+
+// Triangle cells straight from the big-endian face block: the indices are
+// swapped into the connectivity array in one pass and the offsets are 0, 3, 6...
+// Returns null if an index is out of range.
+template <typename ArrayT>
+vtkSmartPointer<vtkCellArray> readTriangles(const char* faces, uint32_t nt, uint32_t nv) {
+  using Value = typename ArrayT::ValueType;
+  const size_t indexCount = static_cast<size_t>(nt) * 3u;
+
+  vtkNew<ArrayT> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(indexCount));
+  Value* ids = connectivity->GetPointer(0);
+  if constexpr (sizeof(Value) == sizeof(uint32_t)) {
+    byteSwap32Block(faces, ids, indexCount);
+  } else {
+    std::vector<uint32_t> swapped(indexCount);
+    byteSwap32Block(faces, swapped.data(), indexCount);
+    std::copy(swapped.begin(), swapped.end(), ids);
+  }
+  // Negative 32-bit values wrap to large unsigned ones, so one compare covers both ends.
+  if (!std::all_of(ids, ids + indexCount, [nv](Value id) {
+        return static_cast<uint32_t>(id) < nv;
+      })) {
+    return nullptr;
+  }
+
+  vtkNew<ArrayT> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(nt) + 1);
+  Value* offset = offsets->GetPointer(0);
+  for (size_t i = 0; i <= nt; ++i) {
+    offset[i] = static_cast<Value>(i * 3u);
+  }
+
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return cells;
 }
+
 } // namespace
 
-bool FSurfMeshParser::canParse(const std::string& filename) {
+bool FSurfMeshParser::canParse(const FileHead& head) {
+  const std::string& filename = head.path;
   auto ends_with = [](const std::string& s, const std::string& sfx) {
     return s.size() >= sfx.size() && s.compare(s.size() - sfx.size(), sfx.size(), sfx) == 0;
   };
@@ -36,80 +71,81 @@ bool FSurfMeshParser::canParse(const std::string& filename) {
 
 std::vector<vtkSmartPointer<vtkDataSet>> FSurfMeshParser::parse(const std::string& filename) {
   std::vector<vtkSmartPointer<vtkDataSet>> polys;
-  std::ifstream f(filename, std::ios::binary);
-  if (!f) {
+  ByteSource file;
+  if (!openInput(file, filename)) {
     std::cerr << "Could not open FreeSurfer surface file: " << filename << '\n';
     return polys;
   }
+  const char* data = file.data();
+  const size_t size = file.size();
+
   // Magic number: 3 bytes
-  uint8_t magic[3];
-  if (!f.read(reinterpret_cast<char*>(magic), 3) ||
-      !(magic[0] == 255 && magic[1] == 255 && magic[2] == 254)) {
+  if (size < 3 || static_cast<uint8_t>(data[0]) != 255 || static_cast<uint8_t>(data[1]) != 255 ||
+      static_cast<uint8_t>(data[2]) != 254) {
     std::cerr << "Not a FreeSurfer surface file (bad magic)" << '\n';
     return polys;
   }
-  std::string headerline;
-  std::getline(f, headerline); // header line (may include 'created by...')
-  std::getline(f, headerline); // second header line (blank)
-  // Counts. Cross-check against the remaining file size so a corrupt header
-  // cannot trigger a huge allocation or reads of garbage data.
-  uint32_t nv, nt;
-  if (!f.read(reinterpret_cast<char*>(&nv), 4) || !f.read(reinterpret_cast<char*>(&nt), 4)) {
+  // Two header lines ("created by ..." and a blank one), then the counts.
+  size_t pos = 3;
+  for (int line = 0; line < 2 && pos < size; ++line) {
+    const char* newline = std::find(data + pos, data + size, '\n');
+    pos = static_cast<size_t>(newline - data) + (newline == data + size ? 0u : 1u);
+  }
+  // Cross-check the counts against the remaining file size so a corrupt header
+  // cannot trigger a huge allocation or reads past the mapping.
+  if (size - pos < 8) {
     std::cerr << "Truncated FreeSurfer surface file: " << filename << '\n';
     return polys;
   }
-  nv = bswap32(nv);
-  nt = bswap32(nt);
-  const std::streamoff dataStart = f.tellg();
-  f.seekg(0, std::ios::end);
-  const std::streamoff fileEnd = f.tellg();
-  f.seekg(dataStart, std::ios::beg);
-  const uint64_t available = (fileEnd > dataStart) ? static_cast<uint64_t>(fileEnd - dataStart) : 0;
+  const uint32_t nv = loadBigEndian32(data + pos);
+  const uint32_t nt = loadBigEndian32(data + pos + 4);
+  pos += 8;
+  const uint64_t available = size - pos;
   const uint64_t needed = (static_cast<uint64_t>(nv) + static_cast<uint64_t>(nt)) * 12u;
   if (nv == 0 || nt == 0 || needed > available) {
     std::cerr << "Invalid FreeSurfer surface counts in " << filename << " (vertices=" << nv
               << ", triangles=" << nt << ")" << '\n';
     return polys;
   }
+
+  // Geometry and every overlay are independent reads; run them side by side so
+  // a subject with many overlays costs about as much as the surface alone.
+  const std::vector<FSurfOverlay> overlays = findFSurfOverlays(filename);
+  std::vector<vtkSmartPointer<vtkDataArray>> overlayArrays(overlays.size());
   vtkNew<vtkPoints> pts;
-  pts->SetNumberOfPoints(nv);
-  for (uint32_t i = 0; i < nv; ++i) {
-    float xyz[3];
-    if (!f.read(reinterpret_cast<char*>(xyz), 12)) {
-      std::cerr << "Truncated FreeSurfer surface file: " << filename << '\n';
-      return polys;
-    }
-    for (int j = 0; j < 3; ++j) {
-      uint32_t tmp;
-      memcpy(&tmp, xyz + j, 4);
-      tmp = bswap32(tmp);
-      memcpy(xyz + j, &tmp, 4);
-    }
-    pts->SetPoint(
-        i, static_cast<double>(xyz[0]), static_cast<double>(xyz[1]), static_cast<double>(xyz[2]));
-  }
-  vtkNew<vtkCellArray> tris;
-  for (uint32_t i = 0; i < nt; ++i) {
-    uint32_t tidx[3];
-    if (!f.read(reinterpret_cast<char*>(tidx), 12)) {
-      std::cerr << "Truncated FreeSurfer surface file: " << filename << '\n';
-      return polys;
-    }
-    for (int j = 0; j < 3; ++j) {
-      tidx[j] = bswap32(tidx[j]);
-    }
-    if (tidx[0] >= nv || tidx[1] >= nv || tidx[2] >= nv) {
-      std::cerr << "FreeSurfer surface has out-of-range triangle index in " << filename << '\n';
-      return polys;
+  vtkSmartPointer<vtkCellArray> tris;
+  parallelFor(overlays.size() + 1, [&](size_t task) {
+    if (task > 0) {
+      overlayArrays[task - 1] = readFSurfOverlay(overlays[task - 1], nv);
+      return;
     }
-    vtkIdType triangle[3] = {static_cast<vtkIdType>(tidx[0]),
-                             static_cast<vtkIdType>(tidx[1]),
-                             static_cast<vtkIdType>(tidx[2])};
-    tris->InsertNextCell(3, triangle);
+    // Coordinates stay float32, swapped straight into the point array.
+    vtkNew<vtkFloatArray> coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(static_cast<vtkIdType>(nv));
+    byteSwap32Block(data + pos, coords->GetPointer(0), static_cast<size_t>(nv) * 3u);
+    pts->SetData(coords);
+
+    // 32-bit cell storage whenever the offsets fit, which is every real surface.
+    const char* faces = data + pos + static_cast<size_t>(nv) * 12u;
+    const bool fits32 = static_cast<uint64_t>(nt) * 3u <=
+                        static_cast<uint64_t>(std::numeric_limits<vtkTypeInt32>::max());
+    tris = fits32 ? readTriangles<vtkTypeInt32Array>(faces, nt, nv)
+                  : readTriangles<vtkIdTypeArray>(faces, nt, nv);
+  });
+  if (!tris) {
+    std::cerr << "FreeSurfer surface has out-of-range triangle index in " << filename << '\n';
+    return polys;
   }
+
   vtkNew<vtkPolyData> poly;
   poly->SetPoints(pts);
   poly->SetPolys(tris);
+  for (const auto& array : overlayArrays) {
+    if (array) {
+      poly->GetPointData()->AddArray(array);
+    }
+  }
   polys.push_back(poly);
   return polys;
 }
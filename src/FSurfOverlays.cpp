@@ -0,0 +1,330 @@
+#include "FSurfOverlays.h"
+
+#include "MappedFile.h"
+#include "byte_order.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <system_error>
+#include <unordered_map>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkLookupTable.h>
+#include <vtkVariant.h>
+
+namespace {
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Sequential reader over a mapped big-endian file; every read is bounds-checked
+// and a short read leaves ok() false.
+class BigEndianCursor {
+public:
+  BigEndianCursor(const char* data, size_t size) : data_(data), size_(size) {
+  }
+
+  bool ok() const {
+    return ok_;
+  }
+  size_t remaining() const {
+    return size_ - pos_;
+  }
+  const char* here() const {
+    return data_ + pos_;
+  }
+
+  int32_t int32() {
+    if (!take(4)) {
+      return 0;
+    }
+    return static_cast<int32_t>(loadBigEndian32(data_ + pos_ - 4));
+  }
+
+  uint32_t uint24() {
+    if (!take(3)) {
+      return 0;
+    }
+    const auto* p = reinterpret_cast<const unsigned char*>(data_ + pos_ - 3);
+    return (uint32_t{p[0]} << 16) | (uint32_t{p[1]} << 8) | uint32_t{p[2]};
+  }
+
+  // A length-prefixed, NUL-padded string as written by FreeSurfer.
+  std::string string() {
+    const int32_t length = int32();
+    if (length < 0 || !take(static_cast<size_t>(length))) {
+      ok_ = false;
+      return {};
+    }
+    const char* begin = data_ + pos_ - static_cast<size_t>(length);
+    return std::string(begin, std::find(begin, data_ + pos_, '\0'));
+  }
+
+  bool take(size_t bytes) {
+    if (!ok_ || bytes > remaining()) {
+      ok_ = false;
+      return false;
+    }
+    pos_ += bytes;
+    return true;
+  }
+
+private:
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+// curv / thickness / sulc. The current format (magic 0xFFFFFF) stores float32
+// values; the old one stores int16 hundredths after 3-byte counts.
+vtkSmartPointer<vtkDataArray> readMorph(const FSurfOverlay& overlay,
+                                        const MappedFile& file,
+                                        size_t vertexCount) {
+  BigEndianCursor in(file.data(), file.size());
+  const uint32_t magic = in.uint24();
+  auto values = vtkSmartPointer<vtkFloatArray>::New();
+  values->SetName(overlay.name.c_str());
+  values->SetNumberOfValues(static_cast<vtkIdType>(vertexCount));
+
+  if (magic == 0xFFFFFFu) {
+    const int32_t count = in.int32();
+    in.int32(); // faces
+    const int32_t perVertex = in.int32();
+    if (!in.ok() || count < 0 || static_cast<size_t>(count) != vertexCount || perVertex != 1 ||
+        in.remaining() < vertexCount * 4u) {
+      std::cerr << "FreeSurfer overlay " << overlay.path << " does not match the surface ("
+                << count << " values for " << vertexCount << " vertices)" << '\n';
+      return nullptr;
+    }
+    byteSwap32Block(in.here(), values->GetPointer(0), vertexCount);
+    return values;
+  }
+
+  const uint32_t count = magic;
+  in.uint24(); // faces
+  if (!in.ok() || count != vertexCount || in.remaining() < vertexCount * 2u) {
+    std::cerr << "FreeSurfer overlay " << overlay.path << " does not match the surface ("
+              << count << " values for " << vertexCount << " vertices)" << '\n';
+    return nullptr;
+  }
+  const auto* p = reinterpret_cast<const unsigned char*>(in.here());
+  float* out = values->GetPointer(0);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    const auto raw = static_cast<int16_t>((p[2 * i] << 8) | p[2 * i + 1]);
+    out[i] = static_cast<float>(raw) / 100.0f;
+  }
+  return values;
+}
+
+struct ColorTable {
+  vtkSmartPointer<vtkLookupTable> lut;
+  std::unordered_map<int32_t, int> structureOfLabel; // r + g<<8 + b<<16 -> structure
+};
+
+// An indexed lookup table colors annotated value k with table entry k, so
+// entries are stored in read order and annotated with their structure index.
+bool addColorTableEntry(ColorTable& table, BigEndianCursor& in, int structure) {
+  const std::string name = in.string();
+  const int32_t r = in.int32();
+  const int32_t g = in.int32();
+  const int32_t b = in.int32();
+  in.int32(); // transparency
+  const vtkIdType entry = table.lut->GetNumberOfAnnotatedValues();
+  if (!in.ok() || structure < 0 || entry >= table.lut->GetNumberOfTableValues()) {
+    return false;
+  }
+  table.lut->SetTableValue(entry, r / 255.0, g / 255.0, b / 255.0, 1.0);
+  table.lut->SetAnnotation(vtkVariant(structure), name);
+  table.structureOfLabel[r + (g << 8) + (b << 16)] = structure;
+  return true;
+}
+
+bool readColorTable(BigEndianCursor& in, ColorTable& table) {
+  table.lut = vtkSmartPointer<vtkLookupTable>::New();
+  table.lut->IndexedLookupOn();
+  const int32_t entries = in.int32();
+  if (!in.ok()) {
+    return false;
+  }
+  if (entries > 0) {
+    // Original format: the entries in structure order.
+    in.string(); // source colortable file
+    table.lut->SetNumberOfTableValues(entries);
+    for (int32_t i = 0; i < entries; ++i) {
+      if (!addColorTableEntry(table, in, i)) {
+        return false;
+      }
+    }
+  } else {
+    // Version 2: -version, then explicitly numbered entries.
+    const int32_t maxStructure = in.int32();
+    in.string(); // source colortable file
+    const int32_t toRead = in.int32();
+    if (-entries != 2 || !in.ok() || maxStructure <= 0 || toRead < 0) {
+      return false;
+    }
+    table.lut->SetNumberOfTableValues(toRead);
+    for (int32_t i = 0; i < toRead; ++i) {
+      if (!addColorTableEntry(table, in, in.int32())) {
+        return false;
+      }
+    }
+  }
+  table.lut->Build();
+  return true;
+}
+
+vtkSmartPointer<vtkDataArray> readAnnot(const FSurfOverlay& overlay,
+                                        const MappedFile& file,
+                                        size_t vertexCount) {
+  BigEndianCursor in(file.data(), file.size());
+  const int32_t count = in.int32();
+  if (!in.ok() || count < 0 || static_cast<size_t>(count) != vertexCount ||
+      in.remaining() / 8u < vertexCount) {
+    std::cerr << "FreeSurfer annotation " << overlay.path << " does not match the surface" << '\n';
+    return nullptr;
+  }
+  // (vertex, label) pairs, swapped in one pass.
+  std::vector<int32_t> pairs(vertexCount * 2u);
+  byteSwap32Block(in.here(), pairs.data(), pairs.size());
+  in.take(vertexCount * 8u);
+
+  ColorTable table;
+  const int32_t hasColorTable = in.int32();
+  if (!in.ok() || hasColorTable == 0 || !readColorTable(in, table)) {
+    std::cerr << "FreeSurfer annotation " << overlay.path << " has no readable color table"
+              << '\n';
+    return nullptr;
+  }
+
+  auto structures = vtkSmartPointer<vtkIntArray>::New();
+  structures->SetName(overlay.name.c_str());
+  structures->SetNumberOfValues(static_cast<vtkIdType>(vertexCount));
+  structures->FillValue(-1);
+  int* out = structures->GetPointer(0);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    const int32_t vertex = pairs[2 * i];
+    const auto it = table.structureOfLabel.find(pairs[2 * i + 1]);
+    if (vertex >= 0 && static_cast<size_t>(vertex) < vertexCount &&
+        it != table.structureOfLabel.end()) {
+      out[vertex] = it->second;
+    }
+  }
+  structures->SetLookupTable(table.lut);
+  return structures;
+}
+
+// ASCII label: a comment line, the vertex count, then "vertex x y z value" rows.
+vtkSmartPointer<vtkDataArray> readLabel(const FSurfOverlay& overlay, size_t vertexCount) {
+  std::ifstream in(overlay.path);
+  std::string line;
+  size_t rows = 0;
+  if (!in || !std::getline(in, line) || !(in >> rows)) {
+    std::cerr << "Could not read FreeSurfer label " << overlay.path << '\n';
+    return nullptr;
+  }
+  auto members = vtkSmartPointer<vtkIntArray>::New();
+  members->SetName(overlay.name.c_str());
+  members->SetNumberOfValues(static_cast<vtkIdType>(vertexCount));
+  members->FillValue(0);
+  int* out = members->GetPointer(0);
+  std::getline(in, line);
+  for (size_t i = 0; i < rows && std::getline(in, line); ++i) {
+    std::istringstream row(line);
+    long long vertex = -1;
+    if (row >> vertex && vertex >= 0 && static_cast<unsigned long long>(vertex) < vertexCount) {
+      out[vertex] = 1;
+    } else {
+      std::cerr << "FreeSurfer label " << overlay.path << " does not match the surface" << '\n';
+      return nullptr;
+    }
+  }
+  return members;
+}
+
+} // namespace
+
+std::vector<FSurfOverlay> findFSurfOverlays(const std::string& surfacePath) {
+  namespace fs = std::filesystem;
+  std::vector<FSurfOverlay> overlays;
+  const fs::path surface(surfacePath);
+  const std::string base = surface.filename().string();
+  const size_t dot = base.find('.');
+  if (dot == std::string::npos || dot == 0) {
+    return overlays;
+  }
+  const std::string hemi = base.substr(0, dot + 1); // "lh."
+  const fs::path surfDir = surface.has_parent_path() ? surface.parent_path() : fs::path(".");
+
+  std::error_code ec;
+  for (const char* morph : {"curv", "thickness", "sulc"}) {
+    const fs::path path = surfDir / (hemi + morph);
+    if (fs::is_regular_file(path, ec)) {
+      overlays.push_back({FSurfOverlay::Kind::Morph, path.string(), morph});
+    }
+  }
+
+  std::vector<FSurfOverlay> annots;
+  std::vector<FSurfOverlay> labels;
+  for (const fs::path& dir : {surfDir, surfDir / ".." / "label"}) {
+    if (!fs::is_directory(dir, ec)) {
+      continue;
+    }
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+      const std::string name = entry.path().filename().string();
+      if (name.compare(0, hemi.size(), hemi) != 0 || !entry.is_regular_file(ec)) {
+        continue;
+      }
+      const auto stem = [&](size_t suffix) {
+        return name.substr(hemi.size(), name.size() - hemi.size() - suffix);
+      };
+      if (endsWith(name, ".annot") && name.size() > hemi.size() + 6) {
+        annots.push_back({FSurfOverlay::Kind::Annot, entry.path().string(), stem(6)});
+      } else if (endsWith(name, ".label") && name.size() > hemi.size() + 6) {
+        labels.push_back({FSurfOverlay::Kind::Label, entry.path().string(), stem(6)});
+      }
+    }
+  }
+  const auto byName = [](const FSurfOverlay& a, const FSurfOverlay& b) {
+    return a.name < b.name;
+  };
+  std::stable_sort(annots.begin(), annots.end(), byName);
+  std::stable_sort(labels.begin(), labels.end(), byName);
+  overlays.insert(overlays.end(), annots.begin(), annots.end());
+  overlays.insert(overlays.end(), labels.begin(), labels.end());
+
+  // One array per name: a file next to the surface shadows the label/ copy.
+  std::vector<FSurfOverlay> unique;
+  for (auto& overlay : overlays) {
+    const bool seen = std::any_of(unique.begin(), unique.end(), [&](const FSurfOverlay& o) {
+      return o.name == overlay.name;
+    });
+    if (!seen) {
+      unique.push_back(std::move(overlay));
+    }
+  }
+  return unique;
+}
+
+vtkSmartPointer<vtkDataArray> readFSurfOverlay(const FSurfOverlay& overlay, size_t vertexCount) {
+  if (overlay.kind == FSurfOverlay::Kind::Label) {
+    return readLabel(overlay, vertexCount);
+  }
+  MappedFile file;
+  if (!file.open(overlay.path)) {
+    std::cerr << "Could not open FreeSurfer overlay " << overlay.path << '\n';
+    return nullptr;
+  }
+  if (overlay.kind == FSurfOverlay::Kind::Annot) {
+    return readAnnot(overlay, file, vertexCount);
+  }
+  return readMorph(overlay, file, vertexCount);
+}
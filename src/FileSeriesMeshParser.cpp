@@ -0,0 +1,226 @@
+#include "FileSeriesMeshParser.h"
+
+#include "MappedFile.h"
+#include "XmlPullReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string lowerExtension(const fs::path& path) {
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return ext;
+}
+
+bool isSerialVTKExtension(const std::string& ext) {
+  return ext == ".vtu" || ext == ".vtp" || ext == ".vts" || ext == ".vtr" || ext == ".vti" ||
+         ext == ".vtk";
+}
+
+// A numbered series needs the opened file and at least this many siblings, so
+// a stray result_2.vtu next to result_1.vtu still opens on its own.
+constexpr size_t kMinSeriesSiblings = 2;
+
+// A file stem split at its trailing number: "result_0012" -> "result_",
+// "0012", 12.
+struct NumberedStem {
+  std::string prefix;
+  std::string digits;
+  uint64_t number = 0;
+
+  bool zeroPadded() const {
+    return digits.size() > 1 && digits.front() == '0';
+  }
+};
+
+// False if the stem does not end in a number.
+bool splitNumber(const std::string& stem, NumberedStem& split) {
+  size_t start = stem.size();
+  while (start > 0 && std::isdigit(static_cast<unsigned char>(stem[start - 1]))) {
+    --start;
+  }
+  if (start == stem.size()) {
+    return false;
+  }
+  const char* last = stem.data() + stem.size();
+  const auto [end, ec] = std::from_chars(stem.data() + start, last, split.number);
+  if (ec != std::errc() || end != last) {
+    return false;
+  }
+  split.prefix = stem.substr(0, start);
+  split.digits = stem.substr(start);
+  return true;
+}
+
+// Whether `sibling` is numbered like `opened`: the same prefix, and the same
+// number of digits when either is zero-padded (result_0012 goes with
+// result_0100, not with result_7 or result_00012).
+bool sameNumbering(const NumberedStem& opened, const NumberedStem& sibling) {
+  if (sibling.prefix != opened.prefix) {
+    return false;
+  }
+  if (opened.zeroPadded() || sibling.zeroPadded()) {
+    return sibling.digits.size() == opened.digits.size();
+  }
+  return true;
+}
+
+// The files next to `path` numbered like it, in numeric order; each step's time
+// is its number. `opened` is set to the index of `path` itself.
+std::vector<FileSeriesTemporalSource::Step> listNumbered(const std::string& path, int& opened) {
+  const fs::path file(path);
+  const std::string ext = file.extension().string();
+  NumberedStem stem;
+  if (!splitNumber(file.stem().string(), stem)) {
+    return {};
+  }
+  std::vector<std::pair<uint64_t, std::string>> found;
+  std::error_code ec;
+  const fs::path dir = file.has_parent_path() ? file.parent_path() : fs::path(".");
+  for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+    const fs::path& sibling = it->path();
+    NumberedStem siblingStem;
+    if (sibling.extension().string() == ext &&
+        splitNumber(sibling.stem().string(), siblingStem) && sameNumbering(stem, siblingStem) &&
+        it->is_regular_file(ec)) {
+      found.emplace_back(siblingStem.number, (dir / sibling.filename()).string());
+    }
+  }
+  std::sort(found.begin(), found.end());
+  std::vector<FileSeriesTemporalSource::Step> steps;
+  opened = 0;
+  for (auto& [value, name] : found) {
+    if (fs::path(name).filename() == file.filename()) {
+      opened = static_cast<int>(steps.size());
+    }
+    steps.push_back({std::move(name), static_cast<double>(value)});
+  }
+  return steps;
+}
+
+// The <DataSet> entries of a .pvd collection, by time step. Collections that
+// split each step into parts play the first part.
+std::vector<FileSeriesTemporalSource::Step> listCollection(const std::string& path) {
+  MappedFile file;
+  if (!file.open(path)) {
+    return {};
+  }
+  const fs::path dir = fs::path(path).parent_path();
+  XmlPullReader xml(file.begin(), file.end());
+  std::vector<FileSeriesTemporalSource::Step> steps;
+  std::string firstPart;
+  bool sawPart = false;
+  while (true) {
+    const XmlPullReader::Event event = xml.next();
+    if (event == XmlPullReader::Event::Error) {
+      return {};
+    }
+    if (event == XmlPullReader::Event::EndDocument) {
+      break;
+    }
+    std::string relative;
+    if (event != XmlPullReader::Event::StartElement || xml.name() != "DataSet" ||
+        !xml.attribute("file", relative) || relative.empty()) {
+      continue;
+    }
+    std::string part;
+    xml.attribute("part", part);
+    if (!sawPart) {
+      firstPart = part;
+      sawPart = true;
+    } else if (part != firstPart) {
+      continue;
+    }
+    FileSeriesTemporalSource::Step step;
+    step.path = (dir / fs::path(relative)).lexically_normal().string();
+    std::string timestep;
+    if (xml.attribute("timestep", timestep)) {
+      step.time = std::strtod(timestep.c_str(), nullptr);
+    }
+    steps.push_back(std::move(step));
+  }
+  std::stable_sort(steps.begin(),
+                   steps.end(),
+                   [](const FileSeriesTemporalSource::Step& a,
+                      const FileSeriesTemporalSource::Step& b) { return a.time < b.time; });
+  return steps;
+}
+
+} // namespace
+
+FileSeriesMeshParser::FileSeriesMeshParser(bool numberedSeries)
+    : numberedSeries_(numberedSeries) {}
+
+FileSeriesMeshParser::~FileSeriesMeshParser() = default;
+
+bool FileSeriesMeshParser::canParse(const FileHead& head) {
+  const std::string ext = lowerExtension(head.path);
+  const std::string_view header = head.prefix(512);
+  if (ext == ".pvd") {
+    return header.find("<VTKFile") != std::string_view::npos &&
+           header.find("Collection") != std::string_view::npos;
+  }
+  if (!numberedSeries_ || !isSerialVTKExtension(ext) ||
+      (header.find("<VTKFile") == std::string_view::npos &&
+       header.find("# vtk DataFile") == std::string_view::npos)) {
+    return false;
+  }
+  // A numbered file with enough siblings numbered like it.
+  listed_ = listNumbered(head.path, listedOpened_);
+  listedPath_ = head.path;
+  return listed_.size() > kMinSeriesSiblings;
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> FileSeriesMeshParser::parse(const std::string& filename) {
+  temporal_.reset();
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+
+  const bool collection = lowerExtension(filename) == ".pvd";
+  std::vector<FileSeriesTemporalSource::Step> steps;
+  // A numbered series starts on the file that was opened.
+  int opened = 0;
+  if (collection) {
+    steps = listCollection(filename);
+  } else if (filename == listedPath_) {
+    steps = std::move(listed_);
+    opened = listedOpened_;
+  } else {
+    steps = listNumbered(filename, opened);
+  }
+  listedPath_.clear();
+  listed_.clear();
+  if (steps.empty()) {
+    std::cerr << "No datasets in file series: " << filename << '\n';
+    return meshes;
+  }
+
+  // Only a collection is one file that sidecars can be named after.
+  auto source = std::make_shared<FileSeriesTemporalSource>(
+      std::move(steps), collection ? filename : "", opened);
+  vtkSmartPointer<vtkDataSet> mesh = source->open();
+  if (cancelled()) {
+    return meshes;
+  }
+  if (!mesh) {
+    std::cerr << "Failed to read VTK file: " << filename << '\n';
+    return meshes;
+  }
+  meshes.push_back(mesh);
+  if (source->playable()) {
+    temporal_ = std::move(source);
+  }
+  return meshes;
+}
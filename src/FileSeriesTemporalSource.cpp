@@ -0,0 +1,664 @@
+#include "FileSeriesTemporalSource.h"
+
+#include "MappedFile.h"
+#include "XmlPullReader.h"
+#include "base64.h"
+#include "text_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataArraySelection.h>
+#include <vtkDataSetReader.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkType.h>
+#include <vtkXMLImageDataReader.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLReader.h>
+#include <vtkXMLRectilinearGridReader.h>
+#include <vtkXMLStructuredGridReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+namespace {
+
+// A <DataArray> of a serial VTK XML file, located but not decoded.
+struct ArraySpan {
+  std::string name;
+  std::string type;   // "Float32", "Int64", ...
+  std::string format; // "ascii", "binary" or "appended"
+  int components = 1;
+  uint64_t offset = 0;             // into the appended data
+  const char* textBegin = nullptr; // inline content
+  const char* textEnd = nullptr;
+};
+
+// Where the parts of a serial VTK XML file are, from one pass over its markup
+// (the appended data block itself is not scanned).
+struct XmlLayout {
+  std::string type; // <VTKFile type>: "UnstructuredGrid", "PolyData", ...
+  // Uncompressed, little-endian and a single piece: arrays can be decoded here.
+  bool decodable = false;
+  bool header64 = false; // UInt64 block byte counts instead of UInt32
+  // Extents, origin, spacing and element counts of the dataset and its piece.
+  std::string shape;
+  std::vector<ArraySpan> geometry; // points, cells, coordinates
+  std::vector<ArraySpan> pointData;
+  std::vector<ArraySpan> cellData;
+  bool appendedBase64 = false;
+  const char* appended = nullptr;    // first byte after the '_' marker
+  const char* appendedEnd = nullptr; // end of base64 appended data
+  const char* end = nullptr;
+};
+
+const char* const kShapeAttributes[] = {"WholeExtent",
+                                        "Origin",
+                                        "Spacing",
+                                        "Direction",
+                                        "Extent",
+                                        "NumberOfPoints",
+                                        "NumberOfCells",
+                                        "NumberOfVerts",
+                                        "NumberOfLines",
+                                        "NumberOfStrips",
+                                        "NumberOfPolys"};
+
+bool isGeometrySection(std::string_view name) {
+  return name == "Points" || name == "Cells" || name == "Verts" || name == "Lines" ||
+         name == "Strips" || name == "Polys" || name == "Coordinates";
+}
+
+void appendShape(const XmlPullReader& xml, std::string& shape) {
+  std::string value;
+  for (const char* key : kShapeAttributes) {
+    if (xml.attribute(key, value)) {
+      shape.append(key).append("=").append(value).append(";");
+    }
+  }
+}
+
+bool scanLayout(const char* begin, const char* end, XmlLayout& layout) {
+  using Event = XmlPullReader::Event;
+  XmlPullReader xml(begin, end);
+  if (xml.next() != Event::StartElement || xml.name() != "VTKFile") {
+    return false;
+  }
+  std::string value;
+  xml.attribute("type", layout.type);
+  const bool compressed = xml.attribute("compressor", value) && !value.empty();
+  const bool bigEndian = xml.attribute("byte_order", value) && value != "LittleEndian";
+  layout.header64 = xml.attribute("header_type", value) && value == "UInt64";
+  layout.end = end;
+
+  int pieces = 0;
+  std::vector<ArraySpan>* section = nullptr;
+  while (true) {
+    const Event event = xml.next();
+    if (event == Event::Error) {
+      return false;
+    }
+    if (event == Event::EndDocument) {
+      break;
+    }
+    if (event == Event::EndElement) {
+      continue;
+    }
+    const size_t depth = xml.depth();
+    const std::string_view name = xml.name();
+    if (depth == 2 && name == "AppendedData") {
+      layout.appendedBase64 = xml.attribute("encoding", value) && value == "base64";
+      const char* p = skipBlanks(xml.contentBegin(), end);
+      if (p == end || *p != '_') {
+        return false;
+      }
+      layout.appended = p + 1;
+      if (layout.appendedBase64) {
+        const std::string_view data(layout.appended, static_cast<size_t>(end - layout.appended));
+        const size_t close = data.rfind("</AppendedData");
+        layout.appendedEnd = close == std::string_view::npos ? end : layout.appended + close;
+      }
+      // Raw bytes follow: the markup that matters is behind us.
+      break;
+    }
+    if (depth == 2) {
+      appendShape(xml, layout.shape);
+      continue;
+    }
+    if (depth == 3 && name == "Piece") {
+      ++pieces;
+      appendShape(xml, layout.shape);
+      continue;
+    }
+    if (depth == 4) {
+      section = name == "PointData"        ? &layout.pointData
+                : name == "CellData"       ? &layout.cellData
+                : isGeometrySection(name) ? &layout.geometry
+                                           : nullptr;
+      if (section) {
+        continue;
+      }
+    }
+    if (depth == 5 && section && name == "DataArray") {
+      ArraySpan array;
+      xml.attribute("Name", array.name);
+      xml.attribute("type", array.type);
+      xml.attribute("format", array.format);
+      if (xml.attribute("NumberOfComponents", value)) {
+        array.components = std::atoi(value.c_str());
+      }
+      if (xml.attribute("offset", value)) {
+        array.offset = std::strtoull(value.c_str(), nullptr, 10);
+      }
+      array.textBegin = xml.contentBegin();
+      if (!xml.skipElement()) {
+        return false;
+      }
+      // A self-closing element has no content; its end is its start tag.
+      array.textEnd = std::max(array.textBegin, xml.tagBegin());
+      section->push_back(std::move(array));
+      continue;
+    }
+    if (!xml.skipElement()) {
+      return false;
+    }
+  }
+  layout.decodable = !compressed && !bigEndian && pieces == 1;
+  return true;
+}
+
+uint64_t blockByteCount(const char* header, bool header64) {
+  if (header64) {
+    uint64_t count;
+    std::memcpy(&count, header, sizeof(count));
+    return count;
+  }
+  uint32_t count;
+  std::memcpy(&count, header, sizeof(count));
+  return count;
+}
+
+// End of the appended base64 block starting at `offset`: where the next one
+// starts, or the end of the appended data.
+const char* appendedBlockEnd(const XmlLayout& layout, uint64_t offset) {
+  const char* end = layout.appendedEnd;
+  for (const auto* arrays : {&layout.geometry, &layout.pointData, &layout.cellData}) {
+    for (const ArraySpan& array : *arrays) {
+      if (array.format == "appended" && array.offset > offset) {
+        end = std::min(end, layout.appended + array.offset);
+      }
+    }
+  }
+  return end;
+}
+
+// The encoded bytes of an array as they sit in the file (byte count included),
+// for comparing two files' arrays without decoding them.
+bool encodedBytes(const XmlLayout& layout, const ArraySpan& array, std::string_view& out) {
+  if (array.format != "appended") {
+    out = std::string_view(array.textBegin, static_cast<size_t>(array.textEnd - array.textBegin));
+    return true;
+  }
+  if (!layout.appended || array.offset > static_cast<uint64_t>(layout.end - layout.appended)) {
+    return false;
+  }
+  const char* block = layout.appended + array.offset;
+  if (layout.appendedBase64) {
+    const char* blockEnd = appendedBlockEnd(layout, array.offset);
+    out = std::string_view(block, static_cast<size_t>(std::max(block, blockEnd) - block));
+    return true;
+  }
+  const size_t headerBytes = layout.header64 ? 8 : 4;
+  const auto available = static_cast<uint64_t>(layout.end - block);
+  if (available < headerBytes) {
+    return false;
+  }
+  const uint64_t count = blockByteCount(block, layout.header64);
+  if (count > available - headerBytes) {
+    return false;
+  }
+  out = std::string_view(block, headerBytes + static_cast<size_t>(count));
+  return true;
+}
+
+// The data bytes of a binary or appended array, without the byte count.
+// `storage` holds them when they had to be decoded from base64.
+bool dataBytes(const XmlLayout& layout,
+               const ArraySpan& array,
+               std::string& storage,
+               std::string_view& out) {
+  const size_t headerBytes = layout.header64 ? 8 : 4;
+  const bool base64 = array.format == "binary" || layout.appendedBase64;
+  if (!base64) {
+    std::string_view block;
+    if (!encodedBytes(layout, array, block)) {
+      return false;
+    }
+    out = block.substr(headerBytes);
+    return true;
+  }
+  const char* p = array.textBegin;
+  const char* end = array.textEnd;
+  if (array.format == "appended") {
+    if (!layout.appended || array.offset > static_cast<uint64_t>(layout.end - layout.appended)) {
+      return false;
+    }
+    p = layout.appended + array.offset;
+    end = appendedBlockEnd(layout, array.offset);
+  }
+  storage.clear();
+  if (!decodeBase64(p, end, headerBytes, storage)) {
+    return false;
+  }
+  const uint64_t count = blockByteCount(storage.data(), layout.header64);
+  if (count > static_cast<uint64_t>(end - p) ||
+      !decodeBase64(p, end, headerBytes + static_cast<size_t>(count), storage)) {
+    return false;
+  }
+  out = std::string_view(storage).substr(headerBytes, static_cast<size_t>(count));
+  return true;
+}
+
+template <typename T> bool scanValues(const char* p, const char* end, size_t count, void* out) {
+  T* values = static_cast<T*>(out);
+  for (size_t i = 0; i < count; ++i) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (!scanReal(p, end, values[i])) {
+        return false;
+      }
+    } else if (!scanInt(p, end, values[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The VTK XML value types, with the VTK array each becomes.
+struct ValueType {
+  const char* name;
+  int vtkType;
+  size_t size;
+  bool (*scanAscii)(const char* p, const char* end, size_t count, void* out);
+};
+
+const ValueType kValueTypes[] = {
+    {"Int8", VTK_SIGNED_CHAR, 1, scanValues<signed char>},
+    {"UInt8", VTK_UNSIGNED_CHAR, 1, scanValues<unsigned char>},
+    {"Int16", VTK_SHORT, 2, scanValues<short>},
+    {"UInt16", VTK_UNSIGNED_SHORT, 2, scanValues<unsigned short>},
+    {"Int32", VTK_INT, 4, scanValues<int>},
+    {"UInt32", VTK_UNSIGNED_INT, 4, scanValues<unsigned int>},
+    {"Int64", VTK_LONG_LONG, 8, scanValues<long long>},
+    {"UInt64", VTK_UNSIGNED_LONG_LONG, 8, scanValues<unsigned long long>},
+    {"Float32", VTK_FLOAT, 4, scanValues<float>},
+    {"Float64", VTK_DOUBLE, 8, scanValues<double>},
+};
+
+// Decode one point or cell data array of `tuples` tuples; null if its type or
+// encoding is not handled here or its size does not match.
+vtkSmartPointer<vtkDataArray>
+decodeArray(const XmlLayout& layout, const ArraySpan& array, vtkIdType tuples) {
+  const auto type = std::find_if(std::begin(kValueTypes),
+                                 std::end(kValueTypes),
+                                 [&](const ValueType& t) { return array.type == t.name; });
+  if (type == std::end(kValueTypes) || array.components < 1 || array.name.empty()) {
+    return nullptr;
+  }
+  vtkSmartPointer<vtkDataArray> decoded;
+  decoded.TakeReference(vtkDataArray::CreateDataArray(type->vtkType));
+  decoded->SetName(array.name.c_str());
+  decoded->SetNumberOfComponents(array.components);
+  decoded->SetNumberOfTuples(tuples);
+  const size_t values = static_cast<size_t>(tuples) * static_cast<size_t>(array.components);
+  if (values == 0) {
+    return decoded;
+  }
+  void* out = decoded->GetVoidPointer(0);
+
+  if (array.format == "ascii") {
+    return type->scanAscii(array.textBegin, array.textEnd, values, out) ? decoded : nullptr;
+  }
+  if (array.format != "binary" && array.format != "appended") {
+    return nullptr;
+  }
+  std::string storage;
+  std::string_view bytes;
+  if (!dataBytes(layout, array, storage, bytes) || bytes.size() != values * type->size) {
+    return nullptr;
+  }
+  std::memcpy(out, bytes.data(), bytes.size());
+  return decoded;
+}
+
+// Decode the arrays of `spans` that `only` selects, all of them if its name
+// is empty. False if one of them cannot be decoded here.
+bool decodeSelected(const XmlLayout& layout,
+                    const std::vector<ArraySpan>& spans,
+                    FieldAssociation association,
+                    vtkIdType tuples,
+                    const ScalarField& only,
+                    std::vector<vtkSmartPointer<vtkDataArray>>& arrays) {
+  for (const ArraySpan& span : spans) {
+    if (!only.name.empty() && (only.association != association || span.name != only.name)) {
+      continue;
+    }
+    vtkSmartPointer<vtkDataArray> array = decodeArray(layout, span, tuples);
+    if (!array) {
+      return false;
+    }
+    arrays.push_back(std::move(array));
+  }
+  return true;
+}
+
+// Whether two files lay out their points and cells alike: the same type,
+// extents and counts, and geometry arrays of the same type, encoding, offset
+// and encoded length. Reads the markup and block headers only. `aBytes` and
+// `bBytes` get the encoded geometry arrays for sameGeometryBytes.
+bool sameGeometryLayout(const XmlLayout& a,
+                        const XmlLayout& b,
+                        std::vector<std::string_view>& aBytes,
+                        std::vector<std::string_view>& bBytes) {
+  if (a.type != b.type || a.shape != b.shape || a.geometry.size() != b.geometry.size()) {
+    return false;
+  }
+  aBytes.resize(a.geometry.size());
+  bBytes.resize(b.geometry.size());
+  for (size_t i = 0; i < a.geometry.size(); ++i) {
+    const ArraySpan& x = a.geometry[i];
+    const ArraySpan& y = b.geometry[i];
+    if (x.type != y.type || x.components != y.components || x.format != y.format ||
+        x.offset != y.offset || !encodedBytes(a, x, aBytes[i]) ||
+        !encodedBytes(b, y, bBytes[i]) || aBytes[i].size() != bBytes[i].size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether the encoded geometry arrays hold the same bytes. This pages in both
+// files' geometry, so its answer is kept per step.
+bool sameGeometryBytes(const std::vector<std::string_view>& aBytes,
+                       const std::vector<std::string_view>& bBytes) {
+  return aBytes == bBytes;
+}
+
+// Read a whole file with VTK, restricted to `only` unless its name is empty.
+// An empty `type` means a legacy .vtk file.
+vtkSmartPointer<vtkDataSet>
+readWithVTK(const std::string& path, const std::string& type, const ScalarField& only) {
+  vtkSmartPointer<vtkXMLReader> reader;
+  if (type == "UnstructuredGrid") {
+    reader = vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
+  } else if (type == "PolyData") {
+    reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+  } else if (type == "StructuredGrid") {
+    reader = vtkSmartPointer<vtkXMLStructuredGridReader>::New();
+  } else if (type == "RectilinearGrid") {
+    reader = vtkSmartPointer<vtkXMLRectilinearGridReader>::New();
+  } else if (type == "ImageData") {
+    reader = vtkSmartPointer<vtkXMLImageDataReader>::New();
+  }
+
+  vtkSmartPointer<vtkDataSet> data;
+  if (!reader) {
+    if (!type.empty()) {
+      std::cerr << "Unsupported VTK XML type '" << type << "' in file series: " << path << '\n';
+      return nullptr;
+    }
+    vtkNew<vtkDataSetReader> legacy;
+    legacy->SetFileName(path.c_str());
+    // A legacy file names its attributes rather than listing arrays: read the
+    // scalars or vectors called `only`, or every attribute. FIELD arrays are
+    // always read.
+    const bool all = only.name.empty();
+    legacy->SetReadAllScalars(all);
+    legacy->SetReadAllVectors(all);
+    legacy->SetReadAllTensors(all);
+    legacy->SetReadAllColorScalars(all);
+    legacy->SetReadAllTCoords(all);
+    if (!all) {
+      legacy->SetScalarsName(only.name.c_str());
+      legacy->SetVectorsName(only.name.c_str());
+    }
+    legacy->Update();
+    data = legacy->GetOutput();
+  } else {
+    reader->SetFileName(path.c_str());
+    if (!only.name.empty()) {
+      // The selections list the file's arrays once its information is read.
+      reader->UpdateInformation();
+      const std::pair<vtkDataArraySelection*, bool> selections[] = {
+          {reader->GetPointDataArraySelection(), only.association == FieldAssociation::Point},
+          {reader->GetCellDataArraySelection(), only.association == FieldAssociation::Cell},
+      };
+      for (const auto& [sel, holdsField] : selections) {
+        if (!sel) {
+          continue;
+        }
+        sel->DisableAllArrays();
+        if (holdsField) {
+          sel->EnableArray(only.name.c_str());
+        }
+      }
+    }
+    reader->Update();
+    data = reader->GetOutputAsDataSet();
+  }
+  if (!data || data->GetNumberOfPoints() == 0) {
+    return nullptr;
+  }
+  return data;
+}
+
+} // namespace
+
+// Whether a step's points and cells are the first step's, once compared.
+enum class GeometryMatch : uint8_t { Unknown, Same, Different };
+
+// The first step: the geometry later steps are compared with and share.
+struct FileSeriesTemporalSource::First {
+  MappedFile file;
+  XmlLayout layout; // type empty for a legacy file
+  vtkSmartPointer<vtkDataSet> data;
+  // Per step, so each step's geometry is compared byte for byte at most once.
+  // Shared with clones, which read on their own threads.
+  std::unique_ptr<std::atomic<GeometryMatch>[]> matches;
+};
+
+FileSeriesTemporalSource::FileSeriesTemporalSource(std::vector<Step> steps,
+                                                   std::string fileName,
+                                                   int initialStep)
+    : steps_(std::make_shared<const std::vector<Step>>(std::move(steps))),
+      fileName_(std::move(fileName)),
+      initialStep_(std::clamp(initialStep, 0, std::max(0, this->steps() - 1))) {}
+
+FileSeriesTemporalSource::~FileSeriesTemporalSource() = default;
+
+vtkSmartPointer<vtkDataSet> FileSeriesTemporalSource::open() {
+  if (steps_->empty()) {
+    return nullptr;
+  }
+  auto first = std::make_shared<First>();
+  const std::string& path = steps_->front().path;
+  if (!first->file.open(path) ||
+      !scanLayout(first->file.begin(), first->file.end(), first->layout)) {
+    first->layout = XmlLayout();
+  }
+  if (!first->layout.decodable) {
+    first->file.close();
+  }
+  first->data = readWithVTK(path, first->layout.type, ScalarField());
+  if (!first->data) {
+    return nullptr;
+  }
+  first->matches = std::make_unique<std::atomic<GeometryMatch>[]>(steps_->size());
+  for (size_t step = 0; step < steps_->size(); ++step) {
+    first->matches[step].store(GeometryMatch::Unknown, std::memory_order_relaxed);
+  }
+  first->matches[0].store(GeometryMatch::Same, std::memory_order_relaxed);
+  first_ = first;
+
+  vtkSmartPointer<vtkDataSet> mesh;
+  mesh.TakeReference(first->data->NewInstance());
+  mesh->ShallowCopy(first->data);
+  if (initialStep_ > 0 && !readFrame(initialStep_, ScalarField(), mesh)) {
+    return nullptr;
+  }
+  return mesh;
+}
+
+std::vector<std::string> FileSeriesTemporalSource::inputFiles() const {
+  std::vector<std::string> files;
+  if (fileName_.empty()) {
+    return files;
+  }
+  files.reserve(steps_->size());
+  for (const Step& step : *steps_) {
+    files.push_back(step.path);
+  }
+  return files;
+}
+
+double FileSeriesTemporalSource::timeAt(int step) const {
+  if (step < 0 || step >= steps()) {
+    return 0.0;
+  }
+  return (*steps_)[static_cast<size_t>(step)].time;
+}
+
+void FileSeriesTemporalSource::setActiveArray(const ScalarField& field) {
+  activeArray_ = field;
+}
+
+std::unique_ptr<TemporalSource> FileSeriesTemporalSource::clone() const {
+  return std::make_unique<FileSeriesTemporalSource>(*this);
+}
+
+bool FileSeriesTemporalSource::readStepInto(int step, vtkDataSet* target) {
+  return readFrame(step, activeArray_, target);
+}
+
+bool FileSeriesTemporalSource::readFrame(int step,
+                                         const ScalarField& only,
+                                         vtkDataSet* target) const {
+  if (!target || !first_ || step < 0 || step >= steps()) {
+    return false;
+  }
+  const std::string& path = (*steps_)[static_cast<size_t>(step)].path;
+  std::atomic<GeometryMatch>& match = first_->matches[static_cast<size_t>(step)];
+  MappedFile file;
+  XmlLayout layout;
+  std::vector<std::string_view> firstGeometry;
+  std::vector<std::string_view> stepGeometry;
+  bool shared = first_->layout.decodable && file.open(path) &&
+                scanLayout(file.begin(), file.end(), layout) && layout.decodable &&
+                match.load() != GeometryMatch::Different &&
+                sameGeometryLayout(first_->layout, layout, firstGeometry, stepGeometry);
+  if (shared && match.load() == GeometryMatch::Unknown) {
+    shared = sameGeometryBytes(firstGeometry, stepGeometry);
+    match.store(shared ? GeometryMatch::Same : GeometryMatch::Different);
+  }
+  if (shared) {
+    // Same mesh as the first step: decode the data arrays only.
+    vtkDataSet* geometry = first_->data;
+    std::vector<vtkSmartPointer<vtkDataArray>> pointArrays;
+    std::vector<vtkSmartPointer<vtkDataArray>> cellArrays;
+    const bool decoded = decodeSelected(layout,
+                                        layout.pointData,
+                                        FieldAssociation::Point,
+                                        geometry->GetNumberOfPoints(),
+                                        only,
+                                        pointArrays) &&
+                         decodeSelected(layout,
+                                        layout.cellData,
+                                        FieldAssociation::Cell,
+                                        geometry->GetNumberOfCells(),
+                                        only,
+                                        cellArrays);
+    if (decoded) {
+      target->ShallowCopy(geometry);
+      vtkPointData* pd = target->GetPointData();
+      // Normals follow from the geometry, which is the first step's.
+      vtkSmartPointer<vtkDataArray> normals = pd->GetNormals();
+      pd->Initialize();
+      target->GetCellData()->Initialize();
+      if (normals) {
+        pd->SetNormals(normals);
+      }
+      for (const auto& array : pointArrays) {
+        pd->AddArray(array);
+      }
+      for (const auto& array : cellArrays) {
+        target->GetCellData()->AddArray(array);
+      }
+      target->Modified();
+      return true;
+    }
+  }
+
+  // A mesh of its own, or an encoding decoded by VTK only (compressed,
+  // big-endian, legacy): read the whole file.
+  vtkSmartPointer<vtkDataSet> data =
+      readWithVTK(path, layout.type.empty() ? first_->layout.type : layout.type, only);
+  if (!data) {
+    std::cerr << "Failed to read VTK file: " << path << '\n';
+    return false;
+  }
+  target->ShallowCopy(data);
+  target->Modified();
+  return true;
+}
+
+bool FileSeriesTemporalSource::sampledScalarRange(const ScalarField& field,
+                                                  double out[2],
+                                                  int maxSamples) {
+  const int numSteps = steps();
+  if (!first_ || numSteps <= 0 || field.name.empty()) {
+    return false;
+  }
+  const int sampleCount = std::min(numSteps, std::max(1, maxSamples));
+  double lo = 0.0;
+  double hi = 0.0;
+  bool any = false;
+  for (int s = 0; s < sampleCount; ++s) {
+    // Evenly spaced steps including first and last.
+    const int step =
+        sampleCount == 1
+            ? 0
+            : static_cast<int>((static_cast<long long>(s) * (numSteps - 1)) / (sampleCount - 1));
+    vtkSmartPointer<vtkDataSet> frame;
+    frame.TakeReference(first_->data->NewInstance());
+    if (!readFrame(step, field, frame)) {
+      continue;
+    }
+    vtkDataArray* arr = arrayForAssociation(frame, field.name, field.association);
+    if (!arr || arr->GetNumberOfTuples() == 0) {
+      continue;
+    }
+    double range[2];
+    arr->GetRange(range);
+    if (!any) {
+      lo = range[0];
+      hi = range[1];
+      any = true;
+    } else {
+      lo = std::min(lo, range[0]);
+      hi = std::max(hi, range[1]);
+    }
+  }
+  if (!any) {
+    return false;
+  }
+  out[0] = lo;
+  out[1] = hi;
+  return true;
+}
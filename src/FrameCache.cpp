@@ -0,0 +1,98 @@
+#include "FrameCache.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+
+FrameCache::FrameCache(uint64_t budgetBytes) : budgetBytes_(budgetBytes) {}
+
+vtkSmartPointer<vtkDataSet> FrameCache::find(int step) {
+  const auto found = index_.find(step);
+  if (found == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, found->second);
+  return found->second->frame;
+}
+
+bool FrameCache::contains(int step) const {
+  return index_.count(step) != 0;
+}
+
+void FrameCache::insert(int step, vtkSmartPointer<vtkDataSet> frame, uint64_t bytes) {
+  if (!frame || bytes > budgetBytes_) {
+    return;
+  }
+  const auto found = index_.find(step);
+  if (found != index_.end()) {
+    erase(found->second);
+  }
+  while (!lru_.empty() && bytes_ + bytes > budgetBytes_) {
+    erase(std::prev(lru_.end()));
+  }
+  lru_.push_front({step, std::move(frame), bytes});
+  index_[step] = lru_.begin();
+  bytes_ += bytes;
+}
+
+void FrameCache::clear() {
+  lru_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+FrameCache::Stats FrameCache::stats() const {
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.bytes = bytes_;
+  stats.frames = lru_.size();
+  return stats;
+}
+
+void FrameCache::erase(std::list<Entry>::iterator it) {
+  bytes_ -= it->bytes;
+  index_.erase(it->step);
+  lru_.erase(it);
+}
+
+bool parseByteSize(const std::string& text, uint64_t& bytes) {
+  const char* begin = text.c_str();
+  char* end = nullptr;
+  const double value = std::strtod(begin, &end);
+  if (end == begin || !std::isfinite(value) || value < 0.0) {
+    return false;
+  }
+  std::string suffix(end);
+  for (char& c : suffix) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+  if (suffix.size() > 1 && suffix.back() == 'B') {
+    suffix.pop_back();
+    if (suffix.size() > 1 && suffix.back() == 'I') {
+      suffix.pop_back();
+    }
+  }
+  double scale = 1.0;
+  if (suffix == "K") {
+    scale = 1024.0;
+  } else if (suffix == "M") {
+    scale = 1024.0 * 1024.0;
+  } else if (suffix == "G") {
+    scale = 1024.0 * 1024.0 * 1024.0;
+  } else if (suffix == "T") {
+    scale = 1024.0 * 1024.0 * 1024.0 * 1024.0;
+  } else if (!suffix.empty() && suffix != "B") {
+    return false;
+  }
+  const double total = value * scale;
+  if (total >= 18446744073709551616.0) {
+    return false;
+  }
+  bytes = static_cast<uint64_t>(total);
+  return true;
+}
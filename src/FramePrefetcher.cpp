@@ -0,0 +1,287 @@
+#include "FramePrefetcher.h"
+
+#include "TemporalSource.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vtkAbstractArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+
+namespace {
+
+// Upper bound on the ring, however small the frames.
+constexpr size_t kMaxFrames = 64;
+
+// The point coordinates and point/cell data arrays of `data`.
+std::vector<vtkAbstractArray*> frameArrays(vtkDataSet* data) {
+  std::vector<vtkAbstractArray*> arrays;
+  if (auto* pointSet = vtkPointSet::SafeDownCast(data)) {
+    if (vtkPoints* points = pointSet->GetPoints()) {
+      arrays.push_back(points->GetData());
+    }
+  }
+  vtkFieldData* const attributes[] = {data->GetPointData(), data->GetCellData()};
+  for (vtkFieldData* fields : attributes) {
+    for (int i = 0; i < fields->GetNumberOfArrays(); ++i) {
+      arrays.push_back(fields->GetAbstractArray(i));
+    }
+  }
+  return arrays;
+}
+
+} // namespace
+
+FramePrefetcher::FramePrefetcher(const TemporalSource& source,
+                                 vtkDataSet* prototype,
+                                 std::function<void(int step)> onReady,
+                                 uint64_t cacheBytes,
+                                 uint64_t budgetBytes)
+    : source_(source.clone()), onReady_(std::move(onReady)), budgetBytes_(budgetBytes),
+      steps_(source.steps()), cache_(cacheBytes) {
+  if (!source_ || !prototype) {
+    source_.reset();
+    return;
+  }
+  // A private shallow copy: the rendered mesh changes with every frame shown.
+  prototype_.TakeReference(prototype->NewInstance());
+  prototype_->ShallowCopy(prototype);
+  previous_ = prototype_;
+  thread_ = std::thread([this]() { run(); });
+}
+
+FramePrefetcher::~FramePrefetcher() {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool FramePrefetcher::take(int step, vtkDataSet* target) {
+  if (!source_ || !target || step < 0 || step >= steps_) {
+    return false;
+  }
+  vtkSmartPointer<vtkDataSet> frame;
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (step != cursor_) {
+      const bool wrapped = loop_ && cursor_ == steps_ - 1 && step == 0;
+      direction_ = (step > cursor_ || wrapped) ? 1 : -1;
+      cursor_ = step;
+      stalled_ = false;
+    }
+    const auto it =
+        std::find_if(ring_.begin(), ring_.end(), [step](const Frame& f) { return f.step == step; });
+    if (it != ring_.end()) {
+      frame = it->data;
+      cache_.insert(step, std::move(it->data), it->bytes);
+      ring_.erase(it);
+    } else if (cache_.enabled()) {
+      frame = cache_.find(step);
+    }
+    if (!frame) {
+      urgent_ = step;
+    }
+    trimLocked();
+  }
+  wake_.notify_one();
+  if (!frame) {
+    return false;
+  }
+  target->ShallowCopy(frame);
+  target->Modified();
+  return true;
+}
+
+void FramePrefetcher::setLookahead(int frames) {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    lookahead_ = std::max(1, frames);
+    trimLocked();
+  }
+  wake_.notify_one();
+}
+
+void FramePrefetcher::setLoop(bool loop) {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    loop_ = loop;
+    trimLocked();
+  }
+  wake_.notify_one();
+}
+
+void FramePrefetcher::setActiveArray(const ScalarField& field) {
+  if (!source_) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return !reading_; });
+    source_->setActiveArray(field);
+    ring_.clear();
+    cache_.clear();
+    stalled_ = false;
+    ++generation_;
+  }
+  wake_.notify_one();
+}
+
+FrameCache::Stats FramePrefetcher::cacheStats() {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.stats();
+}
+
+FramePrefetcher::Pause::Pause(FramePrefetcher* prefetcher) : prefetcher_(prefetcher) {
+  if (!prefetcher_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(prefetcher_->mutex_);
+  ++prefetcher_->pauses_;
+  prefetcher_->idle_.wait(lock, [this]() { return !prefetcher_->reading_; });
+}
+
+FramePrefetcher::Pause::~Pause() {
+  if (!prefetcher_) {
+    return;
+  }
+  {
+    const std::lock_guard<std::mutex> lock(prefetcher_->mutex_);
+    --prefetcher_->pauses_;
+  }
+  prefetcher_->wake_.notify_one();
+}
+
+std::vector<int> FramePrefetcher::windowLocked() const {
+  std::vector<int> window;
+  const int ahead = std::min({lookahead_, static_cast<int>(capacity_) - 1, steps_ - 1});
+  for (int i = 1; i <= ahead; ++i) {
+    int step = cursor_ + direction_ * i;
+    if (step < 0 || step >= steps_) {
+      if (!loop_) {
+        break;
+      }
+      step = (step % steps_ + steps_) % steps_;
+    }
+    window.push_back(step);
+  }
+  return window;
+}
+
+bool FramePrefetcher::wantedLocked(int step) const {
+  if (step == cursor_ || step == urgent_) {
+    return true;
+  }
+  const std::vector<int> window = windowLocked();
+  return std::find(window.begin(), window.end(), step) != window.end();
+}
+
+bool FramePrefetcher::readyLocked(int step) const {
+  return cache_.contains(step) ||
+         std::any_of(
+             ring_.begin(), ring_.end(), [step](const Frame& f) { return f.step == step; });
+}
+
+int FramePrefetcher::nextStepLocked() const {
+  if (stalled_) {
+    return -1;
+  }
+  if (urgent_ >= 0 && !readyLocked(urgent_)) {
+    return urgent_;
+  }
+  for (const int step : windowLocked()) {
+    if (!readyLocked(step)) {
+      return step;
+    }
+  }
+  return -1;
+}
+
+void FramePrefetcher::trimLocked() {
+  // Frames playback has moved past go to the cache, if there is one.
+  const auto kept = std::stable_partition(
+      ring_.begin(), ring_.end(), [this](const Frame& f) { return wantedLocked(f.step); });
+  for (auto it = kept; it != ring_.end(); ++it) {
+    cache_.insert(it->step, std::move(it->data), it->bytes);
+  }
+  ring_.erase(kept, ring_.end());
+}
+
+vtkSmartPointer<vtkDataSet> FramePrefetcher::read(int step) {
+  vtkSmartPointer<vtkDataSet> frame;
+  frame.TakeReference(prototype_->NewInstance());
+  frame->ShallowCopy(prototype_);
+  if (!source_->readStepInto(step, frame)) {
+    return nullptr;
+  }
+  return frame;
+}
+
+// Bytes the frame adds to memory: the arrays it does not share with the frame
+// read before it (static geometry, unchanged arrays).
+uint64_t FramePrefetcher::frameBytes(vtkDataSet* frame) const {
+  const std::vector<vtkAbstractArray*> shared = frameArrays(previous_);
+  uint64_t kibibytes = 0;
+  for (vtkAbstractArray* array : frameArrays(frame)) {
+    if (array && std::find(shared.begin(), shared.end(), array) == shared.end()) {
+      kibibytes += array->GetActualMemorySize();
+    }
+  }
+  return std::max<uint64_t>(1, kibibytes * 1024);
+}
+
+void FramePrefetcher::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    const int step = pauses_ > 0 ? -1 : nextStepLocked();
+    if (step < 0) {
+      wake_.wait(lock);
+      continue;
+    }
+    const uint64_t generation = generation_;
+    reading_ = true;
+    lock.unlock();
+    vtkSmartPointer<vtkDataSet> frame = read(step);
+    const uint64_t bytes = frame ? frameBytes(frame) : 0;
+    if (frame) {
+      previous_ = frame;
+    }
+    lock.lock();
+    reading_ = false;
+    idle_.notify_all();
+    if (generation != generation_) {
+      continue;
+    }
+    if (!frame) {
+      std::cerr << "Failed to read time step " << step << '\n';
+      stalled_ = true;
+      if (urgent_ == step) {
+        urgent_ = -1;
+      }
+      continue;
+    }
+
+    capacity_ = std::clamp<size_t>(static_cast<size_t>(budgetBytes_ / bytes), 2, kMaxFrames);
+    const bool announce = step == urgent_;
+    if (announce) {
+      urgent_ = -1;
+    }
+    if (wantedLocked(step) && !readyLocked(step)) {
+      ring_.push_back({step, std::move(frame), bytes});
+    }
+    trimLocked();
+    if (announce && onReady_) {
+      lock.unlock();
+      onReady_(step);
+      lock.lock();
+    }
+  }
+}
@@ -1,17 +1,26 @@
 #include "JsonMeshParser.h"
 
-#include "mesh_utils.h"
+#include "ByteSource.h"
+#include "MappedFile.h"
+#include "base64.h"
 
 #include <algorithm>
-#include <fstream>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <vtkCellArray.h>
 #include <vtkFieldData.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
@@ -23,210 +32,765 @@ namespace {
 
 using json = nlohmann::json;
 
-bool isMeshPart(const json& value) {
-  return value.is_object() && value.contains("vertices") && value.contains("indices") &&
-         value["vertices"].is_array() && value["indices"].is_array();
+// Key names only JSON meshes use; finding one in the head settles canParse
+// without reading the rest of the file.
+bool headHasMeshKeys(std::string_view head) {
+  return head.find("\"vertices\"") != std::string_view::npos ||
+         head.find("\"indices\"") != std::string_view::npos ||
+         head.find("\"surface\"") != std::string_view::npos;
 }
 
-bool looksLikeJsonMesh(const json& value) {
-  if (isMeshPart(value)) {
-    return true;
-  }
-  if (value.is_object() && value.contains("surface")) {
-    const auto& surface = value["surface"];
-    return surface.is_array() && !surface.empty() &&
-           std::all_of(surface.begin(), surface.end(), isMeshPart);
-  }
-  if (!value.is_array() || value.empty()) {
-    return false;
-  }
-  return std::all_of(value.begin(), value.end(), isMeshPart);
+// ---------------------------------------------------------------------------
+// Binary buffers
+//
+// Instead of a number array, "vertices", "indices" and "normals" may hold a
+// buffer reference in the style of glTF:
+//   {"uri": "part.bin", "byteOffset": 0, "count": 3000, "type": "float32"}
+// `uri` is a file relative to the JSON file or a base64 "data:" URI; `count`
+// is the number of values (not tuples). Data is little-endian.
+
+enum class ComponentType { Invalid, Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+ComponentType componentType(const std::string& name) {
+  static const std::map<std::string, ComponentType> types = {
+      {"int8", ComponentType::Int8},
+      {"uint8", ComponentType::UInt8},
+      {"int16", ComponentType::Int16},
+      {"uint16", ComponentType::UInt16},
+      {"int32", ComponentType::Int32},
+      {"uint32", ComponentType::UInt32},
+      {"float32", ComponentType::Float32},
+      {"float64", ComponentType::Float64},
+  };
+  const auto it = types.find(name);
+  return it == types.end() ? ComponentType::Invalid : it->second;
 }
 
-const json* meshPartArray(const json& root) {
-  if (root.is_array()) {
-    return &root;
+size_t componentSize(ComponentType type) {
+  switch (type) {
+  case ComponentType::Int8:
+  case ComponentType::UInt8:
+    return 1;
+  case ComponentType::Int16:
+  case ComponentType::UInt16:
+    return 2;
+  case ComponentType::Int32:
+  case ComponentType::UInt32:
+  case ComponentType::Float32:
+    return 4;
+  case ComponentType::Float64:
+    return 8;
+  case ComponentType::Invalid:
+    break;
   }
-  if (root.is_object() && root.contains("surface") && root["surface"].is_array()) {
-    return &root["surface"];
+  return 0;
+}
+
+bool isIntegral(ComponentType type) {
+  return type != ComponentType::Float32 && type != ComponentType::Float64 &&
+         type != ComponentType::Invalid;
+}
+
+template <typename Source, typename Target>
+void convertValues(const char* src, size_t count, Target* dst) {
+  if constexpr (std::is_same_v<Source, Target>) {
+    std::memcpy(dst, src, count * sizeof(Target));
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      Source value;
+      std::memcpy(&value, src + i * sizeof(Source), sizeof(Source));
+      dst[i] = static_cast<Target>(value);
+    }
   }
-  return nullptr;
 }
 
-std::string partName(const json& part) {
-  if (part.contains("name") && part["name"].is_string()) {
-    return part["name"].get<std::string>();
+template <typename Target>
+void convertBuffer(ComponentType type, const char* src, size_t count, Target* dst) {
+  switch (type) {
+  case ComponentType::Int8:
+    convertValues<int8_t>(src, count, dst);
+    break;
+  case ComponentType::UInt8:
+    convertValues<uint8_t>(src, count, dst);
+    break;
+  case ComponentType::Int16:
+    convertValues<int16_t>(src, count, dst);
+    break;
+  case ComponentType::UInt16:
+    convertValues<uint16_t>(src, count, dst);
+    break;
+  case ComponentType::Int32:
+    convertValues<int32_t>(src, count, dst);
+    break;
+  case ComponentType::UInt32:
+    convertValues<uint32_t>(src, count, dst);
+    break;
+  case ComponentType::Float32:
+    convertValues<float>(src, count, dst);
+    break;
+  case ComponentType::Float64:
+    convertValues<double>(src, count, dst);
+    break;
+  case ComponentType::Invalid:
+    break;
   }
-  return {};
 }
 
-bool addNormals(vtkPolyData* poly, const json& part, size_t pointCount) {
-  if (!part.contains("normals") || !part["normals"].is_array()) {
+// Resolves buffer URIs for one parse. External files are mapped once and
+// shared by every field that references them.
+class BufferStore {
+public:
+  explicit BufferStore(std::filesystem::path baseDirectory)
+      : baseDirectory_(std::move(baseDirectory)) {
+  }
+
+  bool bytes(const std::string& uri, std::string_view& out) {
+    constexpr std::string_view dataScheme = "data:";
+    if (uri.compare(0, dataScheme.size(), dataScheme) == 0) {
+      const size_t marker = uri.find(";base64,");
+      if (marker == std::string::npos ||
+          !decodeBase64(std::string_view(uri).substr(marker + 8), decoded_)) {
+        return false;
+      }
+      out = decoded_;
+      return true;
+    }
+
+    const std::filesystem::path path = baseDirectory_ / std::filesystem::path(uri);
+    const std::string key = path.lexically_normal().string();
+    auto it = files_.find(key);
+    if (it == files_.end()) {
+      MappedFile file;
+      if (!file.open(key)) {
+        std::cerr << "Failed to read JSON mesh buffer: " << key << '\n';
+        return false;
+      }
+      it = files_.emplace(key, std::move(file)).first;
+    }
+    out = std::string_view(it->second.data(), it->second.size());
     return true;
   }
 
-  const auto& normals = part["normals"];
-  if (normals.size() != pointCount * 3u) {
-    return false;
+  // The external buffer files read so far.
+  std::vector<std::string> paths() const {
+    std::vector<std::string> paths;
+    paths.reserve(files_.size());
+    for (const auto& entry : files_) {
+      paths.push_back(entry.first);
+    }
+    return paths;
   }
 
-  vtkNew<vtkFloatArray> normalArray;
-  normalArray->SetName("Normals");
-  normalArray->SetNumberOfComponents(3);
-  normalArray->SetNumberOfTuples(static_cast<vtkIdType>(pointCount));
-  for (size_t i = 0; i < pointCount; ++i) {
-    const size_t i3 = i * 3u;
-    const float tuple[3] = {
-        normals[i3].get<float>(), normals[i3 + 1u].get<float>(), normals[i3 + 2u].get<float>()};
-    normalArray->SetTypedTuple(static_cast<vtkIdType>(i), tuple);
+private:
+  std::filesystem::path baseDirectory_;
+  std::map<std::string, MappedFile> files_;
+  std::string decoded_;
+};
+
+struct BufferSpec {
+  std::string uri;
+  std::string type;
+  uint64_t byteOffset = 0;
+  uint64_t count = 0;
+  bool hasCount = false;
+};
+
+// ---------------------------------------------------------------------------
+// Parts
+
+enum class Field { None, Vertices, Indices, Normals, Color, Name, Surface };
+
+Field fieldForKey(const std::string& key) {
+  if (key == "vertices") {
+    return Field::Vertices;
   }
-  poly->GetPointData()->SetNormals(normalArray);
-  poly->GetPointData()->AddArray(normalArray);
-  return true;
+  if (key == "indices") {
+    return Field::Indices;
+  }
+  if (key == "normals") {
+    return Field::Normals;
+  }
+  if (key == "color") {
+    return Field::Color;
+  }
+  if (key == "name") {
+    return Field::Name;
+  }
+  if (key == "surface") {
+    return Field::Surface;
+  }
+  return Field::None;
 }
 
-bool addColor(vtkPolyData* poly, const json& part) {
-  if (!part.contains("color") || !part["color"].is_array()) {
-    return true;
+// One part object as the SAX events arrive. Numbers go straight into the VTK
+// arrays the mesh is built from; nothing is staged in an intermediate tree.
+struct PartBuilder {
+  vtkSmartPointer<vtkFloatArray> vertices;
+  vtkSmartPointer<vtkIdTypeArray> indices;
+  vtkSmartPointer<vtkFloatArray> normals;
+  std::array<double, 3> color{};
+  size_t colorCount = 0;
+  bool hasColor = false;
+  std::string name;
+  bool valid = true;
+
+  void reset() {
+    *this = PartBuilder();
   }
 
-  const auto& color = part["color"];
-  if (color.size() < 3u) {
-    return false;
+  // Same test as a DOM check for "vertices" and "indices" arrays: decides
+  // whether the object is a mesh part at all, not whether it is well formed.
+  bool isMeshPart() const {
+    return vertices && indices;
   }
 
-  vtkNew<vtkFloatArray> colorArray;
-  colorArray->SetName("vv_part_color");
-  colorArray->SetNumberOfComponents(3);
-  colorArray->InsertNextTuple3(
-      color[0].get<double>(), color[1].get<double>(), color[2].get<double>());
-  poly->GetFieldData()->AddArray(colorArray);
-  return true;
-}
+  void begin(Field field) {
+    switch (field) {
+    case Field::Vertices:
+      vertices = vtkSmartPointer<vtkFloatArray>::New();
+      vertices->SetNumberOfComponents(3);
+      break;
+    case Field::Indices:
+      indices = vtkSmartPointer<vtkIdTypeArray>::New();
+      break;
+    case Field::Normals:
+      normals = vtkSmartPointer<vtkFloatArray>::New();
+      normals->SetName("Normals");
+      normals->SetNumberOfComponents(3);
+      break;
+    case Field::Color:
+      hasColor = true;
+      colorCount = 0;
+      break;
+    default:
+      break;
+    }
+  }
+
+  void addFloat(Field field, double value) {
+    switch (field) {
+    case Field::Vertices:
+      vertices->InsertNextValue(static_cast<float>(value));
+      break;
+    case Field::Normals:
+      normals->InsertNextValue(static_cast<float>(value));
+      break;
+    case Field::Color:
+      if (colorCount < color.size()) {
+        color[colorCount] = value;
+      }
+      ++colorCount;
+      break;
+    case Field::Indices:
+      if (std::trunc(value) != value || value < 0.0 ||
+          value > static_cast<double>(std::numeric_limits<vtkIdType>::max())) {
+        valid = false;
+      } else {
+        indices->InsertNextValue(static_cast<vtkIdType>(value));
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  void addInteger(Field field, int64_t value) {
+    if (field == Field::Indices) {
+      indices->InsertNextValue(static_cast<vtkIdType>(value));
+    } else {
+      addFloat(field, static_cast<double>(value));
+    }
+  }
+
+  void addUnsigned(Field field, uint64_t value) {
+    if (field != Field::Indices) {
+      addFloat(field, static_cast<double>(value));
+    } else if (value > static_cast<uint64_t>(std::numeric_limits<vtkIdType>::max())) {
+      valid = false;
+    } else {
+      indices->InsertNextValue(static_cast<vtkIdType>(value));
+    }
+  }
 
-vtkSmartPointer<vtkPolyData> parsePart(const json& part) {
-  try {
-    const auto& vertices = part["vertices"];
-    const auto& indices = part["indices"];
-    if (vertices.size() % 3u != 0u || indices.size() % 3u != 0u || vertices.empty() ||
-        indices.empty()) {
+  // A buffer reference in place of a number array. The target array is sized
+  // once and filled straight from the mapped or decoded bytes.
+  void loadBuffer(Field field, const BufferSpec& spec, BufferStore& store) {
+    begin(field);
+    const ComponentType type = componentType(spec.type);
+    const size_t size = componentSize(type);
+    std::string_view bytes;
+    if (size == 0 || !spec.hasCount || spec.uri.empty() || !store.bytes(spec.uri, bytes) ||
+        spec.byteOffset > bytes.size() || spec.count > (bytes.size() - spec.byteOffset) / size) {
+      valid = false;
+      return;
+    }
+    const char* src = bytes.data() + spec.byteOffset;
+    const auto count = static_cast<size_t>(spec.count);
+    switch (field) {
+    case Field::Vertices:
+      vertices->SetNumberOfValues(static_cast<vtkIdType>(count));
+      convertBuffer(type, src, count, vertices->GetPointer(0));
+      break;
+    case Field::Normals:
+      normals->SetNumberOfValues(static_cast<vtkIdType>(count));
+      convertBuffer(type, src, count, normals->GetPointer(0));
+      break;
+    case Field::Indices:
+      if (!isIntegral(type)) {
+        valid = false;
+        return;
+      }
+      indices->SetNumberOfValues(static_cast<vtkIdType>(count));
+      convertBuffer(type, src, count, indices->GetPointer(0));
+      break;
+    default:
+      valid = false;
+      break;
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> build() const {
+    const vtkIdType vertexValues = vertices->GetNumberOfValues();
+    const vtkIdType indexValues = indices->GetNumberOfValues();
+    if (!valid || vertexValues == 0 || indexValues == 0 || vertexValues % 3 != 0 ||
+        indexValues % 3 != 0) {
       return nullptr;
     }
 
-    const size_t pointCount = vertices.size() / 3u;
-    if (pointCount > static_cast<size_t>(std::numeric_limits<vtkIdType>::max())) {
+    const vtkIdType pointCount = vertexValues / 3;
+    const vtkIdType* ids = indices->GetPointer(0);
+    if (!std::all_of(ids, ids + indexValues, [pointCount](vtkIdType id) {
+          return id >= 0 && id < pointCount;
+        })) {
       return nullptr;
     }
-    vtkNew<vtkPoints> points;
-    points->SetNumberOfPoints(static_cast<vtkIdType>(pointCount));
-    for (size_t i = 0; i < pointCount; ++i) {
-      const size_t i3 = i * 3u;
-      points->SetPoint(static_cast<vtkIdType>(i),
-                       vertices[i3].get<double>(),
-                       vertices[i3 + 1u].get<double>(),
-                       vertices[i3 + 2u].get<double>());
+    if (normals && normals->GetNumberOfValues() != vertexValues) {
+      return nullptr;
+    }
+    if (hasColor && colorCount < color.size()) {
+      return nullptr;
     }
 
-    vtkNew<vtkCellArray> triangles;
-    for (size_t i = 0; i < indices.size(); i += 3u) {
-      vtkIdType triangle[3] = {indices[i].get<vtkIdType>(),
-                               indices[i + 1u].get<vtkIdType>(),
-                               indices[i + 2u].get<vtkIdType>()};
-      if (triangle[0] < 0 || triangle[1] < 0 || triangle[2] < 0 ||
-          triangle[0] >= static_cast<vtkIdType>(pointCount) ||
-          triangle[1] >= static_cast<vtkIdType>(pointCount) ||
-          triangle[2] >= static_cast<vtkIdType>(pointCount)) {
-        return nullptr;
-      }
-      triangles->InsertNextCell(3, triangle);
+    vtkNew<vtkPoints> points;
+    points->SetData(vertices);
+
+    const vtkIdType triangleCount = indexValues / 3;
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfValues(triangleCount + 1);
+    vtkIdType* offset = offsets->GetPointer(0);
+    for (vtkIdType i = 0; i <= triangleCount; ++i) {
+      offset[i] = i * 3;
     }
+    vtkNew<vtkCellArray> triangles;
+    triangles->SetData(offsets, indices);
 
-    vtkNew<vtkPolyData> poly;
+    auto poly = vtkSmartPointer<vtkPolyData>::New();
     poly->SetPoints(points);
     poly->SetPolys(triangles);
 
-    const std::string name = partName(part);
     if (!name.empty()) {
       vtkNew<vtkStringArray> nameArray;
       nameArray->SetName("vv_part_name");
       nameArray->InsertNextValue(name);
       poly->GetFieldData()->AddArray(nameArray);
     }
+    if (normals) {
+      poly->GetPointData()->SetNormals(normals);
+      poly->GetPointData()->AddArray(normals);
+    }
+    if (hasColor) {
+      vtkNew<vtkFloatArray> colorArray;
+      colorArray->SetName("vv_part_color");
+      colorArray->SetNumberOfComponents(3);
+      colorArray->InsertNextTuple3(color[0], color[1], color[2]);
+      poly->GetFieldData()->AddArray(colorArray);
+    }
+    return poly;
+  }
+};
 
-    if (!addNormals(poly, part, pointCount)) {
-      return nullptr;
+// ---------------------------------------------------------------------------
+// SAX handler
+//
+// Accepts the three layouts the viewer has always read: a single part object,
+// an array of parts, and an object whose "surface" array holds the parts. A
+// root object that is itself a part wins over its "surface"; non-part entries
+// in a part list are skipped. With a parser given, the parse is aborted once
+// that parser's load is cancelled (checked every kCancelCheckValues numbers).
+class MeshSax : public nlohmann::json_sax<json> {
+public:
+  explicit MeshSax(BufferStore& buffers, const MeshParser* parser = nullptr)
+      : buffers_(buffers), parser_(parser) {
+  }
+
+  // Whether the document has one of the mesh layouts (even if some parts in it
+  // turn out to be malformed).
+  bool recognised() const {
+    if (root_.isMeshPart()) {
+      return true;
     }
-    if (!addColor(poly, part)) {
-      return nullptr;
+    return listSeen_ && listLength_ > 0 && listParts_ == listLength_;
+  }
+
+  std::vector<vtkSmartPointer<vtkDataSet>> takeMeshes() {
+    if (root_.isMeshPart()) {
+      std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+      if (auto poly = root_.build()) {
+        meshes.push_back(poly);
+      }
+      return meshes;
     }
+    return std::move(listMeshes_);
+  }
 
-    return poly;
-  } catch (const json::exception&) {
-    return nullptr;
+  const std::string& error() const {
+    return error_;
   }
-}
 
-} // namespace
+  bool null() override {
+    return scalar();
+  }
+  bool boolean(bool /*value*/) override {
+    return scalar();
+  }
+  bool number_integer(number_integer_t value) override {
+    if (inNumbers()) {
+      current().part->addInteger(stack_.back().field, value);
+      return keepGoing();
+    }
+    if (inBuffer()) {
+      bufferNumber(value < 0 ? 0 : static_cast<uint64_t>(value), value < 0);
+      return true;
+    }
+    return scalar();
+  }
+  bool number_unsigned(number_unsigned_t value) override {
+    if (inNumbers()) {
+      current().part->addUnsigned(stack_.back().field, value);
+      return keepGoing();
+    }
+    if (inBuffer()) {
+      bufferNumber(value, false);
+      return true;
+    }
+    return scalar();
+  }
+  bool number_float(number_float_t value, const string_t& /*text*/) override {
+    if (inNumbers()) {
+      current().part->addFloat(stack_.back().field, value);
+      return keepGoing();
+    }
+    if (inBuffer()) {
+      const bool integral = value >= 0.0 && std::trunc(value) == value &&
+                            value < static_cast<double>(std::numeric_limits<uint64_t>::max());
+      bufferNumber(integral ? static_cast<uint64_t>(value) : 0, !integral);
+      return true;
+    }
+    return scalar();
+  }
+  bool string(string_t& value) override {
+    if (skipDepth_ > 0) {
+      return true;
+    }
+    if (inBuffer()) {
+      if (key_ == "uri") {
+        buffer_.uri = std::move(value);
+      } else if (key_ == "type") {
+        buffer_.type = std::move(value);
+      }
+      return true;
+    }
+    if (inPart() && pendingField_ == Field::Name) {
+      current().part->name = std::move(value);
+    }
+    return scalar();
+  }
+  bool binary(binary_t& /*value*/) override {
+    return scalar();
+  }
 
-JsonMeshParser::~JsonMeshParser() = default;
+  bool start_object(std::size_t /*elements*/) override {
+    if (skipDepth_ > 0) {
+      ++skipDepth_;
+      return true;
+    }
+    if (stack_.empty()) {
+      root_.reset();
+      stack_.push_back({Frame::Part, Field::None, &root_});
+      return true;
+    }
+    if (inParts()) {
+      item_.reset();
+      stack_.push_back({Frame::Part, Field::None, &item_});
+      return true;
+    }
+    if (inPart() && isNumberField(pendingField_) && pendingField_ != Field::Color) {
+      buffer_ = BufferSpec();
+      key_.clear();
+      stack_.push_back({Frame::Buffer, pendingField_, current().part});
+      pendingField_ = Field::None;
+      return true;
+    }
+    invalidateNumbers();
+    pendingField_ = Field::None;
+    skipDepth_ = 1;
+    return true;
+  }
 
-std::vector<vtkSmartPointer<vtkDataSet>> JsonMeshParser::parse(const std::string& filename) {
-  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    return meshes;
+  bool key(string_t& name) override {
+    if (skipDepth_ > 0) {
+      return true;
+    }
+    if (inPart()) {
+      pendingField_ = fieldForKey(name);
+      if (pendingField_ == Field::Surface && current().part != &root_) {
+        pendingField_ = Field::None;
+      }
+    } else if (inBuffer()) {
+      key_ = std::move(name);
+    }
+    return true;
   }
 
-  json root;
-  try {
-    file >> root;
-  } catch (const json::exception& e) {
-    std::cerr << "Failed to read JSON mesh: " << filename << ": " << e.what() << '\n';
-    return meshes;
+  bool end_object() override {
+    if (skipDepth_ > 0) {
+      --skipDepth_;
+      return true;
+    }
+    const Entry entry = stack_.back();
+    stack_.pop_back();
+    if (entry.frame == Frame::Buffer) {
+      entry.part->loadBuffer(entry.field, buffer_, buffers_);
+    } else if (entry.part == &item_) {
+      finishListItem();
+    }
+    return true;
   }
 
-  if (isMeshPart(root)) {
-    auto poly = parsePart(root);
-    if (poly) {
-      meshes.push_back(poly);
+  bool start_array(std::size_t /*elements*/) override {
+    if (skipDepth_ > 0) {
+      ++skipDepth_;
+      return true;
     }
-    return meshes;
+    if (stack_.empty() || (inPart() && pendingField_ == Field::Surface)) {
+      listSeen_ = true;
+      listLength_ = 0;
+      listParts_ = 0;
+      listMeshes_.clear();
+      stack_.push_back({Frame::Parts, Field::None, nullptr});
+      pendingField_ = Field::None;
+      return true;
+    }
+    if (inParts()) {
+      ++listLength_;
+    } else if (inPart() && isNumberField(pendingField_)) {
+      current().part->begin(pendingField_);
+      stack_.push_back({Frame::Numbers, pendingField_, current().part});
+      pendingField_ = Field::None;
+      return true;
+    }
+    invalidateNumbers();
+    pendingField_ = Field::None;
+    skipDepth_ = 1;
+    return true;
   }
 
-  const json* parts = meshPartArray(root);
-  if (!parts) {
-    return meshes;
+  bool end_array() override {
+    if (skipDepth_ > 0) {
+      --skipDepth_;
+      return true;
+    }
+    stack_.pop_back();
+    return true;
+  }
+
+  bool parse_error(std::size_t /*position*/,
+                   const std::string& /*token*/,
+                   const nlohmann::detail::exception& e) override {
+    error_ = e.what();
+    return false;
+  }
+
+private:
+  enum class Frame { Parts, Part, Numbers, Buffer };
+
+  struct Entry {
+    Frame frame;
+    Field field;
+    PartBuilder* part;
+  };
+
+  static bool isNumberField(Field field) {
+    return field == Field::Vertices || field == Field::Indices || field == Field::Normals ||
+           field == Field::Color;
   }
 
-  for (const auto& part : *parts) {
-    if (!isMeshPart(part)) {
-      continue;
+  const Entry& current() const {
+    return stack_.back();
+  }
+  bool inParts() const {
+    return !stack_.empty() && stack_.back().frame == Frame::Parts;
+  }
+  bool inPart() const {
+    return !stack_.empty() && stack_.back().frame == Frame::Part;
+  }
+  bool inNumbers() const {
+    return skipDepth_ == 0 && !stack_.empty() && stack_.back().frame == Frame::Numbers;
+  }
+  bool inBuffer() const {
+    return skipDepth_ == 0 && !stack_.empty() && stack_.back().frame == Frame::Buffer;
+  }
+
+  // A non-number inside a number array makes the part malformed.
+  void invalidateNumbers() {
+    if (!stack_.empty() && stack_.back().frame == Frame::Numbers) {
+      stack_.back().part->valid = false;
+    }
+  }
+
+  bool scalar() {
+    if (skipDepth_ > 0) {
+      return true;
+    }
+    invalidateNumbers();
+    if (inParts()) {
+      ++listLength_;
     }
-    auto poly = parsePart(part);
-    if (poly) {
-      meshes.push_back(poly);
+    pendingField_ = Field::None;
+    return true;
+  }
+
+  void bufferNumber(uint64_t value, bool invalid) {
+    if (key_ == "byteOffset") {
+      buffer_.byteOffset = value;
+    } else if (key_ == "count") {
+      buffer_.count = value;
+      buffer_.hasCount = true;
+    } else {
+      return;
+    }
+    if (invalid) {
+      stack_.back().part->valid = false;
+    }
+  }
+
+  void finishListItem() {
+    ++listLength_;
+    if (item_.isMeshPart()) {
+      ++listParts_;
+      if (auto poly = item_.build()) {
+        listMeshes_.push_back(poly);
+      }
     }
+    item_.reset();
+  }
+
+  // False (abort) once the load is cancelled; polled every kCancelCheckValues
+  // array numbers.
+  bool keepGoing() {
+    static constexpr size_t kCancelCheckValues = size_t{1} << 20;
+    return ++values_ % kCancelCheckValues != 0 || !parser_ || !parser_->cancelled();
+  }
+
+  BufferStore& buffers_;
+  const MeshParser* parser_ = nullptr;
+  size_t values_ = 0;
+  std::vector<Entry> stack_;
+  int skipDepth_ = 0;
+  Field pendingField_ = Field::None;
+  std::string key_;
+  BufferSpec buffer_;
+
+  PartBuilder root_;
+  PartBuilder item_;
+  bool listSeen_ = false;
+  size_t listLength_ = 0;
+  size_t listParts_ = 0;
+  std::vector<vtkSmartPointer<vtkDataSet>> listMeshes_;
+  std::string error_;
+};
+
+// Stream `path` through MeshSax. Returns false when the file cannot be read or
+// is not valid JSON (`error` is set then) or when `parser`'s load is cancelled.
+// `bufferFiles` receives the external buffer files the document referenced.
+bool readMeshDocument(const std::string& path,
+                      const MeshParser* parser,
+                      bool& recognised,
+                      std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                      std::vector<std::string>& bufferFiles,
+                      std::string& error) {
+  ByteSource file;
+  if (parser ? !parser->openInput(file, path) : !file.open(path)) {
+    return false;
+  }
+  BufferStore buffers(std::filesystem::path(path).parent_path());
+  MeshSax sax(buffers, parser);
+  const bool parsed = json::sax_parse(file.begin(), file.end(), &sax);
+  bufferFiles = buffers.paths();
+  if (!parsed) {
+    error = sax.error();
+    return false;
+  }
+  recognised = sax.recognised();
+  meshes = sax.takeMeshes();
+  return true;
+}
+
+} // namespace
+
+struct JsonMeshParser::Document {
+  std::string path;
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+  std::vector<std::string> bufferFiles;
+};
+
+JsonMeshParser::JsonMeshParser() = default;
+JsonMeshParser::~JsonMeshParser() = default;
+
+std::string JsonMeshParser::cacheTag() const {
+  return "json/3";
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> JsonMeshParser::parse(const std::string& filename) {
+  if (sniffed_ && sniffed_->path == filename) {
+    std::vector<vtkSmartPointer<vtkDataSet>> meshes = std::move(sniffed_->meshes);
+    bufferFiles_ = std::move(sniffed_->bufferFiles);
+    sniffed_.reset();
+    return meshes;
+  }
+
+  bool recognised = false;
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+  std::string error;
+  if (!readMeshDocument(filename, this, recognised, meshes, bufferFiles_, error) &&
+      !error.empty()) {
+    std::cerr << "Failed to read JSON mesh: " << filename << ": " << error << '\n';
   }
   return meshes;
 }
 
-bool JsonMeshParser::canParse(const std::string& filename) {
-  const std::string header = readHeader(filename, 64);
+bool JsonMeshParser::canParse(const FileHead& head) {
+  sniffed_.reset();
+  const std::string_view header = head.prefix(64);
   const size_t first = header.find_first_not_of(" \t\r\n");
-  if (first == std::string::npos || (header[first] != '[' && header[first] != '{')) {
+  if (first == std::string_view::npos || (header[first] != '[' && header[first] != '{')) {
     return false;
   }
-
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    return false;
+  if (headHasMeshKeys(head.bytes)) {
+    return true;
   }
 
-  try {
-    json root;
-    file >> root;
-    return looksLikeJsonMesh(root);
-  } catch (const json::exception&) {
+  // Mesh keys not in the head (e.g. a long leading "name"): decide on the whole
+  // document, and keep the meshes it produced for parse().
+  auto document = std::make_unique<Document>();
+  bool recognised = false;
+  std::string error;
+  if (!readMeshDocument(
+          head.path, nullptr, recognised, document->meshes, document->bufferFiles, error) ||
+      !recognised) {
     return false;
   }
+  document->path = head.path;
+  sniffed_ = std::move(document);
+  return true;
 }
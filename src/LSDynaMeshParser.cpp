@@ -1,38 +1,47 @@
 #include "LSDynaMeshParser.h"
 
-#include "mesh_utils.h"
+#include "ByteSource.h"
+#include "cache_files.h"
+#include "lsdyna_cells.h"
+#include "parallel_utils.h"
+#include "text_scan.h"
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
+#include <vtkCellArray.h>
 #include <vtkCellType.h>
 #include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkNew.h>
 #include <vtkPoints.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtkUnstructuredGrid.h>
 
 namespace {
 
-std::string trim(const std::string& s) {
-  size_t a = s.find_first_not_of(" \t\r\n");
-  if (a == std::string::npos)
+std::string_view trim(std::string_view s) {
+  const size_t a = s.find_first_not_of(" \t\r\n");
+  if (a == std::string_view::npos)
     return {};
   return s.substr(a, s.find_last_not_of(" \t\r\n") - a + 1);
 }
 
-bool startsWith(const std::string& s, const std::string& prefix) {
+bool startsWith(std::string_view s, std::string_view prefix) {
   return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
 }
 
@@ -58,45 +67,153 @@ inline int parseInt(const char* p, size_t w = 8) {
   return static_cast<int>(std::strtol(buf, nullptr, 10));
 }
 
-int parseIntField(const std::string& s, size_t pos, size_t w) {
+int parseIntField(std::string_view s, size_t pos, size_t w) {
   if (pos >= s.size())
     return 0;
   const size_t n = std::min(w, s.size() - pos);
   return parseInt(s.data() + pos, n);
 }
 
-double parseDoubleField(const std::string& s, size_t pos, size_t w) {
+double parseDoubleField(std::string_view s, size_t pos, size_t w) {
   if (pos >= s.size())
     return 0.0;
   const size_t n = std::min(w, s.size() - pos);
   return parseDouble(s.data() + pos, n);
 }
 
-bool parseTwoInts(const std::string& line, int& a, int& b) {
-  std::istringstream iss(line);
-  if (!(iss >> a >> b))
-    return false;
-  return true;
+// Free-format fallback: numbers separated by blanks or commas. The line is
+// copied into a NUL-terminated stack buffer so strtol/strtod can run on it
+// without allocating (the old istringstream did one allocation per line).
+class LineTokens {
+public:
+  explicit LineTokens(std::string_view line) {
+    const size_t n = std::min(line.size(), sizeof(buf_) - 1);
+    std::memcpy(buf_, line.data(), n);
+    buf_[n] = '\0';
+  }
+
+  bool nextInt(int& out) {
+    skipSeparators();
+    char* endp = nullptr;
+    const long v = std::strtol(p_, &endp, 10);
+    if (endp == p_)
+      return false;
+    p_ = endp;
+    out = static_cast<int>(v);
+    return true;
+  }
+
+  bool nextDouble(double& out) {
+    skipSeparators();
+    char* endp = nullptr;
+    const double v = std::strtod(p_, &endp);
+    if (endp == p_)
+      return false;
+    p_ = endp;
+    out = v;
+    return true;
+  }
+
+private:
+  void skipSeparators() {
+    while (*p_ == ' ' || *p_ == '\t' || *p_ == ',' || *p_ == '\r')
+      ++p_;
+  }
+
+  char buf_[512];
+  const char* p_ = buf_;
+};
+
+bool parseTwoInts(std::string_view line, int& a, int& b) {
+  LineTokens tokens(line);
+  return tokens.nextInt(a) && tokens.nextInt(b);
 }
 
-bool parseFirstNInts(const std::string& line, int n, int* out) {
-  std::istringstream iss(line);
+bool parseFirstNInts(std::string_view line, int n, int* out) {
+  LineTokens tokens(line);
   for (int i = 0; i < n; ++i) {
-    if (!(iss >> out[i]))
+    if (!tokens.nextInt(out[i]))
       return false;
   }
   return true;
 }
 
+bool isKeywordLine(std::string_view line) {
+  const std::string_view t = trim(line);
+  return !t.empty() && t[0] == '*';
+}
+
+bool isDataLine(std::string_view line) {
+  const std::string_view t = trim(line);
+  return !t.empty() && t[0] != '$' && t[0] != '*';
+}
+
 struct RawNode {
   int nid;
   double x, y, z;
 };
 
-// Tet only: pid + 4 node ids (first 4 from solid = degenerate hex)
-struct Tet {
-  int pid;
-  int n[4];
+// Cell kinds built from *ELEMENT_SOLID / _SHELL / _BEAM cards.
+enum CellKind : size_t {
+  kLine,
+  kTriangle,
+  kQuad,
+  kTetra,
+  kPyramid,
+  kWedge,
+  kHexahedron,
+  kQuadraticTetra,
+  kCellKindCount
+};
+
+constexpr size_t kNodesPerCell[kCellKindCount] = {2, 3, 4, 4, 5, 6, 8, 10};
+constexpr int kVtkCellType[kCellKindCount] = {VTK_LINE,
+                                              VTK_TRIANGLE,
+                                              VTK_QUAD,
+                                              VTK_TETRA,
+                                              VTK_PYRAMID,
+                                              VTK_WEDGE,
+                                              VTK_HEXAHEDRON,
+                                              VTK_QUADRATIC_TETRA};
+constexpr size_t kMaxCellNodes = 10;
+
+// All elements of one kind, structure-of-arrays: element i belongs to pids[i]
+// and uses the kNodesPerCell[kind] node ids starting at nodes[i * n].
+struct ElementBlock {
+  std::vector<int> pids;
+  std::vector<int> nodes;
+};
+
+struct ElementStore {
+  std::array<ElementBlock, kCellKindCount> blocks;
+
+  void add(CellKind kind, int pid, const int* nodeIds) {
+    ElementBlock& block = blocks[kind];
+    block.pids.push_back(pid);
+    block.nodes.insert(block.nodes.end(), nodeIds, nodeIds + kNodesPerCell[kind]);
+  }
+
+  size_t size() const {
+    size_t total = 0;
+    for (const auto& block : blocks)
+      total += block.pids.size();
+    return total;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // Move `other`'s elements to the end of this store, kind by kind.
+  void append(ElementStore& other) {
+    for (size_t kind = 0; kind < kCellKindCount; ++kind) {
+      ElementBlock& to = blocks[kind];
+      ElementBlock& from = other.blocks[kind];
+      to.pids.insert(to.pids.end(), from.pids.begin(), from.pids.end());
+      to.nodes.insert(to.nodes.end(), from.nodes.begin(), from.nodes.end());
+      from = ElementBlock();
+    }
+  }
 };
 
 struct PartInfo {
@@ -104,9 +221,16 @@ struct PartInfo {
   std::string name;
 };
 
+// Everything collected from a deck and its includes, in deck order.
+struct DeckData {
+  std::vector<RawNode> nodes;
+  ElementStore elems;
+  std::vector<PartInfo> parts;
+};
+
 // Parse *NODE lines: fixed 8-char nid, 16-char x,y,z
-void parseNodeLine(const std::string& line, std::vector<RawNode>& out) {
-  const std::string t = trim(line);
+void parseNodeLine(std::string_view line, std::vector<RawNode>& out) {
+  const std::string_view t = trim(line);
   if (t.empty() || t[0] == '$')
     return;
 
@@ -119,8 +243,9 @@ void parseNodeLine(const std::string& line, std::vector<RawNode>& out) {
   n.z = parseDoubleField(line, 40, 16);
 
   if (n.nid == 0 || (n.x == 0.0 && n.y == 0.0 && n.z == 0.0)) {
-    std::istringstream iss(line);
-    if (!(iss >> n.nid >> n.x >> n.y >> n.z))
+    LineTokens tokens(line);
+    if (!(tokens.nextInt(n.nid) && tokens.nextDouble(n.x) && tokens.nextDouble(n.y) &&
+          tokens.nextDouble(n.z)))
       return;
   }
   if (n.nid == 0)
@@ -128,77 +253,361 @@ void parseNodeLine(const std::string& line, std::vector<RawNode>& out) {
   out.push_back(n);
 }
 
-// Parse one *ELEMENT_SOLID* block: eid, pid then 4+ node ids. Use first 4 only (tet).
-// Skip $# comment lines. If we stop on a * line, put it in nextLine for caller to reuse.
-bool parseSolidBlock(std::ifstream& f,
-                     bool /*ortho*/,
-                     std::vector<Tet>& out,
-                     std::string& nextLine) {
-  std::string line1, line2;
-  while (std::getline(f, line1)) {
-    const std::string t1 = trim(line1);
-    if (t1.empty() || t1[0] == '$')
-      continue;
-    if (t1[0] == '*') {
-      nextLine = line1;
-      return true;
+// True if every 8-column field of `line` holds at most one number, i.e. the
+// line is a fixed-width card rather than blank- or comma-separated free format.
+bool isFixedWidthCard(std::string_view line) {
+  if (line.find(',') != std::string_view::npos)
+    return false;
+  for (size_t pos = 0; pos < line.size(); pos += 8) {
+    if (trim(line.substr(pos, 8)).find_first_of(" \t") != std::string_view::npos)
+      return false;
+  }
+  return true;
+}
+
+// Integer fields of an element card (fixed 8-column or free format). Missing
+// fields are zero; returns the number of fields present on the line.
+int readIntFields(std::string_view line, int* out, int maxFields) {
+  std::fill(out, out + maxFields, 0);
+  if (isFixedWidthCard(line)) {
+    int count = 0;
+    for (int i = 0; i < maxFields; ++i) {
+      const size_t pos = static_cast<size_t>(i) * 8;
+      if (pos >= line.size())
+        break;
+      out[i] = parseIntField(line, pos, 8);
+      if (!trim(line.substr(pos, 8)).empty())
+        count = i + 1;
     }
-    int eid = 0;
-    int pid = 0;
-    if (!parseTwoInts(line1, eid, pid))
-      continue;
-    if (eid == 0)
-      continue;
+    return count;
+  }
+  LineTokens tokens(line);
+  int count = 0;
+  while (count < maxFields && tokens.nextInt(out[count]))
+    ++count;
+  return count;
+}
 
-    while (std::getline(f, line2)) {
-      const std::string t2 = trim(line2);
-      if (t2.empty() || t2[0] == '$')
+void addSolid(int pid, int* n, ElementStore& out) {
+  int cell[8];
+  int count = 0;
+  switch (lsdynaSolidCell(n, cell, count)) {
+  case VTK_TETRA:
+    out.add(kTetra, pid, cell);
+    break;
+  case VTK_PYRAMID:
+    out.add(kPyramid, pid, cell);
+    break;
+  case VTK_WEDGE:
+    out.add(kWedge, pid, cell);
+    break;
+  case VTK_HEXAHEDRON:
+    out.add(kHexahedron, pid, cell);
+    break;
+  default:
+    break;
+  }
+}
+
+enum class ElementFamily { Solid, Shell, Beam };
+
+// Card layout of one *ELEMENT_ keyword block.
+struct ElementSection {
+  ElementFamily family = ElementFamily::Solid;
+  bool tet10 = false; // *ELEMENT_SOLID_TET10: ten node ids per element
+  int extraLines = 0; // option cards after the node ids (thickness, offsets, ...)
+};
+
+// Recognise the element keywords we build cells for. Options that only add
+// per-element cards (thickness, orientation, ...) are skipped over; keywords
+// with a different card structure (e.g. _COMPOSITE) are reported and ignored.
+bool elementSectionFor(std::string_view keyword, ElementSection& section) {
+  static const std::pair<std::string_view, ElementFamily> kFamilies[] = {
+      {"*ELEMENT_SOLID", ElementFamily::Solid},
+      {"*ELEMENT_SHELL", ElementFamily::Shell},
+      {"*ELEMENT_BEAM", ElementFamily::Beam},
+  };
+
+  section = ElementSection{};
+  std::string_view options;
+  bool known = false;
+  for (const auto& [prefix, family] : kFamilies) {
+    if (startsWith(keyword, prefix)) {
+      section.family = family;
+      options = keyword.substr(prefix.size());
+      known = true;
+      break;
+    }
+  }
+  if (!known || (!options.empty() && options[0] != '_'))
+    return false;
+
+  bool thicknessCard = false;
+  while (!options.empty()) {
+    options.remove_prefix(1);
+    const size_t next = options.find('_');
+    const std::string_view opt = options.substr(0, next);
+    options = (next == std::string_view::npos) ? std::string_view{} : options.substr(next);
+
+    switch (section.family) {
+    case ElementFamily::Solid:
+      if (opt == "TET10") {
+        section.tet10 = true;
         continue;
-      if (t2[0] == '*') {
-        nextLine = line2;
-        return true;
       }
-      Tet tet;
-      tet.pid = pid;
-      tet.n[0] = parseIntField(line2, 0, 8);
-      tet.n[1] = parseIntField(line2, 8, 8);
-      tet.n[2] = parseIntField(line2, 16, 8);
-      tet.n[3] = parseIntField(line2, 24, 8);
-      if (!(tet.n[0] && tet.n[1] && tet.n[2] && tet.n[3])) {
-        int n4[4] = {0, 0, 0, 0};
-        if (parseFirstNInts(line2, 4, n4)) {
-          tet.n[0] = n4[0];
-          tet.n[1] = n4[1];
-          tet.n[2] = n4[2];
-          tet.n[3] = n4[3];
-        }
+      if (opt == "ORTHO") {
+        section.extraLines += 2;
+        continue;
+      }
+      break;
+    case ElementFamily::Shell:
+      if (opt == "THICKNESS" || opt == "BETA" || opt == "MCID") {
+        thicknessCard = true;
+        continue;
+      }
+      if (opt == "OFFSET" || opt == "DOF") {
+        section.extraLines += 1;
+        continue;
+      }
+      break;
+    case ElementFamily::Beam:
+      if (opt == "THICKNESS" || opt == "SCALAR" || opt == "SCALR" || opt == "SECTION") {
+        thicknessCard = true;
+        continue;
+      }
+      if (opt == "PID" || opt == "OFFSET" || opt == "ORIENTATION" || opt == "WARPAGE") {
+        section.extraLines += 1;
+        continue;
       }
-      if (tet.n[0] && tet.n[1] && tet.n[2] && tet.n[3])
-        out.push_back(tet);
       break;
     }
+    std::cerr << "LSDyna: skipping unsupported keyword " << keyword << "\n";
+    return false;
   }
-  return false;
+  if (thicknessCard)
+    section.extraLines += 1;
+  return true;
 }
 
-bool parsePartBlock(std::ifstream& f, std::vector<PartInfo>& out, std::string& nextLine) {
-  std::string line;
-  std::string name;
-  bool haveName = false;
+// Turns the data lines of one element block into cells. Fed one data line at a
+// time so the streamed and the chunked reader share the exact same card logic.
+// Solid cards come in two flavours: "eid pid n1..n8" on one line, or an
+// "eid pid" line followed by the node ids; shells and beams are one line.
+class ElementCardParser {
+public:
+  explicit ElementCardParser(const ElementSection& section) : section_(section) {}
 
-  while (std::getline(f, line)) {
-    const std::string t = trim(line);
-    if (t.empty() || t[0] == '$')
-      continue;
-    if (t[0] == '*') {
-      nextLine = line;
-      return true;
+  void feed(std::string_view line, ElementStore& out) {
+    if (expect_ == Expect::OptionCards) {
+      if (--skipLines_ == 0)
+        expect_ = Expect::Header;
+      return;
+    }
+
+    int fields[kMaxCellNodes] = {};
+    if (expect_ == Expect::Nodes) {
+      const int wanted = nodesPerCard() - nodeCount_;
+      readIntFields(line, fields, wanted);
+      std::copy(fields, fields + wanted, nodes_ + nodeCount_);
+      nodeCount_ += wanted;
+      finishCard(out);
+      return;
+    }
+
+    const int count = readIntFields(line, fields, static_cast<int>(kMaxCellNodes));
+    if (count < 1 || fields[0] == 0)
+      return;
+    pid_ = fields[1];
+    std::fill(std::begin(nodes_), std::end(nodes_), 0);
+    if (section_.family == ElementFamily::Solid && count <= 2) {
+      nodeCount_ = 0;
+      expect_ = Expect::Nodes;
+      return;
+    }
+    std::copy(fields + 2, fields + kMaxCellNodes, nodes_);
+    nodeCount_ = static_cast<int>(kMaxCellNodes) - 2;
+    if (nodeCount_ < nodesPerCard()) {
+      // TET10 in the one-line layout: n9, n10 follow on their own line.
+      expect_ = Expect::Nodes;
+      return;
+    }
+    finishCard(out);
+  }
+
+private:
+  enum class Expect { Header, Nodes, OptionCards };
+
+  int nodesPerCard() const {
+    return section_.tet10 ? 10 : 8;
+  }
+
+  void finishCard(ElementStore& out) {
+    emit(out);
+    skipLines_ = section_.extraLines;
+    expect_ = (skipLines_ > 0) ? Expect::OptionCards : Expect::Header;
+  }
+
+  void emit(ElementStore& out) {
+    const int* n = nodes_;
+    switch (section_.family) {
+    case ElementFamily::Solid:
+      if (section_.tet10 && std::all_of(n, n + 10, [](int id) { return id != 0; })) {
+        out.add(kQuadraticTetra, pid_, n);
+      } else {
+        addSolid(pid_, nodes_, out);
+      }
+      break;
+    case ElementFamily::Shell:
+      // n5..n8 of 8-node shells are mid-side nodes; only the corners are drawn.
+      if (!(n[0] && n[1] && n[2]))
+        break;
+      if (n[3] == 0 || n[3] == n[2]) {
+        out.add(kTriangle, pid_, n);
+      } else {
+        out.add(kQuad, pid_, n);
+      }
+      break;
+    case ElementFamily::Beam:
+      // n3 is the orientation node, not part of the beam.
+      if (n[0] && n[1] && n[0] != n[1])
+        out.add(kLine, pid_, n);
+      break;
     }
+  }
+
+  ElementSection section_;
+  Expect expect_ = Expect::Header;
+  int pid_ = 0;
+  int nodes_[kMaxCellNodes] = {};
+  int nodeCount_ = 0;
+  int skipLines_ = 0;
+};
+
+// True if `line` can only be the first ("eid pid") line of a two-line solid
+// card: at most two numbers and nothing past column 16. A node line always
+// carries at least four ids, so it never passes; a chunk may safely start here.
+bool isSolidCardStart(std::string_view line) {
+  const std::string_view t = trim(line);
+  if (t.empty() || t[0] == '$' || t[0] == '*')
+    return false;
+  if (t.data() + t.size() > line.data() + 16)
+    return false;
+  int tokens = 0;
+  bool inToken = false;
+  for (char c : t) {
+    const bool sep = (c == ' ' || c == '\t' || c == ',');
+    if (!sep && !inToken)
+      ++tokens;
+    inToken = !sep;
+  }
+  return tokens <= 2;
+}
+
+// First byte of the next keyword line at or after `from` (or `end`).
+const char* findSectionEnd(const char* from, const char* end) {
+  LineReader lines(from, end);
+  std::string_view line;
+  const char* lineStart = lines.position();
+  while (lines.next(line)) {
+    if (isKeywordLine(line))
+      return lineStart;
+    lineStart = lines.position();
+  }
+  return end;
+}
+
+template <typename T> void appendChunks(std::vector<std::vector<T>>& chunks, std::vector<T>& out) {
+  size_t total = out.size();
+  for (const auto& chunk : chunks)
+    total += chunk.size();
+  out.reserve(total);
+  for (auto& chunk : chunks) {
+    out.insert(out.end(), chunk.begin(), chunk.end());
+    std::vector<T>().swap(chunk);
+  }
+}
 
+// Parse the body of a *NODE section in parallel; results keep deck order so a
+// later definition of the same NID still overrides an earlier one. Chunks
+// report their bytes to the parser's progress and are skipped once the load is
+// cancelled.
+void parseNodeSection(const MeshParser& parser,
+                      const char* begin,
+                      const char* end,
+                      std::vector<RawNode>& out) {
+  const auto ranges = splitSection(begin, end, chunkCountFor(begin, end), acceptAnyLine);
+  std::vector<std::vector<RawNode>> chunks(ranges.size());
+  parallelFor(ranges.size(), [&](size_t i) {
+    if (parser.cancelled())
+      return;
+    const auto [chunkBegin, chunkEnd] = ranges[i];
+    // ~60 bytes per fixed-width node line.
+    chunks[i].reserve(static_cast<size_t>(chunkEnd - chunkBegin) / 56);
+    LineReader lines(chunkBegin, chunkEnd);
+    std::string_view line;
+    while (lines.next(line))
+      parseNodeLine(line, chunks[i]);
+    parser.advance(static_cast<uint64_t>(chunkEnd - chunkBegin));
+  });
+  appendChunks(chunks, out);
+}
+
+// Line at which a chunk of `section` may start, or nullptr if cards span a
+// variable number of lines and the block has to be read in one piece.
+ChunkStartFn elementChunkStart(const ElementSection& section, const char* begin, const char* end) {
+  if (section.extraLines > 0 || section.tet10)
+    return nullptr;
+  if (section.family != ElementFamily::Solid)
+    return acceptAnyLine;
+
+  LineReader lines(begin, end);
+  std::string_view line;
+  while (lines.next(line)) {
+    if (isDataLine(line))
+      return isSolidCardStart(line) ? isSolidCardStart : acceptAnyLine;
+  }
+  return acceptAnyLine;
+}
+
+void parseElementSection(const MeshParser& parser,
+                         const char* begin,
+                         const char* end,
+                         const ElementSection& section,
+                         ElementStore& out) {
+  const auto isChunkStart = elementChunkStart(section, begin, end);
+  const auto ranges = isChunkStart
+                          ? splitSection(begin, end, chunkCountFor(begin, end), isChunkStart)
+                          : std::vector<std::pair<const char*, const char*>>{{begin, end}};
+  std::vector<ElementStore> chunks(ranges.size());
+  parallelFor(ranges.size(), [&](size_t i) {
+    if (parser.cancelled())
+      return;
+    const auto [chunkBegin, chunkEnd] = ranges[i];
+    ElementCardParser card(section);
+    LineReader lines(chunkBegin, chunkEnd);
+    std::string_view line;
+    while (lines.next(line)) {
+      if (isDataLine(line))
+        card.feed(line, chunks[i]);
+    }
+    parser.advance(static_cast<uint64_t>(chunkEnd - chunkBegin));
+  });
+  for (auto& chunk : chunks)
+    out.append(chunk);
+}
+
+// *PART: a title line, then a card whose first field is the PID.
+struct PartCardParser {
+  std::string name;
+  bool haveName = false;
+
+  // Returns true once the card is complete.
+  bool feed(std::string_view line, std::vector<PartInfo>& out) {
+    const std::string_view t = trim(line);
     if (!haveName) {
-      name = t;
+      name = std::string(t);
       haveName = true;
-      continue;
+      return false;
     }
 
     int pid = 0;
@@ -211,45 +620,125 @@ bool parsePartBlock(std::ifstream& f, std::vector<PartInfo>& out, std::string& n
       p.name = name;
       out.push_back(p);
     }
+    return true;
+  }
+};
+
+std::string includePath(std::string_view entry, const std::string& baseDir) {
+  return (entry[0] == '/') ? std::string(entry) : baseDir + "/" + std::string(entry);
+}
+
+// Record a file as merged. `visited` holds canonical paths so include cycles
+// (a.k → b.k → a.k) terminate and a file included twice is only used once.
+bool markVisited(const std::string& filepath, std::unordered_set<std::string>& visited) {
+  if (!visited.insert(canonicalPath(filepath)).second) {
+    std::cerr << "LSDyna: skipping already-included file " << filepath << "\n";
     return false;
   }
-  return false;
+  return true;
 }
 
-// Stream-parse one file; merge into nodes/elems/parts. Resolve *INCLUDE in place.
-// `visited` holds canonical paths of files already parsed so include cycles
-// (a.k → b.k → a.k) terminate instead of recursing forever.
-void parseFile(const std::string& filepath,
-               const std::string& baseDir,
-               std::vector<RawNode>& nodes,
-               std::vector<Tet>& elems,
-               std::vector<PartInfo>& parts,
-               std::unordered_set<std::string>& visited) {
-  std::error_code ec;
-  std::string canonical = std::filesystem::weakly_canonical(filepath, ec).string();
-  if (ec || canonical.empty()) {
-    canonical = filepath;
+// One deck file split at its *INCLUDE keywords: segments[i] holds the data
+// read before the i-th include block and includes[i] the files that block
+// names; the last segment has no include list after it.
+struct DeckFile {
+  std::vector<DeckData> segments = std::vector<DeckData>(1);
+  std::vector<std::vector<std::string>> includes;
+
+  DeckData& current() {
+    return segments.back();
   }
-  if (!visited.insert(canonical).second) {
-    std::cerr << "LSDyna: skipping already-included file " << filepath << "\n";
-    return;
+
+  void addIncludes(std::vector<std::string> paths) {
+    includes.push_back(std::move(paths));
+    segments.emplace_back();
   }
+};
 
-  std::ifstream f(filepath);
-  if (!f) {
-    std::cerr << "LSDyna: cannot open " << filepath << "\n";
-    return;
+// Mapped reader: walks keyword lines sequentially and hands the bulk sections
+// to the chunked parallel parsers. Stops once the load is cancelled.
+void parseMappedDeck(const MeshParser& parser,
+                     const ByteSource& file,
+                     const std::string& baseDir,
+                     DeckFile& deck) {
+  LineReader lines(file.begin(), file.end());
+  std::string_view line;
+  while (!parser.cancelled() && lines.next(line)) {
+    const std::string_view t = trim(line);
+    if (t.empty() || t[0] != '*')
+      continue;
+
+    if (t == "*INCLUDE") {
+      std::vector<std::string> incList;
+      const char* lineStart = lines.position();
+      while (lines.next(line)) {
+        const std::string_view entry = trim(line);
+        if (entry.empty() || entry[0] == '$') {
+          lineStart = lines.position();
+          continue;
+        }
+        if (entry[0] == '*') {
+          lines.seek(lineStart);
+          break;
+        }
+        incList.push_back(includePath(entry, baseDir));
+        lineStart = lines.position();
+      }
+      deck.addIncludes(std::move(incList));
+      continue;
+    }
+    if (t == "*NODE") {
+      const char* sectionEnd = findSectionEnd(lines.position(), file.end());
+      parseNodeSection(parser, lines.position(), sectionEnd, deck.current().nodes);
+      lines.seek(sectionEnd);
+      continue;
+    }
+    ElementSection section;
+    if (elementSectionFor(t, section)) {
+      const char* sectionEnd = findSectionEnd(lines.position(), file.end());
+      parseElementSection(
+          parser, lines.position(), sectionEnd, section, deck.current().elems);
+      lines.seek(sectionEnd);
+      continue;
+    }
+    if (t == "*PART") {
+      PartCardParser card;
+      const char* lineStart = lines.position();
+      while (lines.next(line)) {
+        const std::string_view entry = trim(line);
+        if (entry.empty() || entry[0] == '$') {
+          lineStart = lines.position();
+          continue;
+        }
+        if (entry[0] == '*') {
+          lines.seek(lineStart);
+          break;
+        }
+        if (card.feed(line, deck.current().parts))
+          break;
+        lineStart = lines.position();
+      }
+      continue;
+    }
   }
+}
 
+// Streamed reader: the original std::getline loop. Used when a file cannot be
+// mapped and as the baseline for benchmarks. Checks for cancellation between
+// keywords only.
+void parseStreamedDeck(const MeshParser& parser,
+                       std::ifstream& f,
+                       const std::string& baseDir,
+                       DeckFile& deck) {
   std::string line;
   bool reuseLine = false;
 
-  while (reuseLine || std::getline(f, line)) {
+  while (!parser.cancelled() && (reuseLine || std::getline(f, line))) {
     if (!reuseLine && line.empty())
       continue;
     reuseLine = false;
 
-    std::string t = trim(line);
+    std::string_view t = trim(line);
     if (t == "*INCLUDE") {
       std::vector<std::string> incList;
       while (std::getline(f, line)) {
@@ -260,10 +749,9 @@ void parseFile(const std::string& filepath,
           reuseLine = true;
           break;
         }
-        incList.push_back((t[0] == '/') ? t : baseDir + "/" + t);
+        incList.push_back(includePath(t, baseDir));
       }
-      for (const auto& inc : incList)
-        parseFile(inc, dirOf(inc), nodes, elems, parts, visited);
+      deck.addIncludes(std::move(incList));
       continue;
     }
     if (t == "*NODE") {
@@ -272,112 +760,385 @@ void parseFile(const std::string& filepath,
           reuseLine = true;
           break;
         }
-        parseNodeLine(line, nodes);
+        parseNodeLine(line, deck.current().nodes);
       }
       continue;
     }
-    if (startsWith(t, "*ELEMENT_SOLID")) {
-      bool ortho = t.find("ORTHO") != std::string::npos;
-      std::string next;
-      if (parseSolidBlock(f, ortho, elems, next)) {
-        line = std::move(next);
-        reuseLine = true;
+    ElementSection section;
+    if (elementSectionFor(t, section)) {
+      ElementCardParser card(section);
+      while (std::getline(f, line)) {
+        if (isKeywordLine(line)) {
+          reuseLine = true;
+          break;
+        }
+        if (isDataLine(line))
+          card.feed(line, deck.current().elems);
       }
       continue;
     }
     if (t == "*PART") {
-      std::string next;
-      if (parsePartBlock(f, parts, next)) {
-        line = std::move(next);
-        reuseLine = true;
+      PartCardParser card;
+      while (std::getline(f, line)) {
+        const std::string_view entry = trim(line);
+        if (entry.empty() || entry[0] == '$')
+          continue;
+        if (entry[0] == '*') {
+          reuseLine = true;
+          break;
+        }
+        if (card.feed(line, deck.current().parts))
+          break;
       }
       continue;
     }
   }
 }
 
+// Parse one file on its own; its *INCLUDE paths are collected, not followed.
+DeckFile parseDeckFile(const MeshParser& parser,
+                       const std::string& filepath,
+                       LSDynaMeshParser::ReadMode mode) {
+  DeckFile deck;
+  const std::string baseDir = dirOf(filepath);
+  if (mode == LSDynaMeshParser::ReadMode::Mapped) {
+    ByteSource input;
+    if (parser.openInput(input, filepath)) {
+      parseMappedDeck(parser, input, baseDir, deck);
+      return deck;
+    }
+  }
+
+  std::ifstream f(filepath);
+  if (!f) {
+    std::cerr << "LSDyna: cannot open " << filepath << "\n";
+    return deck;
+  }
+  parseStreamedDeck(parser, f, baseDir, deck);
+  return deck;
+}
+
+// Parse `root` and every file it includes, transitively, each exactly once.
+// Files are read in waves, one task per file: the includes named by one wave
+// form the next. The files of a wave split the worker threads between them, so
+// a large include still parses its sections in parallel. Keyed by
+// canonicalPath().
+std::unordered_map<std::string, DeckFile> parseIncludeTree(const MeshParser& parser,
+                                                           const std::string& root,
+                                                           LSDynaMeshParser::ReadMode mode) {
+  std::unordered_map<std::string, DeckFile> files;
+  std::unordered_set<std::string> scheduled = {canonicalPath(root)};
+  std::vector<std::pair<std::string, std::string>> wave = {{root, canonicalPath(root)}};
+  while (!wave.empty()) {
+    std::vector<DeckFile> parsed(wave.size());
+    parallelTasks(wave.size(),
+                  [&](size_t i) { parsed[i] = parseDeckFile(parser, wave[i].first, mode); });
+
+    std::vector<std::pair<std::string, std::string>> next;
+    for (size_t i = 0; i < wave.size(); ++i) {
+      for (const auto& block : parsed[i].includes) {
+        for (const auto& inc : block) {
+          std::string key = canonicalPath(inc);
+          if (scheduled.insert(key).second)
+            next.emplace_back(inc, std::move(key));
+        }
+      }
+      files.emplace(wave[i].second, std::move(parsed[i]));
+    }
+    wave = std::move(next);
+  }
+  return files;
+}
+
+void appendDeck(DeckData& to, DeckData& from) {
+  if (to.nodes.empty()) {
+    to.nodes = std::move(from.nodes);
+  } else {
+    to.nodes.insert(to.nodes.end(), from.nodes.begin(), from.nodes.end());
+  }
+  to.elems.append(from.elems);
+  to.parts.insert(to.parts.end(), from.parts.begin(), from.parts.end());
+  from = DeckData();
+}
+
+// Concatenate the parsed files in deck order: each include's data lands where
+// its *INCLUDE keyword stood, so later definitions still override earlier ones.
+// `visited` gives the same cycle and duplicate handling as reading serially.
+void mergeDeckFile(const std::string& filepath,
+                   std::unordered_map<std::string, DeckFile>& files,
+                   DeckData& deck,
+                   std::unordered_set<std::string>& visited) {
+  if (!markVisited(filepath, visited))
+    return;
+  auto it = files.find(canonicalPath(filepath));
+  if (it == files.end())
+    return;
+
+  DeckFile& file = it->second;
+  for (size_t i = 0; i < file.segments.size(); ++i) {
+    appendDeck(deck, file.segments[i]);
+    if (i < file.includes.size()) {
+      for (const auto& inc : file.includes[i])
+        mergeDeckFile(inc, files, deck, visited);
+    }
+  }
+}
+
+// Maps LS-DYNA node ids to indices into DeckData::nodes. Uses a flat table
+// when the ids are dense enough (the usual 1..N numbering with some gaps) and
+// a sorted (nid, index) vector with binary search otherwise. A NID defined more
+// than once maps to its last definition.
+class NodeIndex {
+public:
+  static constexpr uint32_t kMissing = UINT32_MAX;
+
+  explicit NodeIndex(const std::vector<RawNode>& nodes) {
+    if (nodes.empty())
+      return;
+    const auto byNid = [](const RawNode& a, const RawNode& b) { return a.nid < b.nid; };
+    const auto [minIt, maxIt] = std::minmax_element(nodes.begin(), nodes.end(), byNid);
+    minNid_ = minIt->nid;
+    const auto span = static_cast<uint64_t>(int64_t{maxIt->nid} - minNid_) + 1;
+
+    // At most kMaxSlotsPerNode table entries per defined node.
+    constexpr uint64_t kMaxSlotsPerNode = 4;
+    if (span <= kMaxSlotsPerNode * nodes.size() + 1024) {
+      dense_.assign(static_cast<size_t>(span), kMissing);
+      for (size_t i = 0; i < nodes.size(); ++i)
+        dense_[slotOf(nodes[i].nid)] = static_cast<uint32_t>(i);
+      return;
+    }
+
+    sorted_.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      sorted_.emplace_back(nodes[i].nid, static_cast<uint32_t>(i));
+    std::sort(sorted_.begin(), sorted_.end());
+    // Equal NIDs are now ordered by index; keep only the last definition.
+    size_t kept = 0;
+    for (size_t i = 0; i < sorted_.size(); ++i) {
+      if (i + 1 < sorted_.size() && sorted_[i + 1].first == sorted_[i].first)
+        continue;
+      sorted_[kept++] = sorted_[i];
+    }
+    sorted_.resize(kept);
+  }
+
+  // Index of `nid` in the node array, or kMissing.
+  uint32_t find(int nid) const {
+    if (!dense_.empty()) {
+      if (nid < minNid_ || int64_t{nid} - minNid_ >= static_cast<int64_t>(dense_.size()))
+        return kMissing;
+      return dense_[slotOf(nid)];
+    }
+    const auto it = std::lower_bound(
+        sorted_.begin(), sorted_.end(), nid, [](const auto& entry, int key) {
+          return entry.first < key;
+        });
+    return (it != sorted_.end() && it->first == nid) ? it->second : kMissing;
+  }
+
+private:
+  size_t slotOf(int nid) const {
+    return static_cast<size_t>(int64_t{nid} - minNid_);
+  }
+
+  int minNid_ = 0;
+  std::vector<uint32_t> dense_;
+  std::vector<std::pair<int, uint32_t>> sorted_;
+};
+
+// Element indices of one part, per cell kind, in deck order.
+using PartCells = std::array<std::vector<uint32_t>, kCellKindCount>;
+
+// float32 points from `count` nodes, the i-th being nodeAt(i).
+template <typename NodeAt> vtkSmartPointer<vtkPoints> buildPoints(size_t count, NodeAt nodeAt) {
+  vtkNew<vtkFloatArray> coords;
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(static_cast<vtkIdType>(count));
+  float* xyz = coords->WritePointer(0, static_cast<vtkIdType>(count * 3));
+  for (size_t i = 0; i < count; ++i) {
+    const RawNode& n = nodeAt(i);
+    xyz[3 * i] = static_cast<float>(n.x);
+    xyz[3 * i + 1] = static_cast<float>(n.y);
+    xyz[3 * i + 2] = static_cast<float>(n.z);
+  }
+  vtkSmartPointer<vtkPoints> pts = vtkSmartPointer<vtkPoints>::New();
+  pts->SetData(coords);
+  return pts;
+}
+
+// Build one part's grid, filling the VTK cell arrays directly. With
+// `sharedPoints` the cells index the deck-wide point array; otherwise the part
+// gets its own points, numbered compactly in ascending global order. Cells
+// referring to an undefined node are dropped. Returns nullptr if no cell is left.
+vtkSmartPointer<vtkUnstructuredGrid> buildPartGrid(const DeckData& deck,
+                                                   const NodeIndex& index,
+                                                   const PartCells& partCells,
+                                                   vtkPoints* sharedPoints) {
+  std::vector<uint32_t> corners; // global node index per cell corner
+  size_t cellCounts[kCellKindCount] = {};
+  size_t cornerBound = 0;
+  for (size_t kind = 0; kind < kCellKindCount; ++kind)
+    cornerBound += partCells[kind].size() * kNodesPerCell[kind];
+  corners.reserve(cornerBound);
+
+  for (size_t kind = 0; kind < kCellKindCount; ++kind) {
+    const size_t nodesPerCell = kNodesPerCell[kind];
+    const std::vector<int>& blockNodes = deck.elems.blocks[kind].nodes;
+    for (uint32_t e : partCells[kind]) {
+      const size_t first = corners.size();
+      const int* cellNids = blockNodes.data() + size_t{e} * nodesPerCell;
+      for (size_t k = 0; k < nodesPerCell; ++k) {
+        const uint32_t node = index.find(cellNids[k]);
+        if (node == NodeIndex::kMissing)
+          break;
+        corners.push_back(node);
+      }
+      if (corners.size() - first != nodesPerCell) {
+        corners.resize(first);
+        continue;
+      }
+      ++cellCounts[kind];
+    }
+  }
+  if (corners.empty())
+    return nullptr;
+
+  vtkSmartPointer<vtkPoints> pts = sharedPoints;
+  if (!pts) {
+    std::vector<uint32_t> used(corners);
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+
+    pts = buildPoints(used.size(),
+                      [&](size_t i) -> const RawNode& { return deck.nodes[used[i]]; });
+
+    for (uint32_t& corner : corners) {
+      corner = static_cast<uint32_t>(std::lower_bound(used.begin(), used.end(), corner) -
+                                     used.begin());
+    }
+  }
+
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(corners.size()));
+  vtkIdType* conn = connectivity->WritePointer(0, static_cast<vtkIdType>(corners.size()));
+  std::copy(corners.begin(), corners.end(), conn);
+
+  size_t cellCount = 0;
+  for (size_t count : cellCounts)
+    cellCount += count;
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(cellCount + 1));
+  vtkIdType* offset = offsets->WritePointer(0, static_cast<vtkIdType>(cellCount + 1));
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(static_cast<vtkIdType>(cellCount));
+  unsigned char* type = types->WritePointer(0, static_cast<vtkIdType>(cellCount));
+  size_t cell = 0;
+  vtkIdType position = 0;
+  for (size_t kind = 0; kind < kCellKindCount; ++kind) {
+    for (size_t i = 0; i < cellCounts[kind]; ++i, ++cell) {
+      offset[cell] = position;
+      type[cell] = static_cast<unsigned char>(kVtkCellType[kind]);
+      position += static_cast<vtkIdType>(kNodesPerCell[kind]);
+    }
+  }
+  offset[cellCount] = position;
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(pts);
+  grid->SetCells(types, cells);
+  return grid;
+}
+
 } // namespace
 
+LSDynaMeshParser::LSDynaMeshParser(ReadMode mode, PointStorage points)
+    : mode_(mode), points_(points) {}
 LSDynaMeshParser::~LSDynaMeshParser() = default;
 
-bool LSDynaMeshParser::canParse(const std::string& filename) {
-  std::string header = readHeader(filename, 256);
-  return header.find("*KEYWORD") != std::string::npos;
+std::string LSDynaMeshParser::cacheTag() const {
+  // Shared and per-part point storage produce differently shaped parts.
+  return points_ == PointStorage::Shared ? "lsdyna/1/shared" : "lsdyna/1";
+}
+
+bool LSDynaMeshParser::canParse(const FileHead& head) {
+  return head.prefix(256).find("*KEYWORD") != std::string_view::npos;
 }
 
 std::vector<vtkSmartPointer<vtkDataSet>> LSDynaMeshParser::parse(const std::string& filename) {
   std::vector<vtkSmartPointer<vtkDataSet>> result;
 
-  std::vector<RawNode> rawNodes;
-  rawNodes.reserve(65536);
-  std::vector<Tet> elems;
-  elems.reserve(65536);
-  std::vector<PartInfo> parts;
-
-  std::unordered_set<std::string> visited;
-  parseFile(filename, dirOf(filename), rawNodes, elems, parts, visited);
+  DeckData deck;
+  {
+    auto files = parseIncludeTree(*this, filename, mode_);
+    const std::string root = canonicalPath(filename);
+    includes_.clear();
+    for (const auto& entry : files) {
+      if (entry.first != root)
+        includes_.push_back(entry.first);
+    }
+    std::sort(includes_.begin(), includes_.end());
+    std::unordered_set<std::string> visited;
+    mergeDeckFile(filename, files, deck, visited);
+  }
 
-  if (rawNodes.empty() || elems.empty())
+  const std::vector<RawNode>& rawNodes = deck.nodes;
+  const ElementStore& elems = deck.elems;
+  const std::vector<PartInfo>& parts = deck.parts;
+  if (rawNodes.empty() || elems.empty() || cancelled())
     return result;
 
-  std::unordered_map<int, const RawNode*> nidToNode;
-  nidToNode.reserve(rawNodes.size());
-  for (const auto& n : rawNodes)
-    nidToNode[n.nid] = &n;
+  const NodeIndex index(rawNodes);
 
   std::unordered_map<int, std::string> partNames;
   for (const auto& p : parts)
     partNames[p.pid] = p.name;
 
-  std::unordered_map<int, std::vector<const Tet*>> elemsByPid;
-  elemsByPid.reserve(parts.size() + 8);
-  for (const auto& tet : elems) {
-    elemsByPid[tet.pid].push_back(&tet);
+  std::unordered_map<int, PartCells> cellsByPid;
+  cellsByPid.reserve(parts.size() + 8);
+  for (size_t kind = 0; kind < kCellKindCount; ++kind) {
+    const std::vector<int>& elemPids = elems.blocks[kind].pids;
+    // Consecutive elements nearly always share a part; skip the hash lookup.
+    int lastPid = 0;
+    std::vector<uint32_t>* lastCells = nullptr;
+    for (size_t i = 0; i < elemPids.size(); ++i) {
+      if (!lastCells || elemPids[i] != lastPid) {
+        lastPid = elemPids[i];
+        lastCells = &cellsByPid[lastPid][kind];
+      }
+      lastCells->push_back(static_cast<uint32_t>(i));
+    }
   }
 
   std::vector<int> pids;
-  pids.reserve(elemsByPid.size());
-  std::transform(elemsByPid.begin(),
-                 elemsByPid.end(),
+  pids.reserve(cellsByPid.size());
+  std::transform(cellsByPid.begin(),
+                 cellsByPid.end(),
                  std::back_inserter(pids),
                  [](const auto& kv) { return kv.first; });
   std::sort(pids.begin(), pids.end());
 
-  for (int pid : pids) {
-    const auto& partTets = elemsByPid[pid];
-    std::unordered_map<int, vtkIdType> compactMap;
-    compactMap.reserve(partTets.size() * 4);
-
-    vtkNew<vtkPoints> pts;
-    vtkNew<vtkUnstructuredGrid> grid;
-    for (const Tet* tet : partTets) {
-      vtkIdType tetNodeIds[4];
-      bool validTet = true;
-      for (int k = 0; k < 4; ++k) {
-        const int nid = tet->n[k];
-        auto idIt = compactMap.find(nid);
-        if (idIt == compactMap.end()) {
-          auto nodeIt = nidToNode.find(nid);
-          if (nodeIt == nidToNode.end()) {
-            validTet = false;
-            break;
-          }
-          const RawNode* rn = nodeIt->second;
-          vtkIdType vid = pts->InsertNextPoint(rn->x, rn->y, rn->z);
-          compactMap[nid] = vid;
-          tetNodeIds[k] = vid;
-        } else {
-          tetNodeIds[k] = idIt->second;
-        }
-      }
-      if (!validTet)
-        continue;
-      grid->InsertNextCell(VTK_TETRA, 4, tetNodeIds);
-    }
+  vtkSmartPointer<vtkPoints> sharedPoints;
+  if (points_ == PointStorage::Shared)
+    sharedPoints = buildPoints(rawNodes.size(),
+                               [&](size_t i) -> const RawNode& { return rawNodes[i]; });
+
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid>> grids(pids.size());
+  parallelFor(pids.size(), [&](size_t i) {
+    if (!cancelled())
+      grids[i] = buildPartGrid(deck, index, cellsByPid.at(pids[i]), sharedPoints);
+  });
+  if (cancelled())
+    return result;
 
-    if (grid->GetNumberOfCells() == 0)
+  for (size_t i = 0; i < pids.size(); ++i) {
+    vtkUnstructuredGrid* grid = grids[i];
+    if (!grid)
       continue;
-    grid->SetPoints(pts);
+    const int pid = pids[i];
 
     std::string name = "Part " + std::to_string(pid) + " (PID=" + std::to_string(pid) + ")";
     auto it = partNames.find(pid);
@@ -0,0 +1,74 @@
+#include "LoadProgressBar.h"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QProgressBar>
+#include <QString>
+#include <QToolButton>
+#include <algorithm>
+
+namespace {
+
+// The bar runs 0..kSteps so files of any size map onto an int range.
+constexpr int kSteps = 1000;
+
+} // namespace
+
+LoadProgressBar::LoadProgressBar(const QString& title, QWidget* parent) : QWidget(parent) {
+  setObjectName("loadProgressBar");
+  setAttribute(Qt::WA_StyledBackground, true);
+  setFocusPolicy(Qt::NoFocus);
+  setStyleSheet("QWidget#loadProgressBar {"
+                "  background: rgba(20,20,20,200);"
+                "  border-radius: 8px;"
+                "}"
+                "QToolButton {"
+                "  background: rgba(255,255,255,18);"
+                "  color: #E8E8E8;"
+                "  border: none;"
+                "  border-radius: 4px;"
+                "  padding: 2px 8px;"
+                "}"
+                "QToolButton:hover { background: rgba(255,255,255,40); }"
+                "QLabel { color: #D8D8D8; font-size: 12px; }"
+                "QProgressBar {"
+                "  background: rgba(255,255,255,50); border: none; border-radius: 2px;"
+                "  max-height: 4px;"
+                "}"
+                "QProgressBar::chunk { background: #5096FA; border-radius: 2px; }");
+
+  auto* row = new QHBoxLayout(this);
+  row->setContentsMargins(10, 6, 10, 6);
+  row->setSpacing(8);
+
+  label_ = new QLabel(QStringLiteral("Loading %1").arg(title), this);
+  label_->setMinimumWidth(140);
+  row->addWidget(label_);
+
+  bar_ = new QProgressBar(this);
+  bar_->setRange(0, kSteps);
+  bar_->setValue(0);
+  bar_->setTextVisible(false);
+  bar_->setFocusPolicy(Qt::NoFocus);
+  row->addWidget(bar_, 1);
+
+  cancelButton_ = new QToolButton(this);
+  cancelButton_->setText(QStringLiteral("Cancel"));
+  cancelButton_->setToolTip("Stop loading");
+  cancelButton_->setFocusPolicy(Qt::NoFocus);
+  row->addWidget(cancelButton_);
+
+  connect(cancelButton_, &QToolButton::clicked, this, [this]() {
+    cancelButton_->setEnabled(false);
+    emit cancelRequested();
+  });
+}
+
+void LoadProgressBar::setProgress(uint64_t done, uint64_t total) {
+  if (total == 0) {
+    bar_->setValue(0);
+    return;
+  }
+  const double fraction = static_cast<double>(std::min(done, total)) / static_cast<double>(total);
+  bar_->setValue(static_cast<int>(fraction * kSteps));
+}
@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    open_ = std::exchange(other.open_, false);
+#ifdef _WIN32
+    fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+    mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+  close();
+  HANDLE file = CreateFileA(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    return false;
+  }
+  fileHandle_ = file;
+  open_ = true;
+  if (fileSize.QuadPart == 0) {
+    return true;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    close();
+    return false;
+  }
+  mappingHandle_ = mapping;
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    close();
+    return false;
+  }
+  data_ = static_cast<const char*>(view);
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mappingHandle_) {
+    CloseHandle(static_cast<HANDLE>(mappingHandle_));
+  }
+  if (fileHandle_) {
+    CloseHandle(static_cast<HANDLE>(fileHandle_));
+  }
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+  fileHandle_ = nullptr;
+  mappingHandle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return false;
+  }
+  open_ = true;
+  if (st.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+  const size_t length = static_cast<size_t>(st.st_size);
+  void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file; the descriptor is not needed.
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    open_ = false;
+    return false;
+  }
+  // Parsers walk the buffer front to back; let the kernel read ahead aggressively.
+  madvise(addr, length, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(addr);
+  size_ = length;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+#endif
@@ -0,0 +1,747 @@
+#include "MeshCache.h"
+
+#include "MappedFile.h"
+#include "cache_files.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkStringArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Entry layout (native byte order, checked through kByteOrderMark):
+//   magic, format version, byte order mark
+//   key string, input file stamps
+//   array table: per array its kind, type, shape and name, then the raw values
+//     at the next 64-byte boundary (strings: length-prefixed values)
+//   meshes: dataset type, points/cell array indices, point/cell/field arrays
+constexpr char kMagic[8] = {'V', 'V', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kPayloadAlignment = 64;
+constexpr uint32_t kNoArray = UINT32_MAX;
+constexpr uint32_t kNumericArray = 0;
+constexpr uint32_t kStringArray = 1;
+
+// Least recently used entries are removed once the directory grows past this.
+constexpr uintmax_t kMaxCacheBytes = uintmax_t{4} << 30;
+
+std::string entryKey(const std::string& canonical,
+                     const FileStamp& stamp,
+                     const std::string& parserTag) {
+  return canonical + '\n' + std::to_string(stamp.size) + '\n' + std::to_string(stamp.mtime) +
+         '\n' + parserTag;
+}
+
+// Plain-old-data VTK value types whose bytes can be stored as they are.
+bool isCacheableType(int dataType) {
+  switch (dataType) {
+  case VTK_CHAR:
+  case VTK_SIGNED_CHAR:
+  case VTK_UNSIGNED_CHAR:
+  case VTK_SHORT:
+  case VTK_UNSIGNED_SHORT:
+  case VTK_INT:
+  case VTK_UNSIGNED_INT:
+  case VTK_LONG:
+  case VTK_UNSIGNED_LONG:
+  case VTK_LONG_LONG:
+  case VTK_UNSIGNED_LONG_LONG:
+  case VTK_ID_TYPE:
+  case VTK_FLOAT:
+  case VTK_DOUBLE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Writes entry fields to a stream, keeping count of the offset for align().
+class EntryWriter {
+public:
+  explicit EntryWriter(std::ostream& out) : out_(out) {}
+
+  template <typename T> void put(T value) {
+    bytes(&value, sizeof(T));
+  }
+  void bytes(const void* data, size_t size) {
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    offset_ += size;
+  }
+  void string(const std::string& value) {
+    put<uint64_t>(value.size());
+    bytes(value.data(), value.size());
+  }
+  void align(size_t alignment) {
+    static const char kZeros[kPayloadAlignment] = {};
+    const size_t aligned = (offset_ + alignment - 1) / alignment * alignment;
+    bytes(kZeros, aligned - offset_);
+  }
+
+private:
+  std::ostream& out_;
+  size_t offset_ = 0;
+};
+
+class EntryReader {
+public:
+  EntryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T> T get() {
+    T value{};
+    if (const char* p = bytes(sizeof(T))) {
+      std::memcpy(&value, p, sizeof(T));
+    }
+    return value;
+  }
+  const char* bytes(size_t size) {
+    if (!ok_ || size > size_ - pos_) {
+      ok_ = false;
+      return nullptr;
+    }
+    const char* p = data_ + pos_;
+    pos_ += size;
+    return p;
+  }
+  std::string string() {
+    const auto size = get<uint64_t>();
+    const char* p = bytes(static_cast<size_t>(size));
+    return p ? std::string(p, static_cast<size_t>(size)) : std::string();
+  }
+  void align(size_t alignment) {
+    const size_t aligned = (pos_ + alignment - 1) / alignment * alignment;
+    if (aligned > size_) {
+      ok_ = false;
+      return;
+    }
+    pos_ = aligned;
+  }
+  bool ok() const {
+    return ok_;
+  }
+  size_t remaining() const {
+    return ok_ ? size_ - pos_ : 0;
+  }
+
+private:
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+// Arrays referenced by the meshes being stored, each written once.
+class ArrayTable {
+public:
+  // Index of `array` in the table, or kNoArray if it cannot be stored.
+  uint32_t add(vtkAbstractArray* array) {
+    if (!array) {
+      return kNoArray;
+    }
+    auto it = ids_.find(array);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    auto* numeric = vtkDataArray::SafeDownCast(array);
+    if (numeric ? !numeric->HasStandardMemoryLayout() || !isCacheableType(numeric->GetDataType())
+                : !vtkStringArray::SafeDownCast(array)) {
+      cacheable_ = false;
+      return kNoArray;
+    }
+    const auto id = static_cast<uint32_t>(arrays_.size());
+    ids_.emplace(array, id);
+    arrays_.push_back(array);
+    return id;
+  }
+
+  bool cacheable() const {
+    return cacheable_;
+  }
+
+  void write(EntryWriter& out) const {
+    out.put<uint64_t>(arrays_.size());
+    for (vtkAbstractArray* array : arrays_) {
+      const char* name = array->GetName();
+      if (auto* strings = vtkStringArray::SafeDownCast(array)) {
+        out.put<uint32_t>(kStringArray);
+        out.put<uint8_t>(name ? 1 : 0);
+        out.string(name ? name : "");
+        const vtkIdType count = strings->GetNumberOfValues();
+        out.put<int64_t>(count);
+        for (vtkIdType i = 0; i < count; ++i) {
+          out.string(strings->GetValue(i));
+        }
+        continue;
+      }
+      auto* numeric = vtkDataArray::SafeDownCast(array);
+      const auto payload = static_cast<size_t>(numeric->GetNumberOfValues()) *
+                           static_cast<size_t>(numeric->GetDataTypeSize());
+      out.put<uint32_t>(kNumericArray);
+      out.put<uint8_t>(name ? 1 : 0);
+      out.string(name ? name : "");
+      out.put<int32_t>(numeric->GetDataType());
+      out.put<int32_t>(numeric->GetNumberOfComponents());
+      out.put<int64_t>(numeric->GetNumberOfTuples());
+      out.put<uint64_t>(payload);
+      out.align(kPayloadAlignment);
+      if (payload > 0) {
+        out.bytes(numeric->GetVoidPointer(0), payload);
+      }
+    }
+  }
+
+private:
+  std::unordered_map<vtkAbstractArray*, uint32_t> ids_;
+  std::vector<vtkAbstractArray*> arrays_;
+  bool cacheable_ = true;
+};
+
+void writeCells(vtkCellArray* cells, ArrayTable& arrays, EntryWriter& out) {
+  if (!cells || cells->GetNumberOfCells() == 0) {
+    out.put<uint32_t>(kNoArray);
+    out.put<uint32_t>(kNoArray);
+    return;
+  }
+  out.put<uint32_t>(arrays.add(cells->GetOffsetsArray()));
+  out.put<uint32_t>(arrays.add(cells->GetConnectivityArray()));
+}
+
+void writeAttributes(vtkFieldData* data, ArrayTable& arrays, EntryWriter& out) {
+  const int count = data ? data->GetNumberOfArrays() : 0;
+  auto* attributes = vtkDataSetAttributes::SafeDownCast(data);
+  out.put<uint32_t>(static_cast<uint32_t>(count));
+  for (int i = 0; i < count; ++i) {
+    out.put<uint32_t>(arrays.add(data->GetAbstractArray(i)));
+    out.put<int32_t>(attributes ? attributes->IsArrayAnAttribute(i) : -1);
+  }
+}
+
+bool writeMesh(vtkDataSet* mesh, ArrayTable& arrays, EntryWriter& out) {
+  auto* poly = vtkPolyData::SafeDownCast(mesh);
+  auto* grid = vtkUnstructuredGrid::SafeDownCast(mesh);
+  if (!poly && !grid) {
+    return false;
+  }
+  vtkPoints* points = vtkPointSet::SafeDownCast(mesh)->GetPoints();
+  out.put<int32_t>(poly ? VTK_POLY_DATA : VTK_UNSTRUCTURED_GRID);
+  out.put<uint32_t>(points ? arrays.add(points->GetData()) : kNoArray);
+  if (poly) {
+    writeCells(poly->GetVerts(), arrays, out);
+    writeCells(poly->GetLines(), arrays, out);
+    writeCells(poly->GetPolys(), arrays, out);
+    writeCells(poly->GetStrips(), arrays, out);
+  } else {
+    out.put<uint32_t>(arrays.add(grid->GetCellTypesArray()));
+    writeCells(grid->GetCells(), arrays, out);
+  }
+  writeAttributes(mesh->GetPointData(), arrays, out);
+  writeAttributes(mesh->GetCellData(), arrays, out);
+  writeAttributes(mesh->GetFieldData(), arrays, out);
+  return arrays.cacheable();
+}
+
+std::vector<vtkSmartPointer<vtkAbstractArray>> readArrays(EntryReader& in) {
+  std::vector<vtkSmartPointer<vtkAbstractArray>> arrays;
+  const auto count = in.get<uint64_t>();
+  for (uint64_t a = 0; a < count && in.ok(); ++a) {
+    const auto kind = in.get<uint32_t>();
+    const bool hasName = in.get<uint8_t>() != 0;
+    const std::string name = in.string();
+
+    if (kind == kStringArray) {
+      auto strings = vtkSmartPointer<vtkStringArray>::New();
+      const auto values = in.get<int64_t>();
+      // Each string is at least its length word, so a corrupt count is caught
+      // before it sizes the array.
+      if (values < 0 || static_cast<uint64_t>(values) > in.remaining() / sizeof(uint64_t)) {
+        return {};
+      }
+      strings->SetNumberOfValues(static_cast<vtkIdType>(values));
+      for (int64_t i = 0; i < values && in.ok(); ++i) {
+        strings->SetValue(static_cast<vtkIdType>(i), in.string());
+      }
+      if (hasName) {
+        strings->SetName(name.c_str());
+      }
+      arrays.emplace_back(strings);
+      continue;
+    }
+
+    const auto dataType = in.get<int32_t>();
+    const auto components = in.get<int32_t>();
+    const auto tuples = in.get<int64_t>();
+    const auto payload = in.get<uint64_t>();
+    in.align(kPayloadAlignment);
+    if (kind != kNumericArray || !in.ok() || !isCacheableType(dataType) || components < 1 ||
+        tuples < 0) {
+      return {};
+    }
+    auto numeric = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(dataType));
+    if (!numeric) {
+      return {};
+    }
+    // The payload must match the header and be in the entry before anything
+    // is allocated, so a corrupt or truncated entry cannot size the array.
+    const auto valueSize = static_cast<uint64_t>(numeric->GetDataTypeSize());
+    const auto tupleBytes = static_cast<uint64_t>(components) * valueSize;
+    if (static_cast<uint64_t>(tuples) > std::numeric_limits<uint64_t>::max() / tupleBytes ||
+        payload != static_cast<uint64_t>(tuples) * tupleBytes || payload > in.remaining()) {
+      return {};
+    }
+    const char* values = in.bytes(static_cast<size_t>(payload));
+    if (!values) {
+      return {};
+    }
+    numeric->SetNumberOfComponents(components);
+    numeric->SetNumberOfTuples(static_cast<vtkIdType>(tuples));
+    if (payload > 0) {
+      std::memcpy(numeric->GetVoidPointer(0), values, static_cast<size_t>(payload));
+    }
+    if (hasName) {
+      numeric->SetName(name.c_str());
+    }
+    arrays.emplace_back(numeric);
+  }
+  return in.ok() ? arrays : std::vector<vtkSmartPointer<vtkAbstractArray>>();
+}
+
+class MeshBuilder {
+public:
+  MeshBuilder(EntryReader& in, const std::vector<vtkSmartPointer<vtkAbstractArray>>& arrays)
+      : in_(in), arrays_(arrays) {}
+
+  // One mesh record, as written by writeMesh; null if it is malformed.
+  vtkSmartPointer<vtkDataSet> read() {
+    const auto type = in_.get<int32_t>();
+    const auto pointsIndex = in_.get<uint32_t>();
+    vtkSmartPointer<vtkPointSet> mesh;
+    if (type == VTK_POLY_DATA) {
+      auto poly = vtkSmartPointer<vtkPolyData>::New();
+      vtkSmartPointer<vtkCellArray> verts = cells();
+      vtkSmartPointer<vtkCellArray> lines = cells();
+      vtkSmartPointer<vtkCellArray> polys = cells();
+      vtkSmartPointer<vtkCellArray> strips = cells();
+      if (verts) {
+        poly->SetVerts(verts);
+      }
+      if (lines) {
+        poly->SetLines(lines);
+      }
+      if (polys) {
+        poly->SetPolys(polys);
+      }
+      if (strips) {
+        poly->SetStrips(strips);
+      }
+      mesh = poly;
+    } else if (type == VTK_UNSTRUCTURED_GRID) {
+      auto* types = vtkUnsignedCharArray::SafeDownCast(array(in_.get<uint32_t>()));
+      vtkSmartPointer<vtkCellArray> cellArray = cells();
+      if (!types || !cellArray) {
+        return nullptr;
+      }
+      auto grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+      grid->SetCells(types, cellArray);
+      mesh = grid;
+    } else {
+      return nullptr;
+    }
+
+    if (pointsIndex != kNoArray) {
+      vtkSmartPointer<vtkPoints> pts = points(pointsIndex);
+      if (!pts) {
+        return nullptr;
+      }
+      mesh->SetPoints(pts);
+    }
+    if (!attributes(mesh->GetPointData()) || !attributes(mesh->GetCellData()) ||
+        !attributes(mesh->GetFieldData())) {
+      return nullptr;
+    }
+    return mesh;
+  }
+
+private:
+  // Points are shared between meshes that shared them when stored.
+  vtkSmartPointer<vtkPoints> points(uint32_t index) {
+    auto* data = vtkDataArray::SafeDownCast(array(index));
+    if (!data) {
+      return nullptr;
+    }
+    auto it = points_.find(index);
+    if (it != points_.end()) {
+      return it->second;
+    }
+    auto pts = vtkSmartPointer<vtkPoints>::New();
+    pts->SetData(data);
+    points_.emplace(index, pts);
+    return pts;
+  }
+
+  vtkSmartPointer<vtkCellArray> cells() {
+    const auto offsets = in_.get<uint32_t>();
+    const auto connectivity = in_.get<uint32_t>();
+    auto* offsetsArray = vtkDataArray::SafeDownCast(array(offsets));
+    auto* connectivityArray = vtkDataArray::SafeDownCast(array(connectivity));
+    if (!offsetsArray || !connectivityArray) {
+      return nullptr;
+    }
+    auto cellArray = vtkSmartPointer<vtkCellArray>::New();
+    if (!cellArray->SetData(offsetsArray, connectivityArray)) {
+      return nullptr;
+    }
+    return cellArray;
+  }
+
+  bool attributes(vtkFieldData* data) {
+    const auto count = in_.get<uint32_t>();
+    auto* attributes = vtkDataSetAttributes::SafeDownCast(data);
+    for (uint32_t i = 0; i < count && in_.ok(); ++i) {
+      vtkAbstractArray* arr = array(in_.get<uint32_t>());
+      const auto attribute = in_.get<int32_t>();
+      if (!arr) {
+        return false;
+      }
+      const int index = data->AddArray(arr);
+      if (attributes && attribute >= 0) {
+        attributes->SetActiveAttribute(index, attribute);
+      }
+    }
+    return in_.ok();
+  }
+
+  vtkAbstractArray* array(uint32_t index) const {
+    return index < arrays_.size() ? arrays_[index].GetPointer() : nullptr;
+  }
+
+  EntryReader& in_;
+  const std::vector<vtkSmartPointer<vtkAbstractArray>>& arrays_;
+  std::unordered_map<uint32_t, vtkSmartPointer<vtkPoints>> points_;
+};
+
+// Remove the least recently used entries until the directory fits kMaxCacheBytes.
+void pruneCache(const std::string& directory) {
+  std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+  uintmax_t total = 0;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(directory, ec)) {
+    std::error_code entryEc;
+    if (!entry.is_regular_file(entryEc) || entry.path().extension() != ".vvmesh") {
+      continue;
+    }
+    const uintmax_t size = entry.file_size(entryEc);
+    const auto time = entry.last_write_time(entryEc);
+    if (entryEc) {
+      continue;
+    }
+    total += size;
+    entries.emplace_back(time, entry.path());
+  }
+  if (total <= kMaxCacheBytes) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end());
+  for (const auto& entry : entries) {
+    if (total <= kMaxCacheBytes) {
+      break;
+    }
+    std::error_code removeEc;
+    const uintmax_t size = fs::file_size(entry.second, removeEc);
+    if (!removeEc && fs::remove(entry.second, removeEc)) {
+      total -= size;
+    }
+  }
+}
+
+// An entry as store() was asked for it: the file and its stamp when it was
+// parsed, the key, the input files stamped at that point and the meshes to
+// write.
+struct PendingEntry {
+  std::string path;
+  FileStamp stamp;
+  std::string key;
+  std::vector<std::pair<std::string, FileStamp>> inputs;
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+};
+
+// Stamp the input files for an entry of `path`. False if `path` is gone or no
+// longer has the stamp it was parsed with.
+bool preparePending(const std::string& path,
+                    const FileStamp& parsedStamp,
+                    const std::string& parserTag,
+                    const std::vector<std::string>& inputFiles,
+                    PendingEntry& pending) {
+  if (!parsedStamp.exists || !(stampOf(path) == parsedStamp)) {
+    return false;
+  }
+  pending.path = path;
+  pending.stamp = parsedStamp;
+  pending.key = entryKey(canonicalPath(path), parsedStamp, parserTag);
+  for (const std::string& input : inputFiles) {
+    pending.inputs.emplace_back(input, stampOf(input));
+  }
+  return true;
+}
+
+// Write `pending` to `entry`. The header and the array payloads are streamed to
+// a temporary file straight from the VTK arrays (only the small mesh records
+// are put together in memory first, since they name arrays by their index in
+// the table written before them), then renamed into place.
+bool writeEntry(const std::string& directory,
+                const std::string& entry,
+                const PendingEntry& pending) {
+  // A file rewritten since it was stamped would get an entry under its new
+  // stamp holding the old contents.
+  if (!(stampOf(pending.path) == pending.stamp)) {
+    return false;
+  }
+  ArrayTable arrays;
+  std::ostringstream meshRecords;
+  EntryWriter meshSection(meshRecords);
+  meshSection.put<uint64_t>(pending.meshes.size());
+  for (const auto& mesh : pending.meshes) {
+    if (!writeMesh(mesh, arrays, meshSection)) {
+      return false;
+    }
+  }
+
+  const bool written = writeFileAtomically(entry, [&](std::ostream& file) {
+    EntryWriter out(file);
+    out.bytes(kMagic, sizeof(kMagic));
+    out.put<uint32_t>(kFormatVersion);
+    out.put<uint32_t>(kByteOrderMark);
+    out.string(pending.key);
+    out.put<uint64_t>(pending.inputs.size());
+    for (const auto& [input, inputStamp] : pending.inputs) {
+      out.string(input);
+      out.put<uint8_t>(inputStamp.exists ? 1 : 0);
+      out.put<uint64_t>(inputStamp.size);
+      out.put<int64_t>(inputStamp.mtime);
+    }
+    arrays.write(out);
+    const std::string records = meshRecords.str();
+    out.bytes(records.data(), records.size());
+    return true;
+  });
+  if (!written) {
+    std::cerr << "vv: cannot write mesh cache entry " << entry << '\n';
+    return false;
+  }
+  pruneCache(directory);
+  return true;
+}
+
+// The thread storeInBackground() entries are written on, one at a time in the
+// order they were queued. Started on first use; at exit, its destructor writes
+// what is still queued before joining it.
+class BackgroundStores {
+public:
+  static BackgroundStores& instance() {
+    static BackgroundStores stores;
+    return stores;
+  }
+
+  ~BackgroundStores() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    changed_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  void post(std::function<void()> job) {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(std::move(job));
+      if (!thread_.joinable()) {
+        thread_ = std::thread([this]() { run(); });
+      }
+    }
+    changed_.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+  }
+
+private:
+  BackgroundStores() = default;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      changed_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      std::function<void()> job = std::move(jobs_.front());
+      jobs_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      job();
+      lock.lock();
+      busy_ = false;
+      changed_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::deque<std::function<void()>> jobs_;
+  bool busy_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace
+
+MeshCache::MeshCache(std::string directory) : directory_(std::move(directory)) {}
+
+std::string MeshCache::defaultDirectory() {
+  if (const char* dir = std::getenv("VV_CACHE_DIR"); dir && *dir) {
+    return dir;
+  }
+#ifdef _WIN32
+  if (const char* local = std::getenv("LOCALAPPDATA"); local && *local) {
+    return (fs::path(local) / "vv" / "meshes").string();
+  }
+#else
+  if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+    return (fs::path(xdg) / "vv" / "meshes").string();
+  }
+  if (const char* home = std::getenv("HOME"); home && *home) {
+    return (fs::path(home) / ".cache" / "vv" / "meshes").string();
+  }
+#endif
+  return {};
+}
+
+std::string MeshCache::entryPath(const std::string& key) const {
+  return (fs::path(directory_) / (hashedFileName(key) + ".vvmesh")).string();
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> MeshCache::load(const std::string& path,
+                                                         const std::string& parserTag) const {
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+  const FileStamp stamp = stampOf(path);
+  if (!enabled() || parserTag.empty() || !stamp.exists) {
+    return meshes;
+  }
+  const std::string key = entryKey(canonicalPath(path), stamp, parserTag);
+  const std::string entry = entryPath(key);
+  MappedFile file;
+  std::error_code ec;
+  if (!fs::exists(entry, ec) || !file.open(entry)) {
+    return meshes;
+  }
+
+  EntryReader in(file.data(), file.size());
+  const char* magic = in.bytes(sizeof(kMagic));
+  if (!magic || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      in.get<uint32_t>() != kFormatVersion || in.get<uint32_t>() != kByteOrderMark ||
+      in.string() != key) {
+    return meshes;
+  }
+  const auto inputCount = in.get<uint64_t>();
+  for (uint64_t i = 0; i < inputCount && in.ok(); ++i) {
+    const std::string input = in.string();
+    FileStamp recorded;
+    recorded.exists = in.get<uint8_t>() != 0;
+    recorded.size = in.get<uint64_t>();
+    recorded.mtime = in.get<int64_t>();
+    if (!(stampOf(input) == recorded)) {
+      return meshes;
+    }
+  }
+
+  const auto arrays = readArrays(in);
+  if (!in.ok()) {
+    return meshes;
+  }
+  MeshBuilder builder(in, arrays);
+  const auto meshCount = in.get<uint64_t>();
+  for (uint64_t m = 0; m < meshCount && in.ok(); ++m) {
+    vtkSmartPointer<vtkDataSet> mesh = builder.read();
+    if (!mesh) {
+      return {};
+    }
+    meshes.push_back(mesh);
+  }
+  if (!in.ok() || meshes.empty()) {
+    return {};
+  }
+
+  // Entries age out least-recently-used first; a hit counts as a use.
+  fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+  return meshes;
+}
+
+bool MeshCache::store(const std::string& path,
+                      const FileStamp& parsedStamp,
+                      const std::string& parserTag,
+                      const std::vector<std::string>& inputFiles,
+                      const std::vector<vtkSmartPointer<vtkDataSet>>& meshes) const {
+  PendingEntry pending;
+  if (!enabled() || parserTag.empty() || meshes.empty() ||
+      !preparePending(path, parsedStamp, parserTag, inputFiles, pending)) {
+    return false;
+  }
+  pending.meshes = meshes;
+  return writeEntry(directory_, entryPath(pending.key), pending);
+}
+
+void MeshCache::storeInBackground(const std::string& path,
+                                  const FileStamp& parsedStamp,
+                                  const std::string& parserTag,
+                                  const std::vector<std::string>& inputFiles,
+                                  const std::vector<vtkSmartPointer<vtkDataSet>>& meshes) const {
+  auto pending = std::make_shared<PendingEntry>();
+  if (!enabled() || parserTag.empty() || meshes.empty() ||
+      !preparePending(path, parsedStamp, parserTag, inputFiles, *pending)) {
+    return;
+  }
+  // Shallow copies share the arrays but not the attribute lists, so the viewer
+  // may add or activate arrays on the meshes while they are written.
+  for (const auto& mesh : meshes) {
+    vtkSmartPointer<vtkDataSet> copy;
+    copy.TakeReference(mesh->NewInstance());
+    copy->ShallowCopy(mesh);
+    pending->meshes.push_back(copy);
+  }
+  const std::string entry = entryPath(pending->key);
+  BackgroundStores::instance().post(
+      [directory = directory_, entry, pending]() { writeEntry(directory, entry, *pending); });
+}
+
+void MeshCache::waitForBackgroundStores() {
+  BackgroundStores::instance().wait();
+}
@@ -1,20 +1,33 @@
 #include "MeshLoading.h"
 
 #include "CartoMeshParser.h"
+#include "D3plotMeshParser.h"
 #include "FSurfMeshParser.h"
+#include "FileSeriesMeshParser.h"
 #include "JsonMeshParser.h"
 #include "LSDynaMeshParser.h"
+#include "MeshCache.h"
 #include "MeshParser.h"
+#include "PlyMeshParser.h"
+#include "StdinFile.h"
+#include "StlMeshParser.h"
 #include "TemporalSource.h"
 #include "VTKHDFMeshParser.h"
 #include "VTKMeshParser.h"
 #include "XMLMeshParser.h"
 #include "mesh_utils.h"
+#include "parallel_utils.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <system_error>
+#include <utility>
 #include <vtkDataArray.h>
 #include <vtkFieldData.h>
 #include <vtkStringArray.h>
@@ -64,127 +77,386 @@ std::vector<std::string> filesToProcessFromArgs(const std::vector<std::string>&
   return {meshfiles.front()};
 }
 
-std::vector<std::unique_ptr<MeshParser>> buildParsers() {
+std::vector<std::unique_ptr<MeshParser>> buildParsers(const MeshLoadOptions& options) {
   std::vector<std::unique_ptr<MeshParser>> parsers;
   parsers.emplace_back(std::make_unique<XMLMeshParser>());
   parsers.emplace_back(std::make_unique<VTKHDFMeshParser>());
+  parsers.emplace_back(std::make_unique<FileSeriesMeshParser>(options.fileSeries));
   parsers.emplace_back(std::make_unique<VTKMeshParser>());
   parsers.emplace_back(std::make_unique<JsonMeshParser>());
   parsers.emplace_back(std::make_unique<CartoMeshParser>());
   parsers.emplace_back(std::make_unique<FSurfMeshParser>());
-  parsers.emplace_back(std::make_unique<LSDynaMeshParser>());
+  parsers.emplace_back(std::make_unique<PlyMeshParser>());
+  parsers.emplace_back(std::make_unique<StlMeshParser>());
+  parsers.emplace_back(std::make_unique<D3plotMeshParser>());
+  parsers.emplace_back(std::make_unique<LSDynaMeshParser>(
+      LSDynaMeshParser::ReadMode::Mapped,
+      options.sharedPoints ? LSDynaMeshParser::PointStorage::Shared
+                           : LSDynaMeshParser::PointStorage::PerPart));
   return parsers;
 }
 
-class TempFileCleanup {
+// The first parser that recognizes `path`; one read of the file head serves
+// every parser's format check.
+MeshParser* selectParser(const std::vector<std::unique_ptr<MeshParser>>& parsers,
+                         const std::string& path) {
+  const FileHead head = FileHead::read(path);
+  for (const auto& parser : parsers) {
+    if (parser->canParse(head)) {
+      return parser.get();
+    }
+  }
+  return nullptr;
+}
+
+// Byte progress over all files of a load, fed by the parsers from any thread.
+class LoadProgress {
 public:
-  // std::filesystem::remove(path, error_code) is noexcept, so this never throws;
-  // clang-tidy can't model that, hence the suppression.
-  ~TempFileCleanup() { // NOLINT(bugprone-exception-escape)
-    for (const std::string& tmpFile : tmpFiles_) {
-      std::error_code ec;
-      std::filesystem::remove(tmpFile, ec);
+  LoadProgress(const MeshLoadOptions& options, const std::vector<uint64_t>& fileBytes)
+      : options_(options), count_(fileBytes.size()),
+        fileBytes_(std::make_unique<std::atomic<uint64_t>[]>(count_)),
+        fileDone_(std::make_unique<std::atomic<uint64_t>[]>(count_)) {
+    for (size_t i = 0; i < count_; ++i) {
+      fileBytes_[i] = fileBytes[i];
+      total_ += fileBytes[i];
     }
   }
 
-  void add(const std::string& tmpFile) {
-    tmpFiles_.push_back(tmpFile);
+  // File `index` is `bytes` larger than known so far: stdin, whose size is only
+  // known as it arrives.
+  void grow(size_t index, uint64_t bytes) {
+    fileBytes_[index] += bytes;
+    const uint64_t total = total_.fetch_add(bytes) + bytes;
+    if (options_.onProgress) {
+      options_.onProgress(done_.load(), total);
+    }
+  }
+
+  // Count `bytes` more of file `index`, capped at its size. False once the load
+  // has been cancelled.
+  bool advance(size_t index, uint64_t bytes) {
+    std::atomic<uint64_t>& done = fileDone_[index];
+    uint64_t before = done.load();
+    uint64_t after = before;
+    do {
+      after = std::min(fileBytes_[index].load(), before + bytes);
+    } while (after != before && !done.compare_exchange_weak(before, after));
+    if (after > before) {
+      const uint64_t overall = done_.fetch_add(after - before) + (after - before);
+      if (options_.onProgress) {
+        options_.onProgress(overall, total_.load());
+      }
+    }
+    return !cancelled();
+  }
+
+  // The file is done: count whatever of it its parser did not report.
+  void finish(size_t index) {
+    advance(index, fileBytes_[index].load());
+  }
+
+  bool cancelled() const {
+    return options_.cancel && options_.cancel->load();
   }
 
 private:
-  std::vector<std::string> tmpFiles_;
+  const MeshLoadOptions& options_;
+  size_t count_;
+  std::unique_ptr<std::atomic<uint64_t>[]> fileBytes_;
+  std::unique_ptr<std::atomic<uint64_t>[]> fileDone_;
+  std::atomic<uint64_t> done_{0};
+  std::atomic<uint64_t> total_{0};
+};
+
+// What loading one command-line file produced. A file that fails keeps the exit
+// code and message loadMeshes reports if it is the first failure in argument
+// order.
+struct FileLoad {
+  std::string path; // the file to read: the argument, or where stdin was stored
+  bool done = false;
+  bool ok = false;
+  bool cancelled = false;
+  int exitCode = 0;
+  std::string error;
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+  std::shared_ptr<TemporalSource> temporal;
 };
 
+void fail(FileLoad& load, int exitCode, std::string error) {
+  load.done = true;
+  load.ok = false;
+  load.exitCode = exitCode;
+  load.error = std::move(error);
+}
+
+// Select a parser for file `index` and parse it (or take it from the cache).
+// Runs concurrently with the other files' loads, so it builds parsers of its
+// own.
+void parseFile(const std::string& filename,
+               size_t index,
+               FileLoad& load,
+               const MeshLoadOptions& options,
+               const MeshCache& cache,
+               LoadProgress& progress) {
+  // stdin is drained here rather than before the loads start, so the other
+  // files parse while it is still arriving.
+  StdinFile stdinFile;
+  if (filename == "-") {
+    const bool read = stdinFile.open([&progress, index](uint64_t bytes) {
+      progress.grow(index, bytes);
+      return !progress.cancelled();
+    });
+    if (!read) {
+      if (progress.cancelled()) {
+        load.done = true;
+        load.cancelled = true;
+      } else {
+        fail(load, 5, "Failed to read stdin");
+      }
+      return;
+    }
+    load.path = stdinFile.path();
+  }
+
+  auto parsers = buildParsers(options);
+  MeshParser* selected = selectParser(parsers, load.path);
+  if (!selected) {
+    fail(load, 2, "No suitable parser found for file: " + filename);
+    return;
+  }
+  selected->setProgressCallback(
+      [&progress, index](uint64_t bytes) { return progress.advance(index, bytes); });
+
+  // stdin has no stable path or mtime, so it is never cached.
+  const bool cacheable = filename != "-" && !selected->cacheTag().empty();
+  if (cacheable) {
+    load.meshes = cache.load(load.path, selected->cacheTag());
+  }
+  if (load.meshes.empty() && !progress.cancelled()) {
+    // Stamped before parsing: a file rewritten meanwhile must not be cached
+    // under its new stamp with its old contents.
+    const FileStamp parsedStamp = cacheable ? stampOf(load.path) : FileStamp();
+    load.meshes = selected->parse(load.path);
+    if (progress.cancelled()) {
+      load.meshes.clear();
+    } else if (cacheable && !load.meshes.empty()) {
+      // Written while the meshes are assembled and shown.
+      cache.storeInBackground(load.path,
+                              parsedStamp,
+                              selected->cacheTag(),
+                              selected->inputFiles(),
+                              load.meshes);
+    }
+  }
+  load.done = true;
+  if (progress.cancelled()) {
+    load.cancelled = true;
+    return;
+  }
+  progress.finish(index);
+
+  // Capture temporal (playable) info if this file produced it.
+  if (auto temporal = selected->temporal(); temporal && temporal->playable()) {
+    load.temporal = temporal;
+  }
+
+  if (load.meshes.empty()) {
+    fail(load, 3, "Failed to parse mesh: " + filename);
+    return;
+  }
+  load.ok = true;
+}
+
+// One loaded file's parts as a group, numbered from firstPart on.
+LoadedMeshes fileGroup(const std::string& filename,
+                       const std::vector<vtkSmartPointer<vtkDataSet>>& parsedMeshes,
+                       size_t firstPart) {
+  LoadedMeshes meshes;
+  MeshGroup group;
+  group.name = basenameOf(filename);
+
+  for (size_t partIndex = 0; partIndex < parsedMeshes.size(); ++partIndex) {
+    const auto& mesh = parsedMeshes[partIndex];
+    meshes.meshes.push_back(mesh);
+    meshes.names.push_back(filename);
+    const std::string parsedPartName = partNameFromMesh(mesh);
+    if (!parsedPartName.empty()) {
+      meshes.partNames.push_back(parsedPartName);
+    } else if (parsedMeshes.size() == 1) {
+      meshes.partNames.push_back(group.name);
+    } else {
+      meshes.partNames.push_back("Part " + std::to_string(partIndex + 1));
+    }
+
+    std::array<double, 3> parsedColor = {0.0, 0.0, 0.0};
+    const bool hasColor = partColorFromMesh(mesh, parsedColor);
+    meshes.partColors.push_back(parsedColor);
+    meshes.partHasColors.push_back(hasColor);
+    group.partIndices.push_back(firstPart + partIndex);
+  }
+
+  meshes.groups.push_back(std::move(group));
+  return meshes;
+}
+
 } // namespace
 
-MeshLoadResult loadMeshes(const std::vector<std::string>& meshfiles, bool explodeView) {
-  MeshLoadResult result;
-  auto parsers = buildParsers();
-  auto filesToProcess = filesToProcessFromArgs(meshfiles, explodeView);
-  TempFileCleanup tmpCleanup;
+void appendLoadedMeshes(LoadedMeshes& meshes, LoadedMeshes added) {
+  auto append = [](auto& into, auto& from) {
+    into.insert(into.end(),
+                std::make_move_iterator(from.begin()),
+                std::make_move_iterator(from.end()));
+  };
+  append(meshes.meshes, added.meshes);
+  append(meshes.names, added.names);
+  append(meshes.partNames, added.partNames);
+  append(meshes.partColors, added.partColors);
+  meshes.partHasColors.insert(
+      meshes.partHasColors.end(), added.partHasColors.begin(), added.partHasColors.end());
+  append(meshes.groups, added.groups);
+}
 
+MeshLoadResult checkMeshFiles(const std::vector<std::string>& meshfiles,
+                              bool explodeView,
+                              const MeshLoadOptions& options) {
+  MeshLoadResult result;
+  const auto filesToProcess = filesToProcessFromArgs(meshfiles, explodeView);
+  MeshLoadOptions parseOptions = options;
+  parseOptions.fileSeries = options.fileSeries && filesToProcess.size() == 1;
+  const auto parsers = buildParsers(parseOptions);
+  bool stdinClaimed = false;
   for (const std::string& filename : filesToProcess) {
-    std::string realFilename = filename;
-
     if (filename == "-") {
-      std::string tmpFile = stdinToTempFile();
-      if (tmpFile.empty()) {
-        result.ok = false;
+      if (stdinClaimed) {
         result.exitCode = 5;
-        result.error = "Failed to create temp file for stdin";
-        return result;
-      }
-      realFilename = tmpFile;
-      tmpCleanup.add(tmpFile);
-    } else {
-      std::error_code ec;
-      if (!std::filesystem::exists(filename, ec)) {
-        result.ok = false;
-        result.exitCode = 1;
-        result.error = "Error: File does not exist: " + filename;
+        result.error = "Error: stdin (-) can only be read once";
         return result;
       }
+      stdinClaimed = true;
+      continue;
     }
-
-    MeshParser* selected = nullptr;
-    for (auto& parser : parsers) {
-      if (parser->canParse(realFilename)) {
-        selected = parser.get();
-        break;
-      }
+    std::error_code ec;
+    if (!std::filesystem::exists(filename, ec)) {
+      result.exitCode = 1;
+      result.error = "Error: File does not exist: " + filename;
+      return result;
     }
-
-    if (!selected) {
-      result.ok = false;
+    if (!selectParser(parsers, filename)) {
       result.exitCode = 2;
       result.error = "No suitable parser found for file: " + filename;
       return result;
     }
+  }
+  result.ok = true;
+  return result;
+}
 
-    std::vector<vtkSmartPointer<vtkDataSet>> parsedMeshes = selected->parse(realFilename);
+MeshLoadResult loadMeshes(const std::vector<std::string>& meshfiles,
+                          bool explodeView,
+                          const MeshLoadOptions& options) {
+  MeshLoadResult result;
+  auto filesToProcess = filesToProcessFromArgs(meshfiles, explodeView);
+  // Several files are separate meshes, never the steps of one series.
+  MeshLoadOptions parseOptions = options;
+  parseOptions.fileSeries = options.fileSeries && filesToProcess.size() == 1;
+  std::string cacheDirectory;
+  if (options.useCache) {
+    cacheDirectory = options.cacheDirectory.empty() ? MeshCache::defaultDirectory()
+                                                    : options.cacheDirectory;
+  }
+  const MeshCache cache(cacheDirectory);
 
-    // Capture temporal (playable) info if this file produced it.
-    if (const auto* hdfParser = dynamic_cast<const VTKHDFMeshParser*>(selected)) {
-      if (auto temporal = hdfParser->temporal(); temporal && temporal->playable()) {
-        result.temporal = temporal;
-      }
-    }
+  // Check every argument first, in order. stdin can only be drained once; its
+  // size counts towards the progress total as it arrives.
+  std::vector<FileLoad> loads(filesToProcess.size());
+  std::vector<uint64_t> fileBytes(filesToProcess.size(), 0);
+  std::vector<size_t> pending;
+  bool stdinClaimed = false;
+  for (size_t i = 0; i < filesToProcess.size(); ++i) {
+    const std::string& filename = filesToProcess[i];
+    FileLoad& load = loads[i];
+    load.path = filename;
 
-    if (parsedMeshes.empty()) {
-      result.ok = false;
-      result.exitCode = 3;
-      result.error = "Failed to parse mesh: " + filename;
-      return result;
+    if (filename == "-") {
+      if (stdinClaimed) {
+        fail(load, 5, "Error: stdin (-) can only be read once");
+        continue;
+      }
+      stdinClaimed = true;
+    } else {
+      std::error_code ec;
+      if (!std::filesystem::exists(filename, ec)) {
+        fail(load, 1, "Error: File does not exist: " + filename);
+        continue;
+      }
+      const uintmax_t bytes = std::filesystem::file_size(filename, ec);
+      fileBytes[i] = ec ? 0 : static_cast<uint64_t>(bytes);
     }
+    pending.push_back(i);
+  }
+  LoadProgress progress(options, fileBytes);
 
-    MeshGroup group;
-    group.name = basenameOf(filename);
-
-    for (size_t partIndex = 0; partIndex < parsedMeshes.size(); ++partIndex) {
-      const auto& mesh = parsedMeshes[partIndex];
-      const size_t globalIndex = result.meshes.meshes.size();
-      result.meshes.meshes.push_back(mesh);
-      result.meshes.names.push_back(filename);
-      const std::string parsedPartName = partNameFromMesh(mesh);
-      if (!parsedPartName.empty()) {
-        result.meshes.partNames.push_back(parsedPartName);
-      } else if (parsedMeshes.size() == 1) {
-        result.meshes.partNames.push_back(group.name);
-      } else {
-        result.meshes.partNames.push_back("Part " + std::to_string(partIndex + 1));
+  // Files are assembled in argument order as they complete, so group and part
+  // indices do not depend on which file finished first. Assembly stops at the
+  // first file that failed (it decides the error, as if the files had been
+  // loaded one after the other) or was cancelled; files after it are skipped.
+  std::mutex assemblyMutex;
+  size_t nextToAssemble = 0;
+  std::atomic<bool> stopped{false};
+  auto assembleReady = [&]() {
+    for (; nextToAssemble < loads.size() && loads[nextToAssemble].done; ++nextToAssemble) {
+      FileLoad& load = loads[nextToAssemble];
+      if (load.temporal) {
+        result.temporal = load.temporal;
+      }
+      if (!load.ok) {
+        stopped = true;
+        return;
+      }
+      LoadedMeshes added =
+          fileGroup(filesToProcess[nextToAssemble], load.meshes, result.meshes.meshes.size());
+      load.meshes.clear();
+      if (options.onFileLoaded) {
+        options.onFileLoaded(added);
       }
+      appendLoadedMeshes(result.meshes, std::move(added));
+    }
+  };
+  assembleReady();
 
-      std::array<double, 3> parsedColor = {0.0, 0.0, 0.0};
-      const bool hasColor = partColorFromMesh(mesh, parsedColor);
-      result.meshes.partColors.push_back(parsedColor);
-      result.meshes.partHasColors.push_back(hasColor);
-      group.partIndices.push_back(globalIndex);
+  // Files are parsed concurrently, each on its share of the worker threads, so
+  // a multi-file session takes about as long as its slowest file.
+  parallelTasks(pending.size(), [&](size_t task) {
+    const size_t i = pending[task];
+    FileLoad load;
+    load.path = loads[i].path;
+    if (!stopped && !progress.cancelled()) {
+      parseFile(filesToProcess[i], i, load, parseOptions, cache, progress);
+    } else {
+      load.done = true;
+      load.cancelled = true;
     }
+    const std::lock_guard<std::mutex> lock(assemblyMutex);
+    loads[i] = std::move(load);
+    assembleReady();
+  });
 
-    result.meshes.groups.push_back(std::move(group));
+  if (nextToAssemble < loads.size()) {
+    const FileLoad& failed = loads[nextToAssemble];
+    result.ok = false;
+    if (failed.cancelled) {
+      result.cancelled = true;
+      result.exitCode = 0;
+      result.error = "Loading cancelled";
+    } else {
+      result.exitCode = failed.exitCode;
+      result.error = failed.error;
+    }
+    return result;
   }
 
   result.ok = true;
   result.exitCode = 0;
   return result;
 }
+
@@ -1,6 +1,68 @@
 #include "MeshParser.h"
+
+#include "mesh_utils.h"
+
+#include <algorithm>
+#include <utility>
+#include <vtkAlgorithm.h>
+#include <vtkCommand.h>
+
+FileHead FileHead::read(const std::string& path) {
+  return {path, readHeader(path, kBytes)};
+}
+
 MeshParser::~MeshParser() = default;
 
-bool MeshParser::canParse(const std::string&) {
+bool MeshParser::canParse(const FileHead&) {
   return false;
 }
+
+std::shared_ptr<TemporalSource> MeshParser::temporal() const {
+  return nullptr;
+}
+
+std::string MeshParser::cacheTag() const {
+  return {};
+}
+
+std::vector<std::string> MeshParser::inputFiles() const {
+  return {};
+}
+
+void MeshParser::setProgressCallback(ProgressCallback callback) {
+  progress_ = std::move(callback);
+}
+
+bool MeshParser::advance(uint64_t bytes) const {
+  return !progress_ || progress_(bytes);
+}
+
+void MeshParser::setInputBacking(ByteSource::Backing backing) {
+  inputBacking_ = backing;
+}
+
+bool MeshParser::openInput(ByteSource& source, const std::string& path) const {
+  return source.open(path, inputBacking_);
+}
+
+VtkProgressRelay::VtkProgressRelay(const MeshParser& parser,
+                                   vtkAlgorithm* algorithm,
+                                   uint64_t bytes)
+    : parser_(parser), algorithm_(algorithm), bytes_(bytes) {
+  observer_ =
+      algorithm_->AddObserver(vtkCommand::ProgressEvent, this, &VtkProgressRelay::onProgress);
+}
+
+VtkProgressRelay::~VtkProgressRelay() {
+  algorithm_->RemoveObserver(observer_);
+}
+
+void VtkProgressRelay::onProgress(vtkObject*, unsigned long, void* callData) {
+  const double fraction = std::clamp(*static_cast<double*>(callData), 0.0, 1.0);
+  const auto target = static_cast<uint64_t>(fraction * static_cast<double>(bytes_));
+  const uint64_t step = target > reported_ ? target - reported_ : 0;
+  reported_ += step;
+  if (!parser_.advance(step)) {
+    algorithm_->AbortExecuteOn();
+  }
+}
@@ -52,7 +52,7 @@ void MeshRenderer::setup(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
                          const std::vector<std::array<double, 3>>& colorsHex) {
   (void)names;
   renderer = vtkSmartPointer<vtkRenderer>::New();
-  sceneMeshes = meshes;
+  sceneMeshes.clear();
   facetPanels.clear();
 
   if (!context.window) {
@@ -60,22 +60,8 @@ void MeshRenderer::setup(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
   }
   mappers.clear();
   context.actors.clear();
-  for (size_t i = 0; i < meshes.size(); ++i) {
-    vtkNew<vtkDataSetMapper> mapper;
-    mapper->SetInputData(meshes[i]);
-    mapper->ScalarVisibilityOff();
-    vtkNew<vtkActor> actor;
-    actor->SetMapper(mapper);
-    actor->GetProperty()->SetColor(colorsHex[i][0], colorsHex[i][1], colorsHex[i][2]);
-    actor->GetProperty()->SetOpacity(1.0);
-    if (vtkUnstructuredGrid::SafeDownCast(meshes[i])) {
-      actor->GetProperty()->SetRepresentationToSurface();
-    }
-    renderer->AddActor(actor);
-    mappers.push_back(mapper);
-    context.actors.push_back(actor);
-  }
-  context.colorsHex = colorsHex;
+  context.colorsHex.clear();
+  addActors(meshes, colorsHex);
 
   context.window->AddRenderer(renderer);
   if (!embeddedMode) {
@@ -103,6 +89,42 @@ void MeshRenderer::setup(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
   clearActiveScalar();
 }
 
+void MeshRenderer::addMeshes(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                             const std::vector<std::array<double, 3>>& colorsHex) {
+  if (!renderer || meshes.empty()) {
+    return;
+  }
+  const bool wasEmpty = sceneMeshes.empty();
+  addActors(meshes, colorsHex);
+  if (wasEmpty) {
+    renderer->ResetCamera();
+  }
+  if (context.window) {
+    context.window->Render();
+  }
+}
+
+void MeshRenderer::addActors(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                             const std::vector<std::array<double, 3>>& colorsHex) {
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    vtkNew<vtkDataSetMapper> mapper;
+    mapper->SetInputData(meshes[i]);
+    mapper->ScalarVisibilityOff();
+    vtkNew<vtkActor> actor;
+    actor->SetMapper(mapper);
+    actor->GetProperty()->SetColor(colorsHex[i][0], colorsHex[i][1], colorsHex[i][2]);
+    actor->GetProperty()->SetOpacity(1.0);
+    if (vtkUnstructuredGrid::SafeDownCast(meshes[i])) {
+      actor->GetProperty()->SetRepresentationToSurface();
+    }
+    renderer->AddActor(actor);
+    sceneMeshes.push_back(meshes[i]);
+    mappers.push_back(mapper);
+    context.actors.push_back(actor);
+    context.colorsHex.push_back(colorsHex[i]);
+  }
+}
+
 void MeshRenderer::start() {
   context.window->Render();
   if (!embeddedMode) {
@@ -114,35 +136,6 @@ void MeshRenderer::setupFacetGrid(const std::vector<vtkSmartPointer<vtkDataSet>>
                                   const std::vector<std::string>& names,
                                   const std::vector<std::array<double, 3>>& colorsHex) {
   (void)names;
-  if (meshes.empty())
-    return;
-
-  // Collect all (mesh_index, scalar_name, association) tuples — one facet per
-  // scalar, point and cell fields alike.
-  struct MeshScalarPair {
-    size_t meshIndex;
-    std::string scalarName;
-    FieldAssociation association;
-  };
-  std::vector<MeshScalarPair> pairs;
-  for (size_t j = 0; j < meshes.size(); ++j) {
-    if (auto* pd = meshes[j]->GetPointData()) {
-      for (int i = 0; i < pd->GetNumberOfArrays(); ++i) {
-        if (auto* a = pd->GetArray(i); a && a->GetName()) {
-          pairs.push_back({j, a->GetName(), FieldAssociation::Point});
-        }
-      }
-    }
-    if (auto* cd = meshes[j]->GetCellData()) {
-      for (int i = 0; i < cd->GetNumberOfArrays(); ++i) {
-        if (auto* a = cd->GetArray(i); a && a->GetName()) {
-          pairs.push_back({j, a->GetName(), FieldAssociation::Cell});
-        }
-      }
-    }
-  }
-  if (pairs.empty())
-    return;
 
   if (!context.window) {
     context.window = vtkSmartPointer<vtkRenderWindow>::New();
@@ -169,27 +162,100 @@ void MeshRenderer::setupFacetGrid(const std::vector<vtkSmartPointer<vtkDataSet>>
     context.window->RemoveRenderer(existing);
   }
 
-  const size_t n = pairs.size();
-  const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
-  const int rows = static_cast<int>(std::ceil(static_cast<double>(n) / cols));
-
   mappers.clear();
   context.actors.clear();
+  context.colorsHex.clear();
   facetPanels.clear();
-  context.colorsHex = colorsHex;
+  facetMeshCount = 0;
+  facetBounds.Reset();
 
-  for (size_t i = 0; i < n; ++i) {
-    const int r = static_cast<int>(i) / cols, c = static_cast<int>(i) % cols;
-    const double xmin = double(c) / cols, xmax = double(c + 1) / cols;
-    const double ymin = 1.0 - double(r + 1) / rows, ymax = 1.0 - double(r) / rows;
+  if (!camLinkCb_)
+    camLinkCb_ = vtkSmartPointer<vtkCallbackCommand>::New();
+  camLinkCb_->SetClientData(context.window);
+  camLinkCb_->SetCallback([](vtkObject* caller, unsigned long, void* cd, void*) {
+    auto* src = vtkCamera::SafeDownCast(caller);
+    auto* win = static_cast<vtkRenderWindow*>(cd);
+    if (!src || !win)
+      return;
+    auto* r = win->GetRenderers();
+    vtkCollectionSimpleIterator it;
+    r->InitTraversal(it);
+    for (vtkRenderer* ren = r->GetNextRenderer(it); ren; ren = r->GetNextRenderer(it)) {
+      auto* cam = ren->GetActiveCamera();
+      if (cam && cam != src)
+        cam->DeepCopy(src);
+    }
+  });
 
-    auto ren = vtkSmartPointer<vtkRenderer>::New();
-    ren->SetViewport(xmin, ymin, xmax, ymax);
-    context.window->AddRenderer(ren);
+  appendFacetPanels(meshes, colorsHex);
+
+  if (!interactor) {
+    interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+  }
+  if (interactor->GetRenderWindow() != context.window) {
+    interactor->SetRenderWindow(context.window);
+  }
+  interactor->SetRecognizeGestures(false);
+  interactor->SetDesiredUpdateRate(120.0);
+  interactor->SetStillUpdateRate(45.0);
+  auto style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
+  style->SetMotionFactor(10.0);
+  interactor->SetInteractorStyle(style);
+}
+
+void MeshRenderer::addFacetMeshes(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                                  const std::vector<std::array<double, 3>>& colorsHex) {
+  if (!context.window || meshes.empty()) {
+    return;
+  }
+  appendFacetPanels(meshes, colorsHex);
+  context.window->Render();
+}
+
+void MeshRenderer::appendFacetPanels(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                                     const std::vector<std::array<double, 3>>& colorsHex) {
+  // Collect all (mesh_index, scalar_name, association) tuples — one facet per
+  // scalar, point and cell fields alike.
+  struct MeshScalarPair {
+    size_t meshIndex;
+    std::string scalarName;
+    FieldAssociation association;
+  };
+  std::vector<MeshScalarPair> pairs;
+  for (size_t j = 0; j < meshes.size(); ++j) {
+    if (auto* pd = meshes[j]->GetPointData()) {
+      for (int i = 0; i < pd->GetNumberOfArrays(); ++i) {
+        if (auto* a = pd->GetArray(i); a && a->GetName()) {
+          pairs.push_back({j, a->GetName(), FieldAssociation::Point});
+        }
+      }
+    }
+    if (auto* cd = meshes[j]->GetCellData()) {
+      for (int i = 0; i < cd->GetNumberOfArrays(); ++i) {
+        if (auto* a = cd->GetArray(i); a && a->GetName()) {
+          pairs.push_back({j, a->GetName(), FieldAssociation::Cell});
+        }
+      }
+    }
+  }
+  context.colorsHex.insert(context.colorsHex.end(), colorsHex.begin(), colorsHex.end());
+  const size_t firstMesh = facetMeshCount;
+  facetMeshCount += meshes.size();
+  for (auto& p : meshes) {
+    double bb[6];
+    p->GetBounds(bb);
+    facetBounds.AddBounds(bb);
+  }
+  if (pairs.empty())
+    return;
 
-    const auto& pair = pairs[i];
+  const size_t firstPanel = facetPanels.size();
+  for (const auto& pair : pairs) {
     auto& srcMesh = meshes[pair.meshIndex];
 
+    auto ren = vtkSmartPointer<vtkRenderer>::New();
+    context.window->AddRenderer(ren);
+
     vtkNew<vtkDataSetMapper> mapper;
     mapper->SetInputData(srcMesh);
     mapper->SelectColorArray(pair.scalarName.c_str());
@@ -200,48 +266,33 @@ void MeshRenderer::setupFacetGrid(const std::vector<vtkSmartPointer<vtkDataSet>>
     }
     mapper->SetColorModeToMapScalars();
 
+    FacetPanelState panel;
+    panel.renderer = ren;
+    panel.mapper = mapper;
+    panel.title = pair.scalarName;
     auto* arr = arrayForAssociation(srcMesh, pair.scalarName, pair.association);
     if (arr) {
       double range[2];
       arr->GetRange(range);
-      std::vector<vtkDataSet*> allPtrs = rawMeshPointers(meshes);
-      auto analysis = analyzeScalar(allPtrs, pair.scalarName, pair.association);
-      if (analysis.categorical && sharedCatAnalysis.categorical)
-        analysis = sharedCatAnalysis;
-      auto lut = buildLookupTable(analysis, range);
-      mapper->SetLookupTable(lut);
-      mapper->SetScalarRange(range);
-      mapper->ScalarVisibilityOn();
-
-      FacetPanelState panel;
-      panel.mapper = mapper;
-      panel.title = pair.scalarName;
-      panel.analysis = std::move(analysis);
+      // A panel shows one mesh's scalar: analyze that mesh alone, so meshes
+      // arriving later add their own panels without revisiting these.
+      panel.hasScalar = true;
+      panel.meshAnalysis = analyzeScalar({srcMesh.GetPointer()}, pair.scalarName, pair.association);
       panel.globalRange[0] = range[0];
       panel.globalRange[1] = range[1];
       panel.clipRange[0] = range[0];
       panel.clipRange[1] = range[1];
-      panel.viewport[0] = xmin;
-      panel.viewport[1] = ymin;
-      panel.viewport[2] = xmax;
-      panel.viewport[3] = ymax;
-      facetPanels.push_back(std::move(panel));
+      applyFacetPanelAnalysis(panel);
+      mapper->ScalarVisibilityOn();
     } else {
       mapper->ScalarVisibilityOff();
-
-      FacetPanelState panel;
-      panel.mapper = mapper;
-      panel.title = pair.scalarName;
-      panel.viewport[0] = xmin;
-      panel.viewport[1] = ymin;
-      panel.viewport[2] = xmax;
-      panel.viewport[3] = ymax;
-      facetPanels.push_back(std::move(panel));
     }
+    facetPanels.push_back(std::move(panel));
 
+    const size_t meshIndex = firstMesh + pair.meshIndex;
     auto color = (pair.meshIndex < colorsHex.size())
                      ? colorsHex[pair.meshIndex]
-                     : generateDistinctColor(static_cast<int>(pair.meshIndex));
+                     : generateDistinctColor(static_cast<int>(meshIndex));
     vtkNew<vtkActor> actor;
     actor->SetMapper(mapper);
     actor->GetProperty()->SetColor(color[0], color[1], color[2]);
@@ -250,64 +301,59 @@ void MeshRenderer::setupFacetGrid(const std::vector<vtkSmartPointer<vtkDataSet>>
     context.actors.push_back(actor);
   }
 
-  vtkBoundingBox bbox;
-  for (auto& p : meshes) {
-    double bb[6];
-    p->GetBounds(bb);
-    bbox.AddBounds(bb);
-  }
-  double ub[6];
-  bbox.GetBounds(ub);
+  layoutFacetPanels();
 
+  // Frame the meshes loaded so far; every panel shares the one view.
+  double ub[6];
+  facetBounds.GetBounds(ub);
   auto tmplRen = vtkSmartPointer<vtkRenderer>::New();
   auto tmplCam = vtkSmartPointer<vtkCamera>::New();
   tmplRen->SetActiveCamera(tmplCam);
   tmplRen->ResetCamera(ub);
 
-  auto* rens = context.window->GetRenderers();
-  vtkCollectionSimpleIterator cookie;
-  rens->InitTraversal(cookie);
-  for (vtkRenderer* ren = rens->GetNextRenderer(cookie); ren; ren = rens->GetNextRenderer(cookie)) {
-    auto cam = vtkSmartPointer<vtkCamera>::New();
-    cam->DeepCopy(tmplCam);
-    ren->SetActiveCamera(cam);
+  for (size_t i = 0; i < facetPanels.size(); ++i) {
+    vtkRenderer* ren = facetPanels[i].renderer;
+    if (i < firstPanel) {
+      ren->GetActiveCamera()->DeepCopy(tmplCam);
+    } else {
+      auto cam = vtkSmartPointer<vtkCamera>::New();
+      cam->DeepCopy(tmplCam);
+      ren->SetActiveCamera(cam);
+    }
     ren->ResetCameraClippingRange(ub);
   }
+  for (size_t i = firstPanel; i < facetPanels.size(); ++i)
+    facetPanels[i].renderer->GetActiveCamera()->AddObserver(vtkCommand::ModifiedEvent, camLinkCb_);
+}
 
-  if (!camLinkCb_)
-    camLinkCb_ = vtkSmartPointer<vtkCallbackCommand>::New();
-  camLinkCb_->SetClientData(context.window);
-  camLinkCb_->SetCallback([](vtkObject* caller, unsigned long, void* cd, void*) {
-    auto* src = vtkCamera::SafeDownCast(caller);
-    auto* win = static_cast<vtkRenderWindow*>(cd);
-    if (!src || !win)
-      return;
-    auto* r = win->GetRenderers();
-    vtkCollectionSimpleIterator it;
-    r->InitTraversal(it);
-    for (vtkRenderer* ren = r->GetNextRenderer(it); ren; ren = r->GetNextRenderer(it)) {
-      auto* cam = ren->GetActiveCamera();
-      if (cam && cam != src)
-        cam->DeepCopy(src);
-    }
-  });
-
-  rens->InitTraversal(cookie);
-  for (vtkRenderer* ren = rens->GetNextRenderer(cookie); ren; ren = rens->GetNextRenderer(cookie))
-    ren->GetActiveCamera()->AddObserver(vtkCommand::ModifiedEvent, camLinkCb_);
-
-  if (!interactor) {
-    interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+void MeshRenderer::layoutFacetPanels() {
+  const size_t n = facetPanels.size();
+  if (n == 0)
+    return;
+  const int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+  const int rows = static_cast<int>(std::ceil(static_cast<double>(n) / cols));
+  for (size_t i = 0; i < n; ++i) {
+    const int r = static_cast<int>(i) / cols, c = static_cast<int>(i) % cols;
+    FacetPanelState& panel = facetPanels[i];
+    panel.viewport[0] = double(c) / cols;
+    panel.viewport[1] = 1.0 - double(r + 1) / rows;
+    panel.viewport[2] = double(c + 1) / cols;
+    panel.viewport[3] = 1.0 - double(r) / rows;
+    panel.renderer->SetViewport(panel.viewport);
   }
-  if (interactor->GetRenderWindow() != context.window) {
-    interactor->SetRenderWindow(context.window);
+}
+
+void MeshRenderer::applyFacetPanelAnalysis(FacetPanelState& panel) {
+  panel.analysis = panel.meshAnalysis;
+  if (panel.analysis.categorical && !panel.analysis.lookupTable && sharedCatAnalysis.categorical)
+    panel.analysis = sharedCatAnalysis;
+  if (panel.analysis.directColors) {
+    panel.mapper->SetColorModeToDirectScalars();
+    return;
   }
-  interactor->SetRecognizeGestures(false);
-  interactor->SetDesiredUpdateRate(120.0);
-  interactor->SetStillUpdateRate(45.0);
-  auto style = vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New();
-  style->SetMotionFactor(10.0);
-  interactor->SetInteractorStyle(style);
+  auto lut = buildLookupTable(panel.analysis, panel.clipRange);
+  panel.mapper->SetLookupTable(lut);
+  panel.mapper->SetScalarRange(panel.clipRange);
 }
 
 void MeshRenderer::startFacetGrid() {
@@ -335,7 +381,8 @@ bool MeshRenderer::setActiveScalar(const std::string& scalarName, FieldAssociati
   activeScalarName = scalarName;
   activeScalarAssociation = association;
   activeScalarAnalysis = analyzeScalar(meshPtrs, scalarName, association);
-  if (activeScalarAnalysis.categorical && sharedCatAnalysis.categorical)
+  if (activeScalarAnalysis.categorical && !activeScalarAnalysis.lookupTable &&
+      sharedCatAnalysis.categorical)
     activeScalarAnalysis = sharedCatAnalysis;
   activeScalarGlobalRange[0] = range[0];
   activeScalarGlobalRange[1] = range[1];
@@ -447,6 +494,12 @@ const ScalarAnalysis& MeshRenderer::getActiveScalarAnalysis() const {
 
 void MeshRenderer::setSharedCatAnalysis(const ScalarAnalysis& shared) {
   sharedCatAnalysis = shared;
+  // Facet panels keep their own mesh's analysis; only the table they color
+  // with changes.
+  for (FacetPanelState& panel : facetPanels) {
+    if (panel.hasScalar && panel.meshAnalysis.categorical && !panel.meshAnalysis.lookupTable)
+      applyFacetPanelAnalysis(panel);
+  }
 }
 
 vtkLookupTable* MeshRenderer::getActiveLUT() const {
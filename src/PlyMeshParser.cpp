@@ -0,0 +1,739 @@
+#include "PlyMeshParser.h"
+
+#include "ByteSource.h"
+#include "parallel_utils.h"
+#include "text_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkUnsignedCharArray.h>
+
+namespace {
+
+enum class PlyFormat { Ascii, BinaryLittleEndian, BinaryBigEndian };
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+bool parseType(std::string_view name, PlyType& type) {
+  static const std::pair<std::string_view, PlyType> names[] = {
+      {"char", PlyType::Int8},      {"int8", PlyType::Int8},       {"uchar", PlyType::UInt8},
+      {"uint8", PlyType::UInt8},    {"short", PlyType::Int16},     {"int16", PlyType::Int16},
+      {"ushort", PlyType::UInt16},  {"uint16", PlyType::UInt16},   {"int", PlyType::Int32},
+      {"int32", PlyType::Int32},    {"uint", PlyType::UInt32},     {"uint32", PlyType::UInt32},
+      {"float", PlyType::Float32},  {"float32", PlyType::Float32}, {"double", PlyType::Float64},
+      {"float64", PlyType::Float64}};
+  for (const auto& [key, value] : names) {
+    if (key == name) {
+      type = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t sizeOf(PlyType type) {
+  switch (type) {
+  case PlyType::Int8:
+  case PlyType::UInt8:
+    return 1;
+  case PlyType::Int16:
+  case PlyType::UInt16:
+    return 2;
+  case PlyType::Int32:
+  case PlyType::UInt32:
+  case PlyType::Float32:
+    return 4;
+  case PlyType::Float64:
+    return 8;
+  }
+  return 0;
+}
+
+bool isReal(PlyType type) {
+  return type == PlyType::Float32 || type == PlyType::Float64;
+}
+
+struct PlyProperty {
+  std::string name;
+  PlyType type = PlyType::Float32;
+  bool list = false;
+  PlyType countType = PlyType::UInt8; // lists only
+};
+
+struct PlyElement {
+  std::string name;
+  size_t count = 0;
+  std::vector<PlyProperty> properties;
+
+  // Bytes per binary instance, or 0 when a list makes it vary.
+  size_t fixedStride() const {
+    size_t stride = 0;
+    for (const PlyProperty& property : properties) {
+      if (property.list)
+        return 0;
+      stride += sizeOf(property.type);
+    }
+    return stride;
+  }
+};
+
+struct PlyHeader {
+  PlyFormat format = PlyFormat::Ascii;
+  std::vector<PlyElement> elements;
+  const char* data = nullptr; // first byte after end_header
+};
+
+std::vector<std::string_view> splitWords(std::string_view line) {
+  std::vector<std::string_view> words;
+  size_t pos = 0;
+  while ((pos = line.find_first_not_of(" \t", pos)) != std::string_view::npos) {
+    const size_t end = std::min(line.find_first_of(" \t", pos), line.size());
+    words.push_back(line.substr(pos, end - pos));
+    pos = end;
+  }
+  return words;
+}
+
+bool readHeader(const char* begin, const char* end, PlyHeader& header) {
+  LineReader lines(begin, end);
+  std::string_view line;
+  if (!lines.next(line) || line != "ply")
+    return false;
+  bool haveFormat = false;
+  while (lines.next(line)) {
+    const std::vector<std::string_view> words = splitWords(line);
+    if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+      continue;
+    if (words[0] == "end_header") {
+      header.data = lines.position();
+      return haveFormat;
+    }
+    if (words[0] == "format" && words.size() >= 2) {
+      if (words[1] == "ascii")
+        header.format = PlyFormat::Ascii;
+      else if (words[1] == "binary_little_endian")
+        header.format = PlyFormat::BinaryLittleEndian;
+      else if (words[1] == "binary_big_endian")
+        header.format = PlyFormat::BinaryBigEndian;
+      else
+        return false;
+      haveFormat = true;
+    } else if (words[0] == "element" && words.size() == 3) {
+      PlyElement element;
+      element.name = std::string(words[1]);
+      const char* p = words[2].data();
+      if (!scanInt(p, words[2].data() + words[2].size(), element.count))
+        return false;
+      header.elements.push_back(std::move(element));
+    } else if (words[0] == "property" && !header.elements.empty()) {
+      PlyProperty property;
+      if (words.size() == 5 && words[1] == "list") {
+        property.list = true;
+        if (!parseType(words[2], property.countType) || isReal(property.countType) ||
+            !parseType(words[3], property.type))
+          return false;
+      } else if (words.size() != 3 || !parseType(words[1], property.type)) {
+        return false;
+      }
+      property.name = std::string(words.back());
+      header.elements.back().properties.push_back(std::move(property));
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+template <typename T> double loadValue(const char* p, bool swap) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, p, sizeof(T));
+  if (swap)
+    std::reverse(bytes, bytes + sizeof(T));
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return static_cast<double>(value);
+}
+
+double loadAs(const char* p, PlyType type, bool swap) {
+  switch (type) {
+  case PlyType::Int8:
+    return loadValue<int8_t>(p, swap);
+  case PlyType::UInt8:
+    return loadValue<uint8_t>(p, swap);
+  case PlyType::Int16:
+    return loadValue<int16_t>(p, swap);
+  case PlyType::UInt16:
+    return loadValue<uint16_t>(p, swap);
+  case PlyType::Int32:
+    return loadValue<int32_t>(p, swap);
+  case PlyType::UInt32:
+    return loadValue<uint32_t>(p, swap);
+  case PlyType::Float32:
+    return loadValue<float>(p, swap);
+  case PlyType::Float64:
+    return loadValue<double>(p, swap);
+  }
+  return 0.0;
+}
+
+// Value-at-a-time readers for elements decoded sequentially (ascii files and
+// binary elements whose size varies per instance).
+class BinaryCursor {
+public:
+  BinaryCursor(const char* p, const char* end, bool swap) : p_(p), end_(end), swap_(swap) {
+  }
+  bool read(PlyType type, double& value) {
+    const size_t size = sizeOf(type);
+    if (static_cast<size_t>(end_ - p_) < size)
+      return false;
+    value = loadAs(p_, type, swap_);
+    p_ += size;
+    return true;
+  }
+  const char* position() const {
+    return p_;
+  }
+
+private:
+  const char* p_;
+  const char* end_;
+  bool swap_;
+};
+
+class AsciiCursor {
+public:
+  AsciiCursor(const char* p, const char* end) : p_(p), end_(end) {
+  }
+  bool read(PlyType, double& value) {
+    return scanReal(p_, end_, value);
+  }
+  const char* position() const {
+    return p_;
+  }
+
+private:
+  const char* p_;
+  const char* end_;
+};
+
+// Where one property's values go: a component of a VTK array, or nowhere.
+struct Sink {
+  float* real = nullptr;
+  int* integer = nullptr;
+  unsigned char* color = nullptr;
+  size_t stride = 1;       // components of the destination array
+  bool unitColor = false; // real-valued color channel in [0, 1]
+
+  void write(size_t row, double value) const {
+    const size_t at = row * stride;
+    if (real) {
+      real[at] = static_cast<float>(value);
+    } else if (integer) {
+      integer[at] = static_cast<int>(value);
+    } else if (color) {
+      const double byte = std::round(unitColor ? value * 255.0 : value);
+      color[at] = static_cast<unsigned char>(std::clamp(byte, 0.0, 255.0));
+    }
+  }
+};
+
+// The VTK arrays one element's properties decode into, with a Sink per property.
+struct ElementArrays {
+  std::vector<Sink> sinks;
+  vtkSmartPointer<vtkFloatArray> coords; // vertex x/y/z
+  vtkSmartPointer<vtkFloatArray> normals;
+  std::vector<vtkSmartPointer<vtkDataArray>> attributes;
+};
+
+int findProperty(const PlyElement& element, std::string_view name) {
+  for (size_t i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty& property = element.properties[i];
+    if (!property.list && property.name == name)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+// "red" or "diffuse_red", ...
+int findColorChannel(const PlyElement& element, const char* channel) {
+  const int plain = findProperty(element, channel);
+  return plain >= 0 ? plain : findProperty(element, std::string("diffuse_") + channel);
+}
+
+ElementArrays makeArrays(const PlyElement& element, bool withPoints) {
+  ElementArrays arrays;
+  arrays.sinks.resize(element.properties.size());
+  const auto rows = static_cast<vtkIdType>(element.count);
+  std::vector<bool> used(element.properties.size());
+
+  // A vector property (x/y/z, nx/ny/nz): one float array with three components.
+  auto vector3 = [&](const char* const names[3]) -> vtkSmartPointer<vtkFloatArray> {
+    int index[3];
+    for (int c = 0; c < 3; ++c) {
+      index[c] = findProperty(element, names[c]);
+      if (index[c] < 0)
+        return nullptr;
+    }
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetNumberOfComponents(3);
+    array->SetNumberOfTuples(rows);
+    for (size_t c = 0; c < 3; ++c) {
+      const auto i = static_cast<size_t>(index[c]);
+      arrays.sinks[i].real = array->GetPointer(0) + c;
+      arrays.sinks[i].stride = 3;
+      used[i] = true;
+    }
+    return array;
+  };
+  if (withPoints) {
+    static const char* const xyz[3] = {"x", "y", "z"};
+    arrays.coords = vector3(xyz);
+  }
+  static const char* const nxyz[3] = {"nx", "ny", "nz"};
+  arrays.normals = vector3(nxyz);
+  if (arrays.normals)
+    arrays.normals->SetName("Normals");
+
+  const int red = findColorChannel(element, "red");
+  const int green = findColorChannel(element, "green");
+  const int blue = findColorChannel(element, "blue");
+  const int alpha = findColorChannel(element, "alpha");
+  if (red >= 0 && green >= 0 && blue >= 0) {
+    const int channels[4] = {red, green, blue, alpha};
+    const size_t components = alpha >= 0 ? 4 : 3;
+    vtkNew<vtkUnsignedCharArray> colors;
+    colors->SetName(components == 4 ? "RGBA" : "RGB");
+    colors->SetNumberOfComponents(static_cast<int>(components));
+    colors->SetNumberOfTuples(rows);
+    for (size_t c = 0; c < components; ++c) {
+      const auto i = static_cast<size_t>(channels[c]);
+      arrays.sinks[i].color = colors->GetPointer(0) + c;
+      arrays.sinks[i].stride = components;
+      arrays.sinks[i].unitColor = isReal(element.properties[i].type);
+      used[i] = true;
+    }
+    arrays.attributes.push_back(colors);
+  }
+
+  // Everything else that is a single value becomes a scalar array of its own.
+  for (size_t i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty& property = element.properties[i];
+    if (used[i] || property.list)
+      continue;
+    if (isReal(property.type)) {
+      vtkNew<vtkFloatArray> values;
+      values->SetName(property.name.c_str());
+      values->SetNumberOfValues(rows);
+      arrays.sinks[i].real = values->GetPointer(0);
+      arrays.attributes.push_back(values);
+    } else {
+      vtkNew<vtkIntArray> values;
+      values->SetName(property.name.c_str());
+      values->SetNumberOfValues(rows);
+      arrays.sinks[i].integer = values->GetPointer(0);
+      arrays.attributes.push_back(values);
+    }
+  }
+  return arrays;
+}
+
+// Rows per parallelFor task when decoding binary elements.
+constexpr size_t kRowsPerTask = size_t{1} << 16;
+
+// Binary element without lists: every instance has the same layout, so rows
+// decode independently.
+void decodeFixed(const MeshParser& parser,
+                 const PlyElement& element,
+                 const char* data,
+                 bool swap,
+                 const std::vector<Sink>& sinks) {
+  const size_t stride = element.fixedStride();
+  std::vector<size_t> offsets;
+  size_t offset = 0;
+  for (const PlyProperty& property : element.properties) {
+    offsets.push_back(offset);
+    offset += sizeOf(property.type);
+  }
+  const size_t tasks = (element.count + kRowsPerTask - 1) / kRowsPerTask;
+  parallelFor(tasks, [&](size_t task) {
+    if (parser.cancelled())
+      return;
+    const size_t last = std::min(element.count, (task + 1) * kRowsPerTask);
+    for (size_t row = task * kRowsPerTask; row < last; ++row) {
+      const char* instance = data + row * stride;
+      for (size_t k = 0; k < sinks.size(); ++k)
+        sinks[k].write(row, loadAs(instance + offsets[k], element.properties[k].type, swap));
+    }
+    parser.advance((last - task * kRowsPerTask) * stride);
+  });
+}
+
+// Polygon lists collected one face at a time.
+struct FaceLists {
+  size_t property = 0; // index of the vertex_indices list
+  std::vector<vtkIdType> offsets{0};
+  std::vector<vtkIdType> connectivity;
+};
+
+// Decode one element a value at a time; list properties other than the face
+// list are read and dropped. Also fails once the load is cancelled.
+template <typename Cursor>
+bool decodeSequential(const MeshParser& parser,
+                      const PlyElement& element,
+                      Cursor& cursor,
+                      const std::vector<Sink>& sinks,
+                      FaceLists* faces) {
+  double value = 0.0;
+  const char* reported = cursor.position();
+  for (size_t row = 0; row < element.count; ++row) {
+    if (row % kRowsPerTask == kRowsPerTask - 1) {
+      if (!parser.advance(static_cast<uint64_t>(cursor.position() - reported)))
+        return false;
+      reported = cursor.position();
+    }
+    for (size_t k = 0; k < element.properties.size(); ++k) {
+      const PlyProperty& property = element.properties[k];
+      if (!property.list) {
+        if (!cursor.read(property.type, value))
+          return false;
+        if (k < sinks.size())
+          sinks[k].write(row, value);
+        continue;
+      }
+      double count = 0.0;
+      if (!cursor.read(property.countType, count) || count < 0.0)
+        return false;
+      const bool keep = faces && k == faces->property;
+      for (auto n = static_cast<size_t>(count); n > 0; --n) {
+        if (!cursor.read(property.type, value))
+          return false;
+        if (keep)
+          faces->connectivity.push_back(static_cast<vtkIdType>(value));
+      }
+      if (keep)
+        faces->offsets.push_back(static_cast<vtkIdType>(faces->connectivity.size()));
+    }
+  }
+  return true;
+}
+
+// Binary faces that all have the same number of corners (almost always 3) have
+// a fixed stride after all. Returns that corner count, or 0 if they do not.
+size_t uniformCorners(const PlyElement& element,
+                      size_t list,
+                      const char* data,
+                      const char* end,
+                      bool swap,
+                      size_t& stride) {
+  const PlyProperty& indices = element.properties[list];
+  size_t before = 0;
+  size_t after = 0;
+  for (size_t k = 0; k < element.properties.size(); ++k) {
+    const PlyProperty& property = element.properties[k];
+    if (k == list)
+      continue;
+    if (property.list)
+      return 0;
+    (k < list ? before : after) += sizeOf(property.type);
+  }
+  const size_t countSize = sizeOf(indices.countType);
+  if (element.count == 0 || static_cast<size_t>(end - data) < before + countSize)
+    return 0;
+  const double first = loadAs(data + before, indices.countType, swap);
+  if (first < 1.0)
+    return 0;
+  const auto corners = static_cast<size_t>(first);
+  stride = before + countSize + corners * sizeOf(indices.type) + after;
+  if (static_cast<size_t>(end - data) / stride < element.count)
+    return 0;
+
+  std::atomic<bool> uniform{true};
+  const size_t tasks = (element.count + kRowsPerTask - 1) / kRowsPerTask;
+  parallelFor(tasks, [&](size_t task) {
+    const size_t last = std::min(element.count, (task + 1) * kRowsPerTask);
+    for (size_t row = task * kRowsPerTask; row < last && uniform.load(); ++row) {
+      if (loadAs(data + row * stride + before, indices.countType, swap) != first)
+        uniform = false;
+    }
+  });
+  return uniform ? corners : 0;
+}
+
+// Decode uniform binary faces in parallel straight into the cell arrays.
+// Returns null if an index is out of range.
+template <typename ArrayT>
+vtkSmartPointer<vtkCellArray> decodeUniformFaces(const MeshParser& parser,
+                                                 const PlyElement& element,
+                                                 size_t list,
+                                                 size_t corners,
+                                                 size_t stride,
+                                                 const char* data,
+                                                 bool swap,
+                                                 const std::vector<Sink>& sinks,
+                                                 size_t pointCount) {
+  using Value = typename ArrayT::ValueType;
+  std::vector<size_t> offsets;
+  size_t offset = 0;
+  for (size_t k = 0; k < element.properties.size(); ++k) {
+    offsets.push_back(offset);
+    const PlyProperty& property = element.properties[k];
+    offset += k == list ? sizeOf(property.countType) + corners * sizeOf(property.type)
+                        : sizeOf(property.type);
+  }
+  const PlyProperty& indices = element.properties[list];
+  const size_t indexSize = sizeOf(indices.type);
+  const size_t firstIndex = offsets[list] + sizeOf(indices.countType);
+
+  vtkNew<ArrayT> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(element.count * corners));
+  Value* ids = connectivity->GetPointer(0);
+  const auto limit = static_cast<double>(pointCount);
+  std::atomic<bool> valid{true};
+  const size_t tasks = (element.count + kRowsPerTask - 1) / kRowsPerTask;
+  parallelFor(tasks, [&](size_t task) {
+    if (parser.cancelled())
+      return;
+    const size_t last = std::min(element.count, (task + 1) * kRowsPerTask);
+    for (size_t row = task * kRowsPerTask; row < last; ++row) {
+      const char* instance = data + row * stride;
+      for (size_t k = 0; k < sinks.size(); ++k) {
+        if (k != list)
+          sinks[k].write(row, loadAs(instance + offsets[k], element.properties[k].type, swap));
+      }
+      for (size_t c = 0; c < corners; ++c) {
+        const double id = loadAs(instance + firstIndex + c * indexSize, indices.type, swap);
+        if (id < 0.0 || id >= limit) {
+          valid = false;
+          return;
+        }
+        ids[row * corners + c] = static_cast<Value>(id);
+      }
+    }
+    parser.advance((last - task * kRowsPerTask) * stride);
+  });
+  if (!valid)
+    return nullptr;
+
+  vtkNew<ArrayT> cellOffsets;
+  cellOffsets->SetNumberOfValues(static_cast<vtkIdType>(element.count) + 1);
+  Value* cellOffset = cellOffsets->GetPointer(0);
+  for (size_t i = 0; i <= element.count; ++i)
+    cellOffset[i] = static_cast<Value>(i * corners);
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(cellOffsets, connectivity);
+  return cells;
+}
+
+template <typename ArrayT>
+vtkSmartPointer<vtkCellArray> cellsFromLists(const FaceLists& faces, size_t pointCount) {
+  using Value = typename ArrayT::ValueType;
+  const auto limit = static_cast<vtkIdType>(pointCount);
+  if (!std::all_of(faces.connectivity.begin(), faces.connectivity.end(), [limit](vtkIdType id) {
+        return id >= 0 && id < limit;
+      }))
+    return nullptr;
+  vtkNew<ArrayT> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(faces.connectivity.size()));
+  std::transform(faces.connectivity.begin(),
+                 faces.connectivity.end(),
+                 connectivity->GetPointer(0),
+                 [](vtkIdType id) { return static_cast<Value>(id); });
+  vtkNew<ArrayT> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(faces.offsets.size()));
+  std::transform(faces.offsets.begin(),
+                 faces.offsets.end(),
+                 offsets->GetPointer(0),
+                 [](vtkIdType offset) { return static_cast<Value>(offset); });
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return cells;
+}
+
+bool fitsInt32(size_t value) {
+  return value <= static_cast<size_t>(std::numeric_limits<vtkTypeInt32>::max());
+}
+
+// All points as one poly-vertex cell, so a point cloud is drawn.
+vtkSmartPointer<vtkCellArray> pointCloudCell(size_t pointCount) {
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(pointCount));
+  vtkIdType* ids = connectivity->GetPointer(0);
+  for (size_t i = 0; i < pointCount; ++i)
+    ids[i] = static_cast<vtkIdType>(i);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(2);
+  offsets->SetValue(0, 0);
+  offsets->SetValue(1, static_cast<vtkIdType>(pointCount));
+  auto cells = vtkSmartPointer<vtkCellArray>::New();
+  cells->SetData(offsets, connectivity);
+  return cells;
+}
+
+} // namespace
+
+PlyMeshParser::~PlyMeshParser() = default;
+
+std::vector<vtkSmartPointer<vtkDataSet>> PlyMeshParser::parse(const std::string& filename) {
+  std::vector<vtkSmartPointer<vtkDataSet>> polys;
+  ByteSource file;
+  if (!openInput(file, filename)) {
+    return polys;
+  }
+  PlyHeader header;
+  if (!readHeader(file.begin(), file.end(), header)) {
+    std::cerr << "Invalid PLY header: " << filename << '\n';
+    return polys;
+  }
+  const bool binary = header.format != PlyFormat::Ascii;
+  const bool swap = header.format == PlyFormat::BinaryBigEndian;
+
+  ElementArrays vertices;
+  size_t pointCount = 0;
+  vtkSmartPointer<vtkCellArray> polygons;
+  ElementArrays faceArrays;
+  bool badIndex = false;
+  const char* p = header.data;
+  for (const PlyElement& element : header.elements) {
+    const bool isVertex = element.name == "vertex" && !vertices.coords;
+    const bool isFace = element.name == "face" && !polygons && !badIndex;
+    ElementArrays arrays;
+    if (isVertex || isFace)
+      arrays = makeArrays(element, isVertex);
+    if (isVertex && !arrays.coords) {
+      std::cerr << "PLY vertices have no x/y/z: " << filename << '\n';
+      return polys;
+    }
+    if (isVertex)
+      pointCount = element.count;
+
+    FaceLists faces;
+    bool haveList = false;
+    if (isFace) {
+      for (size_t k = 0; k < element.properties.size() && !haveList; ++k) {
+        const PlyProperty& property = element.properties[k];
+        if (property.list && !isReal(property.type) &&
+            (property.name == "vertex_indices" || property.name == "vertex_index")) {
+          faces.property = k;
+          haveList = true;
+        }
+      }
+    }
+
+    bool ok = true;
+    const size_t available = static_cast<size_t>(file.end() - p);
+    const size_t stride = binary ? element.fixedStride() : 0;
+    size_t faceStride = 0;
+    size_t corners = 0;
+    if (binary && stride > 0) {
+      ok = available / stride >= element.count;
+      if (ok && (isVertex || isFace))
+        decodeFixed(*this, element, p, swap, arrays.sinks);
+      p += ok ? element.count * stride : 0;
+    } else if (binary && haveList &&
+               (corners = uniformCorners(
+                    element, faces.property, p, file.end(), swap, faceStride)) > 0) {
+      const size_t cornerCount = element.count * corners;
+      polygons = fitsInt32(cornerCount) && fitsInt32(pointCount)
+                     ? decodeUniformFaces<vtkTypeInt32Array>(*this,
+                                                             element,
+                                                             faces.property,
+                                                             corners,
+                                                             faceStride,
+                                                             p,
+                                                             swap,
+                                                             arrays.sinks,
+                                                             pointCount)
+                     : decodeUniformFaces<vtkIdTypeArray>(*this,
+                                                          element,
+                                                          faces.property,
+                                                          corners,
+                                                          faceStride,
+                                                          p,
+                                                          swap,
+                                                          arrays.sinks,
+                                                          pointCount);
+      badIndex = !polygons;
+      p += element.count * faceStride;
+    } else {
+      FaceLists* lists = haveList ? &faces : nullptr;
+      if (binary) {
+        BinaryCursor cursor(p, file.end(), swap);
+        ok = decodeSequential(*this, element, cursor, arrays.sinks, lists);
+        p = cursor.position();
+      } else {
+        AsciiCursor cursor(p, file.end());
+        ok = decodeSequential(*this, element, cursor, arrays.sinks, lists);
+        p = cursor.position();
+      }
+      if (ok && haveList) {
+        polygons = fitsInt32(faces.connectivity.size()) && fitsInt32(pointCount)
+                       ? cellsFromLists<vtkTypeInt32Array>(faces, pointCount)
+                       : cellsFromLists<vtkIdTypeArray>(faces, pointCount);
+        badIndex = !polygons;
+      }
+    }
+    if (cancelled())
+      return {};
+    if (!ok) {
+      std::cerr << "PLY file ends inside element '" << element.name << "': " << filename
+                << '\n';
+      return polys;
+    }
+    if (isVertex)
+      vertices = std::move(arrays);
+    else if (isFace && polygons)
+      faceArrays = std::move(arrays);
+  }
+
+  if (badIndex) {
+    std::cerr << "PLY face has out-of-range vertex index in " << filename << '\n';
+    return polys;
+  }
+  if (!vertices.coords || pointCount == 0) {
+    std::cerr << "PLY file has no vertices: " << filename << '\n';
+    return polys;
+  }
+
+  vtkNew<vtkPoints> points;
+  points->SetData(vertices.coords);
+  vtkNew<vtkPolyData> poly;
+  poly->SetPoints(points);
+  if (polygons)
+    poly->SetPolys(polygons);
+  else
+    poly->SetVerts(pointCloudCell(pointCount));
+  if (vertices.normals) {
+    poly->GetPointData()->SetNormals(vertices.normals);
+    poly->GetPointData()->AddArray(vertices.normals);
+  }
+  for (const auto& array : vertices.attributes)
+    poly->GetPointData()->AddArray(array);
+  if (polygons) {
+    if (faceArrays.normals)
+      poly->GetCellData()->AddArray(faceArrays.normals);
+    for (const auto& array : faceArrays.attributes)
+      poly->GetCellData()->AddArray(array);
+  }
+  polys.push_back(poly);
+  return polys;
+}
+
+bool PlyMeshParser::canParse(const FileHead& head) {
+  return head.prefix(4) == "ply\n" || head.prefix(5) == "ply\r\n";
+}
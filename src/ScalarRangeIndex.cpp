@@ -0,0 +1,291 @@
+#include "ScalarRangeIndex.h"
+
+#include "MeshCache.h"
+#include "TemporalSource.h"
+#include "cache_files.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'V', 'V', 'R', 'A', 'N', 'G', 'E', '2'};
+
+// Where the index for `path` may live: next to the file first, then the mesh
+// cache directory under a name derived from the file's canonical path. stdin,
+// read through /proc/self/fd, has no file to keep an index for.
+std::vector<std::string> indexLocations(const std::string& path) {
+  if (path.rfind("/proc/", 0) == 0) {
+    return {};
+  }
+  std::vector<std::string> locations{path + ".vvrange"};
+  const std::string cacheDir = MeshCache::defaultDirectory();
+  if (!cacheDir.empty()) {
+    const std::string name = hashedFileName(canonicalPath(path));
+    locations.push_back((fs::path(cacheDir) / (name + ".vvrange")).string());
+  }
+  return locations;
+}
+
+template <typename T> void put(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Bounds-checked reads over a loaded index file.
+class IndexReader {
+public:
+  explicit IndexReader(const std::string& data) : data_(data) {}
+
+  template <typename T> T get() {
+    T value{};
+    if (pos_ + sizeof(T) > data_.size()) {
+      ok_ = false;
+      return value;
+    }
+    std::memcpy(&value, data_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+  std::string string(size_t length) {
+    if (pos_ + length > data_.size()) {
+      ok_ = false;
+      return {};
+    }
+    std::string value = data_.substr(pos_, length);
+    pos_ += length;
+    return value;
+  }
+  bool ok() const {
+    return ok_;
+  }
+  bool atEnd() const {
+    return pos_ == data_.size();
+  }
+
+private:
+  const std::string& data_;
+  size_t pos_ = 0;
+  bool ok_ = true;
+};
+
+// Whether the input file stamps recorded next in `in` are those of
+// `inputFiles`, in order.
+bool inputsCurrent(IndexReader& in, const std::vector<std::string>& inputFiles) {
+  if (in.get<uint32_t>() != inputFiles.size()) {
+    return false;
+  }
+  for (const std::string& input : inputFiles) {
+    FileStamp recorded;
+    const bool sameName = in.string(in.get<uint32_t>()) == input;
+    recorded.exists = in.get<uint8_t>() != 0;
+    recorded.size = in.get<uint64_t>();
+    recorded.mtime = in.get<int64_t>();
+    if (!in.ok() || !sameName || !(stampOf(input) == recorded)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+const ScalarRangeIndex::Series* ScalarRangeIndex::find(const std::string& name,
+                                                       FieldAssociation association) const {
+  const auto it = std::find_if(series_.begin(), series_.end(), [&](const Series& s) {
+    return s.association == association && s.name == name;
+  });
+  return it == series_.end() ? nullptr : &*it;
+}
+
+ScalarRangeIndex::Series& ScalarRangeIndex::series(const std::string& name,
+                                                   FieldAssociation association) {
+  const auto it = std::find_if(series_.begin(), series_.end(), [&](const Series& s) {
+    return s.association == association && s.name == name;
+  });
+  if (it != series_.end()) {
+    return *it;
+  }
+  Series added;
+  added.name = name;
+  added.association = association;
+  added.bounds.assign(2 * static_cast<size_t>(steps_), std::numeric_limits<double>::quiet_NaN());
+  series_.push_back(std::move(added));
+  return series_.back();
+}
+
+bool ScalarRangeIndex::build(TemporalSource& source,
+                             vtkDataSet* prototype,
+                             const std::atomic<bool>* cancel) {
+  series_.clear();
+  steps_ = source.steps();
+  if (!prototype || steps_ <= 0) {
+    return false;
+  }
+  for (int step = 0; step < steps_; ++step) {
+    if (cancel && cancel->load()) {
+      return false;
+    }
+    vtkSmartPointer<vtkDataSet> frame;
+    frame.TakeReference(prototype->NewInstance());
+    frame->ShallowCopy(prototype);
+    if (!source.readStepInto(step, frame)) {
+      std::cerr << "Failed to read time step " << step << '\n';
+      return false;
+    }
+    const std::pair<vtkFieldData*, FieldAssociation> attributes[] = {
+        {frame->GetPointData(), FieldAssociation::Point},
+        {frame->GetCellData(), FieldAssociation::Cell}};
+    for (const auto& [fields, association] : attributes) {
+      for (int i = 0; i < fields->GetNumberOfArrays(); ++i) {
+        vtkDataArray* arr = fields->GetArray(i);
+        if (!arr || !arr->GetName()) {
+          continue;
+        }
+        Series& s = series(arr->GetName(), association);
+        if (arr->GetNumberOfTuples() == 0) {
+          continue;
+        }
+        arr->GetRange(&s.bounds[2 * static_cast<size_t>(step)]);
+      }
+    }
+  }
+  return true;
+}
+
+bool ScalarRangeIndex::load(const std::string& path, const std::vector<std::string>& inputFiles) {
+  const FileStamp stamp = stampOf(path);
+  if (!stamp.exists) {
+    return false;
+  }
+  for (const std::string& location : indexLocations(path)) {
+    std::ifstream file(location, std::ios::binary);
+    if (!file) {
+      continue;
+    }
+    const std::string data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    IndexReader in(data);
+    if (in.string(sizeof(kMagic)) != std::string(kMagic, sizeof(kMagic)) ||
+        in.get<uint64_t>() != stamp.size || in.get<int64_t>() != stamp.mtime ||
+        !inputsCurrent(in, inputFiles)) {
+      continue;
+    }
+    const auto steps = in.get<uint32_t>();
+    const auto count = in.get<uint32_t>();
+    if (!in.ok() || uint64_t(steps) * 2 * sizeof(double) > data.size()) {
+      continue;
+    }
+    std::vector<Series> loaded;
+    for (uint32_t i = 0; i < count && in.ok(); ++i) {
+      Series s;
+      s.name = in.string(in.get<uint32_t>());
+      s.association = in.get<uint8_t>() == 0 ? FieldAssociation::Point : FieldAssociation::Cell;
+      s.bounds.resize(2 * static_cast<size_t>(steps));
+      for (double& bound : s.bounds) {
+        bound = in.get<double>();
+      }
+      loaded.push_back(std::move(s));
+    }
+    if (!in.ok() || !in.atEnd()) {
+      continue;
+    }
+    steps_ = static_cast<int>(steps);
+    series_ = std::move(loaded);
+    return true;
+  }
+  return false;
+}
+
+bool ScalarRangeIndex::save(const std::string& path,
+                            const std::vector<std::string>& inputFiles) const {
+  const std::vector<std::string> locations = indexLocations(path);
+  const FileStamp stamp = stampOf(path);
+  if (locations.empty() || !stamp.exists) {
+    return false;
+  }
+  std::string data(kMagic, sizeof(kMagic));
+  put<uint64_t>(data, stamp.size);
+  put<int64_t>(data, stamp.mtime);
+  put<uint32_t>(data, static_cast<uint32_t>(inputFiles.size()));
+  for (const std::string& input : inputFiles) {
+    const FileStamp inputStamp = stampOf(input);
+    put<uint32_t>(data, static_cast<uint32_t>(input.size()));
+    data += input;
+    put<uint8_t>(data, inputStamp.exists ? 1 : 0);
+    put<uint64_t>(data, inputStamp.size);
+    put<int64_t>(data, inputStamp.mtime);
+  }
+  put<uint32_t>(data, static_cast<uint32_t>(steps_));
+  put<uint32_t>(data, static_cast<uint32_t>(series_.size()));
+  for (const Series& s : series_) {
+    put<uint32_t>(data, static_cast<uint32_t>(s.name.size()));
+    data += s.name;
+    put<uint8_t>(data, s.association == FieldAssociation::Point ? 0 : 1);
+    for (const double bound : s.bounds) {
+      put<double>(data, bound);
+    }
+  }
+
+  // Written under a temporary name and renamed, so a concurrent viewer never
+  // reads a partial index.
+  for (const std::string& location : locations) {
+    const bool written = writeFileAtomically(location, [&data](std::ostream& file) {
+      file.write(data.data(), static_cast<std::streamsize>(data.size()));
+      return true;
+    });
+    if (written) {
+      return true;
+    }
+  }
+  std::cerr << "vv: cannot write scalar range index for " << path << '\n';
+  return false;
+}
+
+bool ScalarRangeIndex::range(const std::string& name,
+                             FieldAssociation association,
+                             double out[2]) const {
+  const Series* s = find(name, association);
+  if (!s) {
+    return false;
+  }
+  bool any = false;
+  for (size_t i = 0; i + 1 < s->bounds.size(); i += 2) {
+    if (std::isnan(s->bounds[i])) {
+      continue;
+    }
+    out[0] = any ? std::min(out[0], s->bounds[i]) : s->bounds[i];
+    out[1] = any ? std::max(out[1], s->bounds[i + 1]) : s->bounds[i + 1];
+    any = true;
+  }
+  return any;
+}
+
+bool ScalarRangeIndex::stepRange(const std::string& name,
+                                 FieldAssociation association,
+                                 int step,
+                                 double out[2]) const {
+  const Series* s = find(name, association);
+  if (!s || step < 0 || step >= steps_) {
+    return false;
+  }
+  const size_t i = 2 * static_cast<size_t>(step);
+  if (std::isnan(s->bounds[i])) {
+    return false;
+  }
+  out[0] = s->bounds[i];
+  out[1] = s->bounds[i + 1];
+  return true;
+}
@@ -115,16 +115,39 @@ ScalarAnalysis analyzeScalar(const std::vector<vtkDataSet*>& meshes,
   if (scalarName.empty() || meshes.empty())
     return result;
 
+  // 8-bit RGB(A) arrays already are colors.
+  for (vtkDataSet* mesh : meshes) {
+    if (auto* arr = arrayForAssociation(mesh, scalarName, association)) {
+      const int components = arr->GetNumberOfComponents();
+      result.directColors =
+          arr->GetDataType() == VTK_UNSIGNED_CHAR && (components == 3 || components == 4);
+      break;
+    }
+  }
+  if (result.directColors)
+    return result;
+
   // Determine array type from first mesh that has the scalar.
   bool isInt = false;
+  vtkLookupTable* ownTable = nullptr;
   for (vtkDataSet* mesh : meshes) {
     auto* arr = arrayForAssociation(mesh, scalarName, association);
     if (arr && arr->GetNumberOfComponents() == 1) {
       isInt = isIntegerType(arr);
+      ownTable = arr->GetLookupTable();
       break;
     }
   }
 
+  // Labeled categories (e.g. a FreeSurfer annotation): keep the array's table.
+  if (isInt && ownTable && ownTable->GetIndexedLookup()) {
+    const int maxUnique = static_cast<int>(ownTable->GetNumberOfAnnotatedValues()) + 1;
+    result.uniqueValues = collectUniqueValues(meshes, scalarName, association, true, maxUnique);
+    result.categorical = !result.uniqueValues.empty();
+    result.lookupTable = ownTable;
+    return result;
+  }
+
   // Integer arrays: collect up to 20 unique (rounded) values.
   // Float arrays: collect up to 20 unique values (no rounding).
   const int limit = 20;
@@ -138,7 +161,7 @@ ScalarAnalysis analyzeScalar(const std::vector<vtkDataSet*>& meshes,
   return result;
 }
 
-ScalarAnalysis buildCommonCatAnalysis(const std::vector<vtkDataSet*>& meshes) {
+void addCommonCatValues(const std::vector<vtkDataSet*>& meshes, std::set<double>& unionValues) {
   // Collect all (name, association) fields present across any mesh.
   std::set<std::pair<std::string, FieldAssociation>> fields;
   for (vtkDataSet* mesh : meshes) {
@@ -159,18 +182,19 @@ ScalarAnalysis buildCommonCatAnalysis(const std::vector<vtkDataSet*>& meshes) {
   }
 
   // Union of unique values from every scalar that is itself categorical.
-  std::set<double> unionValues;
   for (const auto& [name, association] : fields) {
     ScalarAnalysis a = analyzeScalar(meshes, name, association);
-    if (a.categorical)
+    if (a.categorical && !a.lookupTable)
       unionValues.insert(a.uniqueValues.begin(), a.uniqueValues.end());
   }
+}
 
+ScalarAnalysis commonCatAnalysis(const std::set<double>& unionValues) {
   ScalarAnalysis result;
   const int n = static_cast<int>(unionValues.size());
   if (n >= 2 && n <= 20) {
     result.categorical = true;
-    result.uniqueValues = std::move(unionValues);
+    result.uniqueValues = unionValues;
   }
   return result;
 }
@@ -207,6 +231,11 @@ vtkSmartPointer<vtkLookupTable> createCategoricalLookupTable(const std::set<doub
 
 vtkSmartPointer<vtkLookupTable> buildLookupTable(const ScalarAnalysis& analysis,
                                                  const double range[2]) {
+  if (analysis.lookupTable) {
+    auto lut = vtkSmartPointer<vtkLookupTable>::New();
+    lut->DeepCopy(analysis.lookupTable);
+    return lut;
+  }
   if (analysis.categorical)
     return createCategoricalLookupTable(analysis.uniqueValues);
   return createDefaultLookupTable(range);
@@ -260,8 +289,12 @@ bool setMapperScalar(vtkDataSet* mesh,
     mapper->SetScalarModeToUsePointFieldData();
   }
   mapper->SelectColorArray(scalarName.c_str());
-  mapper->SetColorModeToMapScalars();
   mapper->ScalarVisibilityOn();
+  if (analysis.directColors) {
+    mapper->SetColorModeToDirectScalars();
+    return true;
+  }
+  mapper->SetColorModeToMapScalars();
 
   auto lut = buildLookupTable(analysis, range);
   mapper->SetLookupTable(lut);
@@ -0,0 +1,199 @@
+#include "StdinFile.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Data is moved in blocks this large; onRead hears about each one.
+constexpr size_t kBlockBytes = size_t(1) << 20;
+
+#ifdef _WIN32
+
+bool copyStdin(FILE* out, const std::function<bool(uint64_t)>& onRead, uint64_t& size) {
+  std::vector<char> buffer(kBlockBytes);
+  size_t n;
+  while ((n = fread(buffer.data(), 1, buffer.size(), stdin)) > 0) {
+    if (fwrite(buffer.data(), 1, n, out) != n) {
+      return false;
+    }
+    size += n;
+    if (onRead && !onRead(n)) {
+      return false;
+    }
+  }
+  return !ferror(stdin);
+}
+
+#else
+
+bool writeAll(int fd, const char* data, size_t length) {
+  while (length > 0) {
+    const ssize_t n = write(fd, data, length);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    length -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Move stdin into `out` until EOF. On Linux a pipe is spliced, so its pages go
+// to the file without a copy through user space; anything else is read and
+// written in blocks.
+bool drainStdin(int out, const std::function<bool(uint64_t)>& onRead, uint64_t& size) {
+  std::vector<char> buffer;
+#ifdef __linux__
+  bool useSplice = true;
+#else
+  bool useSplice = false;
+#endif
+  for (;;) {
+    ssize_t n = 0;
+    if (useSplice) {
+#ifdef __linux__
+      n = splice(STDIN_FILENO, nullptr, out, nullptr, kBlockBytes, SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (n < 0 && errno == EINVAL) {
+        // stdin is not a pipe (a terminal, a socket, ...).
+        useSplice = false;
+        continue;
+      }
+#endif
+    } else {
+      buffer.resize(kBlockBytes);
+      n = read(STDIN_FILENO, buffer.data(), buffer.size());
+      if (n > 0 && !writeAll(out, buffer.data(), static_cast<size_t>(n))) {
+        return false;
+      }
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      return true;
+    }
+    size += static_cast<uint64_t>(n);
+    if (onRead && !onRead(static_cast<uint64_t>(n))) {
+      return false;
+    }
+  }
+}
+
+#endif
+
+} // namespace
+
+StdinFile::~StdinFile() {
+  close();
+}
+
+#ifdef _WIN32
+
+bool StdinFile::open(const std::function<bool(uint64_t bytes)>& onRead) {
+  close();
+  // GetTempFileName creates the file atomically (no tmpnam race).
+  char tmpDir[MAX_PATH + 1];
+  const DWORD dirLen = GetTempPathA(MAX_PATH, tmpDir);
+  if (dirLen == 0 || dirLen > MAX_PATH)
+    return false;
+  char tmpName[MAX_PATH + 1];
+  if (GetTempFileNameA(tmpDir, "vv", 0, tmpName) == 0)
+    return false;
+  path_ = tmpName;
+  removeOnClose_ = true;
+  FILE* out = fopen(path_.c_str(), "wb");
+  if (!out) {
+    close();
+    return false;
+  }
+  // Binary meshes must not go through CRLF translation.
+  _setmode(_fileno(stdin), _O_BINARY);
+  const bool ok = copyStdin(out, onRead, size_);
+  if (fclose(out) != 0 || !ok) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+#else
+
+bool StdinFile::open(const std::function<bool(uint64_t bytes)>& onRead) {
+  close();
+#ifdef __linux__
+  // `vv - < mesh.vtk`: stdin is the file itself, readable through /proc.
+  struct stat st {};
+  if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) &&
+      lseek(STDIN_FILENO, 0, SEEK_CUR) == 0) {
+    path_ = "/proc/self/fd/" + std::to_string(STDIN_FILENO);
+    size_ = static_cast<uint64_t>(st.st_size);
+    if (onRead && !onRead(size_)) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  fd_ = memfd_create("vv-stdin", MFD_CLOEXEC);
+  if (fd_ != -1) {
+    path_ = "/proc/self/fd/" + std::to_string(fd_);
+  }
+#endif
+  if (fd_ == -1) {
+    const char* tmpDir = getenv("TMPDIR");
+    std::string tmplStr = std::string(tmpDir && *tmpDir ? tmpDir : "/tmp") + "/vvstdinXXXXXX";
+    std::vector<char> tmpl(tmplStr.begin(), tmplStr.end());
+    tmpl.push_back('\0');
+    fd_ = mkstemp(tmpl.data());
+    if (fd_ == -1)
+      return false;
+    path_ = tmpl.data();
+    removeOnClose_ = true;
+  }
+
+  if (!drainStdin(fd_, onRead, size_)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+#endif
+
+void StdinFile::close() {
+#ifndef _WIN32
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+#endif
+  if (removeOnClose_) {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+  path_.clear();
+  size_ = 0;
+  fd_ = -1;
+  removeOnClose_ = false;
+}
@@ -0,0 +1,393 @@
+#include "StlMeshParser.h"
+
+#include "ByteSource.h"
+#include "parallel_utils.h"
+#include "text_scan.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkUnsignedCharArray.h>
+
+namespace {
+
+constexpr size_t kHeaderBytes = 80;
+constexpr size_t kFacetBytes = 50; // normal, three corners (float32 xyz), attribute word
+
+// Coordinates of one corner as bit patterns: welding merges exact duplicates.
+using CornerKey = std::array<uint32_t, 3>;
+
+uint32_t foldNegativeZero(uint32_t bits) {
+  return bits == 0x80000000u ? 0u : bits;
+}
+
+// Corners of a binary STL, straight from the mapped facets.
+struct BinaryCorners {
+  const char* facets;
+
+  CornerKey operator()(size_t corner) const {
+    CornerKey key;
+    std::memcpy(key.data(), facets + (corner / 3) * kFacetBytes + 12 + (corner % 3) * 12, 12);
+    for (uint32_t& bits : key)
+      bits = foldNegativeZero(bits);
+    return key;
+  }
+};
+
+// Corners of an ascii STL, parsed into a flat xyz list first.
+struct PackedCorners {
+  const float* xyz;
+
+  CornerKey operator()(size_t corner) const {
+    CornerKey key;
+    std::memcpy(key.data(), xyz + corner * 3, 12);
+    for (uint32_t& bits : key)
+      bits = foldNegativeZero(bits);
+    return key;
+  }
+};
+
+uint64_t hashKey(const CornerKey& key) {
+  uint64_t h = ((uint64_t{key[0]} << 32) | key[1]) * 0x9E3779B97F4A7C15ull;
+  h ^= uint64_t{key[2]} * 0xC2B2AE3D27D4EB4Full;
+  h ^= h >> 31;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 29;
+  return h;
+}
+
+// Corners are split into a fixed number of partitions by hash, so the order of
+// the welded points does not depend on the number of worker threads.
+constexpr size_t kWeldPartitions = 64;
+constexpr size_t kCornersPerTask = size_t{1} << 18;
+
+size_t partitionOf(const CornerKey& key) {
+  return static_cast<size_t>(hashKey(key) >> 58); // top 6 bits: 64 partitions
+}
+
+struct WeldedMesh {
+  vtkSmartPointer<vtkFloatArray> coords;
+  vtkSmartPointer<vtkCellArray> triangles;
+};
+
+// A corner as bucketed for welding: its key travels with it so a partition is
+// welded from one contiguous run of records instead of scattered file reads.
+struct CornerRecord {
+  CornerKey key;
+  uint32_t corner; // index of the corner; reused for its point id once welded
+};
+
+// Weld `cornerCount` triangle corners into shared points. Corners are bucketed
+// by hash partition (count, then scatter, both in parallel), each partition is
+// welded on its own with an open-addressing table, and the per-partition ids
+// are finally offset into one point array. Within a partition, points keep
+// the order of their first corner. The scatter reports its share of
+// `inputBytes` to the parser's progress; a cancelled load returns no mesh.
+template <typename ArrayT, typename Corners>
+WeldedMesh weldCorners(size_t cornerCount,
+                       const Corners& corners,
+                       const MeshParser& parser,
+                       uint64_t inputBytes) {
+  using Value = typename ArrayT::ValueType;
+  constexpr size_t P = kWeldPartitions;
+  const size_t tasks = (cornerCount + kCornersPerTask - 1) / kCornersPerTask;
+  auto taskRange = [cornerCount](size_t task) {
+    return std::pair<size_t, size_t>(task * kCornersPerTask,
+                                     std::min(cornerCount, (task + 1) * kCornersPerTask));
+  };
+
+  std::vector<size_t> counts(tasks * P);
+  parallelFor(tasks, [&](size_t task) {
+    if (parser.cancelled())
+      return;
+    size_t* count = counts.data() + task * P;
+    const auto [first, last] = taskRange(task);
+    for (size_t i = first; i < last; ++i)
+      ++count[partitionOf(corners(i))];
+  });
+  std::vector<size_t> partitionBegin(P + 1);
+  std::vector<size_t> cursor(tasks * P);
+  size_t position = 0;
+  for (size_t p = 0; p < P; ++p) {
+    partitionBegin[p] = position;
+    for (size_t task = 0; task < tasks; ++task) {
+      cursor[task * P + p] = position;
+      position += counts[task * P + p];
+    }
+  }
+  partitionBegin[P] = position;
+
+  // Left uninitialized: the scatter writes every record.
+  std::unique_ptr<CornerRecord[]> records(new CornerRecord[cornerCount]);
+  parallelFor(tasks, [&](size_t task) {
+    if (parser.cancelled())
+      return;
+    size_t* next = cursor.data() + task * P;
+    const auto [first, last] = taskRange(task);
+    for (size_t i = first; i < last; ++i) {
+      const CornerKey key = corners(i);
+      records[next[partitionOf(key)]++] = {key, static_cast<uint32_t>(i)};
+    }
+    parser.advance(inputBytes * (last - first) / cornerCount);
+  });
+  if (parser.cancelled())
+    return {};
+
+  // Weld each partition, leaving the partition-local point id of every corner
+  // in its record's first key word (the key is not needed afterwards).
+  std::vector<std::vector<CornerKey>> unique(P);
+  parallelFor(P, [&](size_t p) {
+    constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+    std::vector<CornerKey>& keys = unique[p];
+    size_t capacity = 16;
+    while (capacity < (partitionBegin[p + 1] - partitionBegin[p]) / 2)
+      capacity *= 2;
+    std::vector<uint32_t> table(capacity, kEmpty);
+    auto slotOf = [&](const CornerKey& key) {
+      size_t slot = static_cast<size_t>(hashKey(key)) & (capacity - 1);
+      while (table[slot] != kEmpty && keys[table[slot]] != key)
+        slot = (slot + 1) & (capacity - 1);
+      return slot;
+    };
+    for (size_t j = partitionBegin[p]; j < partitionBegin[p + 1]; ++j) {
+      CornerRecord& record = records[j];
+      const size_t slot = slotOf(record.key);
+      uint32_t id = table[slot];
+      if (id == kEmpty) {
+        id = static_cast<uint32_t>(keys.size());
+        table[slot] = id;
+        keys.push_back(record.key);
+        if (keys.size() * 2 > capacity) {
+          capacity *= 2;
+          table.assign(capacity, kEmpty);
+          for (size_t k = 0; k < keys.size(); ++k)
+            table[slotOf(keys[k])] = static_cast<uint32_t>(k);
+        }
+      }
+      record.key[0] = id;
+    }
+  });
+
+  std::vector<size_t> pointBegin(P + 1);
+  for (size_t p = 0; p < P; ++p)
+    pointBegin[p + 1] = pointBegin[p] + unique[p].size();
+  auto coords = vtkSmartPointer<vtkFloatArray>::New();
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(static_cast<vtkIdType>(pointBegin[P]));
+  float* xyz = coords->GetPointer(0);
+  vtkNew<ArrayT> connectivity;
+  connectivity->SetNumberOfValues(static_cast<vtkIdType>(cornerCount));
+  Value* ids = connectivity->GetPointer(0);
+  parallelFor(P, [&](size_t p) {
+    std::memcpy(xyz + pointBegin[p] * 3, unique[p].data(), unique[p].size() * 12);
+    for (size_t j = partitionBegin[p]; j < partitionBegin[p + 1]; ++j)
+      ids[records[j].corner] = static_cast<Value>(pointBegin[p] + records[j].key[0]);
+  });
+  records.reset();
+
+  vtkNew<ArrayT> offsets;
+  offsets->SetNumberOfValues(static_cast<vtkIdType>(cornerCount / 3 + 1));
+  Value* offset = offsets->GetPointer(0);
+  for (size_t i = 0; i <= cornerCount / 3; ++i)
+    offset[i] = static_cast<Value>(i * 3);
+  auto triangles = vtkSmartPointer<vtkCellArray>::New();
+  triangles->SetData(offsets, connectivity);
+  return {coords, triangles};
+}
+
+// Corner indices are 32-bit while welding; larger meshes are refused.
+template <typename Corners>
+WeldedMesh
+weld(size_t cornerCount, const Corners& corners, const MeshParser& parser, uint64_t inputBytes) {
+  if (cornerCount > std::numeric_limits<uint32_t>::max())
+    return {};
+  const bool fits32 =
+      cornerCount <= static_cast<size_t>(std::numeric_limits<vtkTypeInt32>::max());
+  return fits32 ? weldCorners<vtkTypeInt32Array>(cornerCount, corners, parser, inputBytes)
+                : weldCorners<vtkIdTypeArray>(cornerCount, corners, parser, inputBytes);
+}
+
+// Facet colors from the attribute word. Materialise files announce themselves
+// with "COLOR=" and a default RGBA in the header and mark a facet's own color
+// (5-bit red, green, blue from the low bits) by a clear top bit; VisCAM and
+// SolidView set the top bit instead and store blue in the low bits. Returns
+// null when no facet has a color of its own.
+vtkSmartPointer<vtkUnsignedCharArray> facetColors(const char* data, size_t facetCount) {
+  const std::string_view header(data, kHeaderBytes);
+  const size_t tag = header.find("COLOR=");
+  const bool materialise = tag != std::string_view::npos && tag + 10 <= kHeaderBytes;
+  unsigned char fallback[3] = {255, 255, 255};
+  if (materialise)
+    std::memcpy(fallback, data + tag + 6, 3);
+
+  auto colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colors->SetName("RGB");
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(static_cast<vtkIdType>(facetCount));
+  unsigned char* rgb = colors->GetPointer(0);
+  const char* facets = data + kHeaderBytes + 4;
+  std::atomic<bool> anyColor{false};
+  const size_t tasks = (facetCount + kCornersPerTask - 1) / kCornersPerTask;
+  parallelFor(tasks, [&](size_t task) {
+    bool colored = false;
+    const size_t last = std::min(facetCount, (task + 1) * kCornersPerTask);
+    for (size_t f = task * kCornersPerTask; f < last; ++f) {
+      uint16_t word;
+      std::memcpy(&word, facets + f * kFacetBytes + 48, sizeof(word));
+      const bool own = ((word & 0x8000u) != 0) != materialise;
+      unsigned char* out = rgb + f * 3;
+      if (!own) {
+        std::copy(fallback, fallback + 3, out);
+        continue;
+      }
+      colored = true;
+      auto channel = [word](unsigned shift) {
+        return static_cast<unsigned char>(((word >> shift) & 0x1Fu) * 255u / 31u);
+      };
+      out[0] = channel(materialise ? 0 : 10);
+      out[1] = channel(5);
+      out[2] = channel(materialise ? 10 : 0);
+    }
+    if (colored)
+      anyColor = true;
+  });
+  return anyColor ? colors : nullptr;
+}
+
+bool isFacetLine(std::string_view line) {
+  const size_t start = line.find_first_not_of(" \t");
+  return start != std::string_view::npos && line.compare(start, 5, "facet") == 0;
+}
+
+bool startsWithToken(const char* p, const char* end, std::string_view token) {
+  return static_cast<size_t>(end - p) >= token.size() &&
+         std::string_view(p, token.size()) == token &&
+         (static_cast<size_t>(end - p) == token.size() ||
+          std::isspace(static_cast<unsigned char>(p[token.size()])));
+}
+
+// Every "vertex x y z" of an ascii STL, in file order. Chunks split at facet
+// lines parse in parallel; parsing counts as the first half of the progress
+// through the file, welding as the second.
+bool readAsciiCorners(const MeshParser& parser,
+                      const char* begin,
+                      const char* end,
+                      std::vector<float>& xyz) {
+  const auto chunks = splitSection(begin, end, chunkCountFor(begin, end), isFacetLine);
+  std::vector<std::vector<float>> parts(chunks.size());
+  std::atomic<bool> ok{true};
+  parallelFor(chunks.size(), [&](size_t i) {
+    if (parser.cancelled())
+      return;
+    const char* p = chunks[i].first;
+    const char* chunkEnd = chunks[i].second;
+    std::vector<float>& out = parts[i];
+    while ((p = skipBlanks(p, chunkEnd)) < chunkEnd) {
+      if (startsWithToken(p, chunkEnd, "vertex")) {
+        p += 6;
+        float corner[3];
+        if (!scanReal(p, chunkEnd, corner[0]) || !scanReal(p, chunkEnd, corner[1]) ||
+            !scanReal(p, chunkEnd, corner[2])) {
+          ok = false;
+          return;
+        }
+        out.insert(out.end(), corner, corner + 3);
+        continue;
+      }
+      while (p < chunkEnd && !std::isspace(static_cast<unsigned char>(*p)))
+        ++p;
+    }
+    parser.advance(static_cast<uint64_t>(chunkEnd - chunks[i].first) / 2);
+  });
+  size_t total = 0;
+  for (const auto& part : parts)
+    total += part.size();
+  xyz.reserve(total);
+  for (const auto& part : parts)
+    xyz.insert(xyz.end(), part.begin(), part.end());
+  return ok && xyz.size() % 9 == 0;
+}
+
+} // namespace
+
+StlMeshParser::~StlMeshParser() = default;
+
+std::vector<vtkSmartPointer<vtkDataSet>> StlMeshParser::parse(const std::string& filename) {
+  std::vector<vtkSmartPointer<vtkDataSet>> polys;
+  ByteSource file;
+  if (!openInput(file, filename)) {
+    return polys;
+  }
+  const size_t size = file.size();
+  uint32_t facetCount = 0;
+  if (size >= kHeaderBytes + 4)
+    std::memcpy(&facetCount, file.data() + kHeaderBytes, sizeof(facetCount));
+  const size_t binarySize = kHeaderBytes + 4 + size_t{facetCount} * kFacetBytes;
+  // Binary headers may start with "solid" too; the size decides.
+  const bool solid = size >= 5 && std::string_view(file.data(), 5) == "solid";
+  const bool binary =
+      size >= kHeaderBytes + 4 && (size == binarySize || (!solid && size > binarySize));
+
+  WeldedMesh mesh;
+  vtkSmartPointer<vtkUnsignedCharArray> colors;
+  if (binary) {
+    if (facetCount == 0) {
+      std::cerr << "STL file has no facets: " << filename << '\n';
+      return polys;
+    }
+    mesh = weld(size_t{facetCount} * 3, BinaryCorners{file.data() + kHeaderBytes + 4}, *this, size);
+    colors = mesh.coords ? facetColors(file.data(), facetCount) : nullptr;
+  } else {
+    std::vector<float> xyz;
+    if (!readAsciiCorners(*this, file.begin(), file.end(), xyz) || xyz.empty()) {
+      if (!cancelled())
+        std::cerr << "Failed to read ascii STL: " << filename << '\n';
+      return polys;
+    }
+    mesh = weld(xyz.size() / 3, PackedCorners{xyz.data()}, *this, size / 2);
+  }
+  if (cancelled())
+    return {};
+  if (!mesh.coords) {
+    std::cerr << "STL file has too many facets: " << filename << '\n';
+    return polys;
+  }
+
+  vtkNew<vtkPoints> points;
+  points->SetData(mesh.coords);
+  vtkNew<vtkPolyData> poly;
+  poly->SetPoints(points);
+  poly->SetPolys(mesh.triangles);
+  if (colors)
+    poly->GetCellData()->AddArray(colors);
+  polys.push_back(poly);
+  return polys;
+}
+
+bool StlMeshParser::canParse(const FileHead& head) {
+  std::string extension = std::filesystem::path(head.path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  if (extension == ".stl")
+    return true;
+  // Extensionless ascii STL (e.g. from stdin).
+  return head.prefix(5) == "solid" && head.prefix(512).find("facet") != std::string_view::npos;
+}
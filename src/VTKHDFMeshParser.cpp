@@ -1,11 +1,15 @@
 #include "VTKHDFMeshParser.h"
 
-#include "TemporalSource.h"
-#include "mesh_utils.h"
+#include "VTKHDFTemporalSource.h"
+#include "hdf5_lock.h"
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <system_error>
 #include <vtkHDFReader.h>
 #include <vtkInformation.h>
 #include <vtkSmartPointer.h>
@@ -13,10 +17,9 @@
 
 namespace {
 
-bool hasHDF5Magic(const std::string& filename) {
+bool hasHDF5Magic(std::string_view header) {
   // HDF5 superblock signature: \x89 H D F \r \n \x1a \n
   static const char kMagic[8] = {'\x89', 'H', 'D', 'F', '\r', '\n', '\x1a', '\n'};
-  std::string header = readHeader(filename, 8);
   if (header.size() < 8) {
     return false;
   }
@@ -38,17 +41,21 @@ bool endsWithIgnoreCase(const std::string& value, const std::string& suffix) {
 VTKHDFMeshParser::VTKHDFMeshParser() = default;
 VTKHDFMeshParser::~VTKHDFMeshParser() = default;
 
-bool VTKHDFMeshParser::canParse(const std::string& filename) {
-  if (!endsWithIgnoreCase(filename, ".vtkhdf")) {
+bool VTKHDFMeshParser::canParse(const FileHead& head) {
+  if (!endsWithIgnoreCase(head.path, ".vtkhdf")) {
     return false;
   }
-  return hasHDF5Magic(filename);
+  return hasHDF5Magic(head.prefix(8));
 }
 
 std::vector<vtkSmartPointer<vtkDataSet>> VTKHDFMeshParser::parse(const std::string& filename) {
   temporal_.reset();
   std::vector<vtkSmartPointer<vtkDataSet>> meshes;
 
+  // Unless HDF5 is threadsafe, files loaded side by side take turns: the whole
+  // read is HDF5 calls, and the reader (declared after the lock) is released
+  // before it is.
+  const auto lock = lockHDF5();
   vtkSmartPointer<vtkHDFReader> reader = vtkSmartPointer<vtkHDFReader>::New();
   reader->SetFileName(filename.c_str());
   if (!reader->CanReadFile(filename.c_str())) {
@@ -67,8 +74,18 @@ std::vector<vtkSmartPointer<vtkDataSet>> VTKHDFMeshParser::parse(const std::stri
     }
   }
 
-  // Read the first step for display.
-  reader->Update();
+  // Read the first step for display: roughly its share of the file, as far as
+  // progress goes.
+  {
+    std::error_code ec;
+    const uintmax_t bytes = std::filesystem::file_size(filename, ec);
+    const uint64_t stepBytes =
+        ec ? 0 : static_cast<uint64_t>(bytes) / std::max<uint64_t>(1, timeValues.size());
+    const VtkProgressRelay relay(*this, reader, stepBytes);
+    reader->Update();
+  }
+  if (cancelled())
+    return meshes;
   auto* output = vtkDataSet::SafeDownCast(reader->GetOutputDataObject(0));
   if (!output || output->GetNumberOfPoints() == 0) {
     std::cerr << "Failed to read VTKHDF dataset: " << filename << '\n';
@@ -82,8 +99,9 @@ std::vector<vtkSmartPointer<vtkDataSet>> VTKHDFMeshParser::parse(const std::stri
   meshes.push_back(mesh);
 
   if (timeValues.size() > 1) {
-    temporal_ = std::make_shared<TemporalSource>();
-    temporal_->init(reader, std::move(timeValues));
+    auto temporal = std::make_shared<VTKHDFTemporalSource>();
+    temporal->init(reader, std::move(timeValues));
+    temporal_ = std::move(temporal);
   }
 
   return meshes;
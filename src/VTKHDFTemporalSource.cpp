@@ -0,0 +1,180 @@
+#include "VTKHDFTemporalSource.h"
+
+#include "hdf5_lock.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vtkDataArray.h>
+#include <vtkDataArraySelection.h>
+#include <vtkFieldData.h>
+#include <vtkHDFReader.h>
+#include <vtkInformation.h>
+#include <vtkNew.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkVersionMacros.h>
+
+VTKHDFTemporalSource::VTKHDFTemporalSource() = default;
+
+VTKHDFTemporalSource::~VTKHDFTemporalSource() {
+  // The last reference closes the file: an HDF5 call like any other.
+  const auto lock = lockHDF5();
+  reader_ = nullptr;
+}
+
+void VTKHDFTemporalSource::init(const vtkSmartPointer<vtkHDFReader>& reader,
+                                std::vector<double> timeValues) {
+  reader_ = reader;
+  timeValues_ = std::move(timeValues);
+  numSteps_ = static_cast<int>(timeValues_.size());
+  if (reader_) {
+    // Cache the static geometry/topology so successive frames only re-read the
+    // temporal data arrays (incompatible with MergeParts, which is off).
+    // vtkHDFReader gained UseCache in VTK 9.3; older VTK still plays back, just
+    // re-reading geometry each frame.
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 3, 0)
+    reader_->UseCacheOn();
+#endif
+  }
+}
+
+void VTKHDFTemporalSource::setActiveArray(const ScalarField& field) {
+  if (!reader_) {
+    return;
+  }
+  activeArray_ = field;
+  // Frames read from now on hold only this array: the other point and cell
+  // arrays drop out of the target until the selection is cleared. Field data
+  // (selectable from VTK 9.3) is never colored, so it is not read either;
+  // readStepInto keeps what the target got from its full first read.
+  const std::pair<vtkDataArraySelection*, bool> selections[] = {
+      {reader_->GetPointDataArraySelection(), field.association == FieldAssociation::Point},
+      {reader_->GetCellDataArraySelection(), field.association == FieldAssociation::Cell},
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 3, 0)
+      {reader_->GetFieldDataArraySelection(), false},
+#endif
+  };
+  for (const auto& [sel, holdsField] : selections) {
+    if (!sel) {
+      continue;
+    }
+    if (field.name.empty()) {
+      sel->EnableAllArrays();
+      continue;
+    }
+    sel->DisableAllArrays();
+    if (holdsField) {
+      sel->EnableArray(field.name.c_str());
+    }
+  }
+}
+
+std::unique_ptr<TemporalSource> VTKHDFTemporalSource::clone() const {
+  if (!reader_ || !reader_->GetFileName()) {
+    return nullptr;
+  }
+  auto copy = std::make_unique<VTKHDFTemporalSource>();
+  {
+    const auto lock = lockHDF5();
+    auto reader = vtkSmartPointer<vtkHDFReader>::New();
+    reader->SetFileName(reader_->GetFileName());
+    reader->UpdateInformation();
+    copy->init(reader, timeValues_);
+  }
+  copy->setActiveArray(activeArray_);
+  return copy;
+}
+
+std::string VTKHDFTemporalSource::fileName() const {
+  return reader_ && reader_->GetFileName() ? reader_->GetFileName() : std::string();
+}
+
+double VTKHDFTemporalSource::timeAt(int step) const {
+  if (step < 0 || step >= numSteps_) {
+    return 0.0;
+  }
+  return timeValues_[static_cast<size_t>(step)];
+}
+
+bool VTKHDFTemporalSource::updateToStep(int step) {
+  if (!reader_ || step < 0 || step >= numSteps_) {
+    return false;
+  }
+  // Drive the time-series pipeline via UPDATE_TIME_STEP: vtkHDFReader::RequestData
+  // recomputes its internal Step from this key on every Update.
+  vtkInformation* outInfo = reader_->GetOutputInformation(0);
+  if (!outInfo) {
+    return false;
+  }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+               timeValues_[static_cast<size_t>(step)]);
+  const auto lock = lockHDF5();
+  reader_->Update();
+  return true;
+}
+
+bool VTKHDFTemporalSource::readStepInto(int step, vtkDataSet* target) {
+  if (!target || !updateToStep(step)) {
+    return false;
+  }
+  auto* out = vtkDataSet::SafeDownCast(reader_->GetOutputDataObject(0));
+  if (!out) {
+    return false;
+  }
+  // ShallowCopy replaces the target's field data with the frame's, which is
+  // empty while an array is active; put the part name and color back.
+  vtkNew<vtkFieldData> fieldData;
+  const bool keepFieldData = !activeArray_.name.empty();
+  if (keepFieldData) {
+    fieldData->ShallowCopy(target->GetFieldData());
+  }
+  target->ShallowCopy(out);
+  if (keepFieldData) {
+    target->SetFieldData(fieldData);
+  }
+  target->Modified();
+  return true;
+}
+
+bool VTKHDFTemporalSource::sampledScalarRange(const ScalarField& field,
+                                              double out[2],
+                                              int maxSamples) {
+  if (!reader_ || numSteps_ <= 0 || field.name.empty()) {
+    return false;
+  }
+  const int sampleCount = std::min(numSteps_, std::max(1, maxSamples));
+  double lo = 0.0;
+  double hi = 0.0;
+  bool any = false;
+  for (int s = 0; s < sampleCount; ++s) {
+    // Evenly spaced steps including first and last.
+    const int step =
+        sampleCount == 1
+            ? 0
+            : static_cast<int>((static_cast<long long>(s) * (numSteps_ - 1)) / (sampleCount - 1));
+    if (!updateToStep(step)) {
+      continue;
+    }
+    auto* out2 = vtkDataSet::SafeDownCast(reader_->GetOutputDataObject(0));
+    vtkDataArray* arr = arrayForAssociation(out2, field.name, field.association);
+    if (!arr) {
+      continue;
+    }
+    double range[2];
+    arr->GetRange(range);
+    if (!any) {
+      lo = range[0];
+      hi = range[1];
+      any = true;
+    } else {
+      lo = std::min(lo, range[0]);
+      hi = std::max(hi, range[1]);
+    }
+  }
+  if (!any) {
+    return false;
+  }
+  out[0] = lo;
+  out[1] = hi;
+  return true;
+}
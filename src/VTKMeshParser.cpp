@@ -1,53 +1,288 @@
 #include "VTKMeshParser.h"
 
+#include "MappedFile.h"
+#include "XmlPullReader.h"
 #include "mesh_utils.h"
+#include "parallel_utils.h"
 
+#include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <string>
+#include <system_error>
+#include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
 #include <vtkDataSet.h>
 #include <vtkDataSetReader.h>
+#include <vtkFieldData.h>
+#include <vtkImageData.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
 #include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkStructuredGrid.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLImageDataReader.h>
 #include <vtkXMLPolyDataReader.h>
+#include <vtkXMLRectilinearGridReader.h>
+#include <vtkXMLStructuredGridReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
 
 namespace {
 enum class VTKFileType { None, Legacy, XML };
-VTKFileType detectVTKFileType(const std::string& filename) {
-  std::string header = readHeader(filename, 200);
-  if (header.find("# vtk DataFile") != std::string::npos)
+VTKFileType detectVTKFileType(std::string_view header) {
+  header = header.substr(0, 200);
+  if (header.find("# vtk DataFile") != std::string_view::npos)
     return VTKFileType::Legacy;
-  if (header.find("<VTKFile") != std::string::npos)
+  if (header.find("<VTKFile") != std::string_view::npos)
     return VTKFileType::XML;
   return VTKFileType::None;
 }
+
+// The `type` attribute of <VTKFile>: "PolyData", "PUnstructuredGrid",
+// "vtkMultiBlockDataSet", ... Empty if the head does not hold it.
+std::string xmlDataType(std::string_view head) {
+  const size_t start = head.find("<VTKFile");
+  if (start == std::string_view::npos)
+    return {};
+  XmlPullReader xml(head.data() + start, head.data() + head.size());
+  std::string type;
+  if (xml.next() == XmlPullReader::Event::StartElement)
+    xml.attribute("type", type);
+  return type;
+}
+
+// How an XML file's content is laid out.
+enum class XMLLayout {
+  Unknown,
+  Serial,    // one dataset in the file itself (.vtp, .vtu, .vts, .vtr, .vti)
+  Parallel,  // summary whose <Piece Source="..."> files partition one dataset (.pvtu, ...)
+  Composite, // blocks of separate datasets, one file each (.vtm, .vtpd, .vtpc)
+};
+
+XMLLayout layoutOf(const std::string& type) {
+  static const char* const serial[] = {
+      "PolyData", "UnstructuredGrid", "StructuredGrid", "RectilinearGrid", "ImageData"};
+  for (const char* name : serial) {
+    if (type == name)
+      return XMLLayout::Serial;
+    if (type.size() > 1 && type[0] == 'P' && type.compare(1, std::string::npos, name) == 0)
+      return XMLLayout::Parallel;
+  }
+  if (type == "vtkMultiBlockDataSet" || type == "vtkPartitionedDataSet" ||
+      type == "vtkPartitionedDataSetCollection")
+    return XMLLayout::Composite;
+  return XMLLayout::Unknown;
+}
+
+uint64_t fileBytes(const std::string& path) {
+  std::error_code ec;
+  const uintmax_t bytes = std::filesystem::file_size(path, ec);
+  return ec ? 0 : static_cast<uint64_t>(bytes);
+}
+
+// The reader's progress counts towards the parser's as the file's share of
+// the input; a cancelled load aborts it and yields nothing.
+template <typename Reader>
+vtkSmartPointer<vtkDataSet> readWith(const MeshParser& parser, const std::string& path) {
+  vtkNew<Reader> reader;
+  reader->SetFileName(path.c_str());
+  {
+    const VtkProgressRelay relay(parser, reader, fileBytes(path));
+    reader->Update();
+  }
+  vtkSmartPointer<vtkDataSet> data = reader->GetOutput();
+  if (!data || data->GetNumberOfPoints() == 0 || parser.cancelled())
+    return nullptr;
+  return data;
+}
+
+// Read one serial file with the reader for its dataset type.
+vtkSmartPointer<vtkDataSet>
+readSerial(const MeshParser& parser, const std::string& type, const std::string& path) {
+  if (type == "PolyData")
+    return readWith<vtkXMLPolyDataReader>(parser, path);
+  if (type == "UnstructuredGrid")
+    return readWith<vtkXMLUnstructuredGridReader>(parser, path);
+  if (type == "StructuredGrid")
+    return readWith<vtkXMLStructuredGridReader>(parser, path);
+  if (type == "RectilinearGrid")
+    return readWith<vtkXMLRectilinearGridReader>(parser, path);
+  if (type == "ImageData")
+    return readWith<vtkXMLImageDataReader>(parser, path);
+  return nullptr;
+}
+
+// A file referenced by a parallel or composite summary.
+struct SubFile {
+  std::string path;
+  std::string name; // block name, if the summary gives one
+};
+
+// Collect the files a summary references: `Source` of every <Piece> for a
+// parallel file, `file` of every <DataSet> for a composite one (named after
+// the DataSet or, failing that, its innermost named ancestor).
+bool listSubFiles(const std::string& filename, XMLLayout layout, std::vector<SubFile>& files) {
+  MappedFile file;
+  if (!file.open(filename))
+    return false;
+  const std::filesystem::path dir = std::filesystem::path(filename).parent_path();
+  const char* element = layout == XMLLayout::Parallel ? "Piece" : "DataSet";
+  const char* source = layout == XMLLayout::Parallel ? "Source" : "file";
+  XmlPullReader xml(file.begin(), file.end());
+  std::vector<std::string> names; // name attribute of each open element
+  while (true) {
+    switch (xml.next()) {
+    case XmlPullReader::Event::Error:
+      return false;
+    case XmlPullReader::Event::EndDocument:
+      return true;
+    case XmlPullReader::Event::EndElement:
+      names.pop_back();
+      break;
+    case XmlPullReader::Event::StartElement: {
+      std::string name;
+      xml.attribute("name", name);
+      std::string relative;
+      if (xml.name() == element && xml.attribute(source, relative) && !relative.empty()) {
+        SubFile sub;
+        sub.path = (dir / std::filesystem::path(relative)).lexically_normal().string();
+        sub.name = name;
+        for (auto it = names.rbegin(); sub.name.empty() && it != names.rend(); ++it)
+          sub.name = *it;
+        files.push_back(std::move(sub));
+      }
+      names.push_back(std::move(name));
+      break;
+    }
+    }
+  }
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> readXML(const MeshParser& parser,
+                                                 const std::string& filename);
+
+// Read every piece concurrently (each reader decodes and decompresses its own
+// appended data on its worker), then append them in piece order.
+vtkSmartPointer<vtkDataSet>
+readParallel(const MeshParser& parser, const std::string& filename, const std::string& type) {
+  std::vector<SubFile> pieces;
+  if (!listSubFiles(filename, XMLLayout::Parallel, pieces)) {
+    std::cerr << "Failed to read VTK piece list: " << filename << '\n';
+    return nullptr;
+  }
+  const std::string pieceType = type.substr(1); // "PUnstructuredGrid" -> "UnstructuredGrid"
+  std::vector<vtkSmartPointer<vtkDataSet>> data(pieces.size());
+  parallelFor(pieces.size(),
+              [&](size_t i) { data[i] = readSerial(parser, pieceType, pieces[i].path); });
+  if (parser.cancelled())
+    return nullptr;
+
+  std::vector<vtkDataSet*> read;
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    if (data[i])
+      read.push_back(data[i]);
+    else
+      std::cerr << "Skipping unreadable VTK piece: " << pieces[i].path << '\n';
+  }
+  if (read.size() == 1)
+    return read.front();
+  if (read.empty())
+    return nullptr;
+  if (type == "PPolyData") {
+    vtkNew<vtkAppendPolyData> append;
+    for (vtkDataSet* piece : read)
+      append->AddInputData(vtkPolyData::SafeDownCast(piece));
+    append->Update();
+    return append->GetOutput();
+  }
+  // Structured pieces lose their structure here; the viewer only draws them.
+  vtkNew<vtkAppendFilter> append;
+  for (vtkDataSet* piece : read)
+    append->AddInputData(piece);
+  append->Update();
+  return append->GetOutput();
+}
+
+// Each block becomes its own mesh, named after the block.
+std::vector<vtkSmartPointer<vtkDataSet>> readComposite(const MeshParser& parser,
+                                                       const std::string& filename) {
+  std::vector<SubFile> blocks;
+  if (!listSubFiles(filename, XMLLayout::Composite, blocks)) {
+    std::cerr << "Failed to read VTK block list: " << filename << '\n';
+    return {};
+  }
+  std::vector<std::vector<vtkSmartPointer<vtkDataSet>>> data(blocks.size());
+  parallelFor(blocks.size(), [&](size_t i) { data[i] = readXML(parser, blocks[i].path); });
+  if (parser.cancelled())
+    return {};
+
+  std::vector<vtkSmartPointer<vtkDataSet>> meshes;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    for (auto& mesh : data[i]) {
+      if (!blocks[i].name.empty() && !mesh->GetFieldData()->GetAbstractArray("vv_part_name")) {
+        vtkNew<vtkStringArray> partNameArray;
+        partNameArray->SetName("vv_part_name");
+        partNameArray->InsertNextValue(blocks[i].name);
+        mesh->GetFieldData()->AddArray(partNameArray);
+      }
+      meshes.push_back(mesh);
+    }
+  }
+  return meshes;
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> readXML(const MeshParser& parser,
+                                                 const std::string& filename) {
+  const std::string type = xmlDataType(FileHead::read(filename).bytes);
+  switch (layoutOf(type)) {
+  case XMLLayout::Serial:
+    if (auto data = readSerial(parser, type, filename))
+      return {data};
+    break;
+  case XMLLayout::Parallel:
+    if (auto data = readParallel(parser, filename, type))
+      return {data};
+    break;
+  case XMLLayout::Composite:
+    return readComposite(parser, filename);
+  case XMLLayout::Unknown:
+    if (type.empty())
+      std::cerr << "Failed to read VTK file: " << filename << '\n';
+    else
+      std::cerr << "Unsupported VTK XML type '" << type << "': " << filename << '\n';
+    break;
+  }
+  return {};
+}
 } // namespace
 
 VTKMeshParser::~VTKMeshParser() = default;
 
 std::vector<vtkSmartPointer<vtkDataSet>> VTKMeshParser::parse(const std::string& filename) {
   std::vector<vtkSmartPointer<vtkDataSet>> polys;
-  VTKFileType type = detectVTKFileType(filename);
+  VTKFileType type = detectVTKFileType(readHeader(filename, 200));
   if (type == VTKFileType::None) {
     std::cerr << "Unrecognized VTK file magic: " << filename << '\n';
     return polys;
   }
   if (type == VTKFileType::XML) {
-    vtkNew<vtkXMLPolyDataReader> reader;
-    reader->SetFileName(filename.c_str());
-    reader->Update();
-    vtkPolyData* poly = reader->GetOutput();
-    if (poly && poly->GetNumberOfPoints() > 0) {
-      polys.push_back(poly);
+    polys = readXML(*this, filename);
+    if (!polys.empty() || cancelled())
       return polys;
-    }
   }
   if (type == VTKFileType::Legacy) {
     // Generic legacy reader auto-detects POLYDATA, UNSTRUCTURED_GRID, etc.
     // Clipped meshes (e.g. from ParaView) become UNSTRUCTURED_GRID.
     vtkNew<vtkDataSetReader> reader;
     reader->SetFileName(filename.c_str());
-    reader->Update();
+    {
+      const VtkProgressRelay relay(*this, reader, fileBytes(filename));
+      reader->Update();
+    }
+    if (cancelled())
+      return polys;
     vtkDataSet* ds = reader->GetOutput();
     if (ds && ds->GetNumberOfPoints() > 0) {
       polys.push_back(ds);
@@ -58,7 +293,7 @@ std::vector<vtkSmartPointer<vtkDataSet>> VTKMeshParser::parse(const std::string&
   return polys;
 }
 
-bool VTKMeshParser::canParse(const std::string& filename) {
-  VTKFileType type = detectVTKFileType(filename);
+bool VTKMeshParser::canParse(const FileHead& head) {
+  VTKFileType type = detectVTKFileType(head.bytes);
   return type != VTKFileType::None;
 }
@@ -1,19 +1,25 @@
 #include "ViewerWindow.h"
 
 #include "ColorBarWidget.h"
+#include "FramePrefetcher.h"
+#include "LoadProgressBar.h"
 #include "PlaybackBar.h"
+#include "ScalarRangeIndex.h"
 #include "ScalarVizUtils.h"
 #include "TemporalSource.h"
 #include "mesh_utils.h"
 
 #include <QAbstractItemView>
 #include <QApplication>
+#include <QCloseEvent>
+#include <QCoreApplication>
 #include <QDir>
 #include <QEvent>
 #include <QFileInfo>
 #include <QHBoxLayout>
 #include <QIcon>
 #include <QKeyEvent>
+#include <QMetaObject>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPixmap>
@@ -25,9 +31,13 @@
 #include <QWheelEvent>
 #include <algorithm>
 #include <cmath>
-#include <cstdio>
+#include <cstddef>
+#include <exception>
 #include <functional>
+#include <iostream>
+#include <iterator>
 #include <set>
+#include <string>
 #include <utility>
 #include <vtkCamera.h>
 #include <vtkCellData.h>
@@ -37,6 +47,7 @@
 #include <vtkPointData.h>
 #include <vtkRenderer.h>
 #include <vtkRendererCollection.h>
+#include <vtkVariant.h>
 
 namespace {
 
@@ -57,6 +68,9 @@ constexpr int kFacetBarMaxWidth = 140;
 constexpr int kPlaybackBarMargin = 16;
 constexpr int kPlaybackBarMaxWidth = 760;
 constexpr int kPlaybackBarHeight = 44;
+// Playback rate at 1x, and how far ahead of it the prefetcher reads.
+constexpr double kPlaybackFps = 15.0;
+constexpr double kPrefetchSeconds = 0.5;
 
 QRect colorBarOverlayGeometry(const QWidget* viewport, const ColorBarWidget* colorBar) {
   const int height = std::clamp(static_cast<int>(viewport->height() * kOverlayHeightRatio),
@@ -153,25 +167,24 @@ QIcon partColorIcon(const std::array<double, 3>& rgb) {
 }
 
 // Swatch list for a categorical scalar: analysis unique values + LUT colors,
-// highest value first (top of the bar).
+// highest value first (top of the bar). Colors and labels come from the LUT's
+// annotations, so an array's own categories (FreeSurfer annotations) show their
+// names; values the table does not annotate (unlabeled vertices) are left out.
 std::vector<std::pair<QString, QColor>> categoricalEntries(vtkLookupTable* lut,
                                                            const ScalarAnalysis& analysis) {
   std::vector<std::pair<QString, QColor>> entries;
-  if (!lut) {
+  if (!lut || lut->GetNumberOfTableValues() == 0) {
     return entries;
   }
   const auto& uv = analysis.uniqueValues;
-  int idx = static_cast<int>(uv.size()) - 1; // reverse: highest first
-  for (auto it = uv.rbegin(); it != uv.rend(); ++it, --idx) {
+  for (auto it = uv.rbegin(); it != uv.rend(); ++it) {
+    const vtkIdType idx = lut->GetAnnotatedValueIndex(vtkVariant(*it));
+    if (idx < 0) {
+      continue;
+    }
     double rgba[4];
-    lut->GetTableValue(idx < 0 ? 0 : idx, rgba);
-    char label[32];
-    const double v = *it;
-    if (v == std::floor(v))
-      std::snprintf(label, sizeof(label), "%g", v);
-    else
-      std::snprintf(label, sizeof(label), "%.3g", v);
-    entries.push_back({QString::fromLatin1(label),
+    lut->GetTableValue(idx % lut->GetNumberOfTableValues(), rgba);
+    entries.push_back({QString::fromStdString(lut->GetAnnotation(idx)),
                        QColor::fromRgbF(static_cast<float>(rgba[0]),
                                         static_cast<float>(rgba[1]),
                                         static_cast<float>(rgba[2]))});
@@ -329,37 +342,20 @@ private:
 } // namespace
 
 // ═════════════════════════════════════════════════════════════════════
-ViewerWindow::ViewerWindow(MeshLoadResult loadResult, const ViewerOptions& options, QWidget* parent)
-    : QMainWindow(parent), load_(std::move(loadResult)), options_(options),
-      temporal_(load_.temporal) {
+ViewerWindow::ViewerWindow(std::vector<std::string> meshfiles,
+                           MeshLoadOptions loadOptions,
+                           const ViewerOptions& options,
+                           QWidget* parent)
+    : QMainWindow(parent), options_(options) {
   // Title: "vv - .../parent/stem.ext"
-  if (!load_.meshes.names.empty()) {
-    QFileInfo fi(QStringFromUtf8(load_.meshes.names.front()));
+  if (!meshfiles.empty()) {
+    QFileInfo fi(QStringFromUtf8(meshfiles.front()));
     setWindowTitle(QStringLiteral("vv - …/") + fi.dir().dirName() + "/" + fi.fileName());
   }
   resize(1300, 980);
 
-  const auto& meshes = load_.meshes.meshes;
-  partColors_.reserve(meshes.size());
-  for (size_t i = 0; i < meshes.size(); ++i) {
-    if (i < load_.meshes.partHasColors.size() && load_.meshes.partHasColors[i] &&
-        i < load_.meshes.partColors.size()) {
-      partColors_.push_back(load_.meshes.partColors[i]);
-    } else {
-      partColors_.push_back(generateDistinctColor(static_cast<int>(i)));
-    }
-  }
-
   buildViewport();
-
-  if (options_.commonCatLut) {
-    std::vector<vtkDataSet*> ptrs;
-    ptrs.reserve(meshes.size());
-    std::transform(meshes.begin(), meshes.end(), std::back_inserter(ptrs), [](const auto& m) {
-      return m.GetPointer();
-    });
-    renderer_.setSharedCatAnalysis(buildCommonCatAnalysis(ptrs));
-  }
+  connectPartsTree();
 
   qApp->installEventFilter(new VtkMouseFilter(
       vtkWidget_,
@@ -374,15 +370,28 @@ ViewerWindow::ViewerWindow(MeshLoadResult loadResult, const ViewerOptions& optio
     partsTree_->setGeometry(treeOverlayGeometry(vtkWidget_));
   });
 
-  if (options_.explodeView) {
-    setupFacetMode();
-  } else {
-    setupNormalMode();
-  }
+  startLoading(std::move(meshfiles), std::move(loadOptions));
 
   vtkWidget_->setFocus();
 }
 
+ViewerWindow::~ViewerWindow() {
+  cancelLoad_ = true;
+  if (loader_.joinable()) {
+    loader_.join();
+  }
+  cancelRangeScan_ = true;
+  if (rangeScan_.joinable()) {
+    rangeScan_.join();
+  }
+  prefetcher_.reset();
+}
+
+void ViewerWindow::closeEvent(QCloseEvent* event) {
+  cancelLoading();
+  QMainWindow::closeEvent(event);
+}
+
 void ViewerWindow::buildViewport() {
   auto* central = new QWidget(this);
   auto* layout = new QHBoxLayout(central);
@@ -430,15 +439,27 @@ void ViewerWindow::buildViewport() {
 }
 
 // ── facet (exploded) mode ──────────────────────────────────────────────
-void ViewerWindow::setupFacetMode() {
-  renderer_.setupFacetGrid(load_.meshes.meshes, load_.meshes.names, partColors_);
-  renderer_.startFacetGrid();
-  colorBar_->setVisible(false);
-  partsTree_->setVisible(false);
+void ViewerWindow::setupFacetMode(size_t firstPart) {
+  // Each file's parts add their own panels; the ones already shown stay.
+  const size_t firstPanel = renderer_.getFacetPanelCount();
+  const auto& meshes = load_.meshes.meshes;
+  const std::vector<vtkSmartPointer<vtkDataSet>> newMeshes(
+      meshes.begin() + static_cast<std::ptrdiff_t>(firstPart), meshes.end());
+  const std::vector<std::array<double, 3>> newColors(
+      partColors_.begin() + static_cast<std::ptrdiff_t>(firstPart), partColors_.end());
+  if (!sceneStarted_) {
+    sceneStarted_ = true;
+    renderer_.setupFacetGrid(newMeshes, load_.meshes.names, newColors);
+    renderer_.startFacetGrid();
+    colorBar_->setVisible(false);
+    partsTree_->setVisible(false);
+  } else {
+    renderer_.addFacetMeshes(newMeshes, newColors);
+  }
 
   const size_t panelCount = renderer_.getFacetPanelCount();
   facetColorBars_.reserve(panelCount);
-  for (size_t panelIndex = 0; panelIndex < panelCount; ++panelIndex) {
+  for (size_t panelIndex = firstPanel; panelIndex < panelCount; ++panelIndex) {
     FacetPanelInfo panelInfo;
     if (!renderer_.getFacetPanelInfo(panelIndex, panelInfo)) {
       continue;
@@ -455,7 +476,7 @@ void ViewerWindow::setupFacetMode() {
     } else {
       panelBar->setClipRange(panelInfo.clipRange[0], panelInfo.clipRange[1]);
     }
-    panelBar->setVisible(true);
+    panelBar->setVisible(!panelInfo.analysis.directColors);
 
     QObject::connect(panelBar,
                      &ColorBarWidget::clipRangeChanged,
@@ -476,12 +497,22 @@ void ViewerWindow::setupFacetMode() {
   QTimer::singleShot(0, this, [this]() { layoutFacetColorBars(); });
 }
 
+void ViewerWindow::refreshFacetCategories() {
+  for (size_t panelIndex = 0; panelIndex < facetColorBars_.size(); ++panelIndex) {
+    FacetPanelInfo panelInfo;
+    if (renderer_.getFacetPanelInfo(panelIndex, panelInfo) && panelInfo.analysis.categorical) {
+      vtkLookupTable* lut = renderer_.getFacetPanelLUT(panelIndex);
+      facetColorBars_[panelIndex]->setCategorical(categoricalEntries(lut, panelInfo.analysis));
+    }
+  }
+}
+
 // ── normal (single-view) mode ──────────────────────────────────────────
 void ViewerWindow::setupNormalMode() {
   renderer_.setup(load_.meshes.meshes, load_.meshes.names, partColors_);
   renderer_.start();
 
-  buildPartsTree();
+  addPartsTreeGroups(0);
 
   QObject::connect(colorBar_,
                    &ColorBarWidget::clipRangeChanged,
@@ -494,15 +525,12 @@ void ViewerWindow::setupNormalMode() {
   } else {
     applyNoScalar();
   }
-
-  if (temporal_ && temporal_->playable()) {
-    setupPlayback();
-  }
 }
 
-void ViewerWindow::buildPartsTree() {
-  partsTree_->clear();
-  for (const MeshGroup& group : load_.meshes.groups) {
+void ViewerWindow::addPartsTreeGroups(size_t firstGroup) {
+  const QSignalBlocker block(partsTree_);
+  for (size_t groupIndex = firstGroup; groupIndex < load_.meshes.groups.size(); ++groupIndex) {
+    const MeshGroup& group = load_.meshes.groups[groupIndex];
     auto* groupItem = new QTreeWidgetItem(partsTree_);
     groupItem->setText(0, QStringFromUtf8(group.name));
     groupItem->setFlags(groupItem->flags() | Qt::ItemIsUserCheckable);
@@ -524,7 +552,9 @@ void ViewerWindow::buildPartsTree() {
     groupItem->setExpanded(group.partIndices.size() <= 8);
   }
   partsTree_->setVisible(!load_.meshes.groups.empty());
+}
 
+void ViewerWindow::connectPartsTree() {
   QObject::connect(
       partsTree_, &QTreeWidget::itemChanged, this, [this](QTreeWidgetItem* item, int column) {
         if (!item || column != 0) {
@@ -568,16 +598,193 @@ void ViewerWindow::buildPartsTree() {
       });
 }
 
+// ── background loading ─────────────────────────────────────────────────
+void ViewerWindow::startLoading(std::vector<std::string> meshfiles, MeshLoadOptions loadOptions) {
+  QString title = QStringLiteral("%1 files").arg(meshfiles.size());
+  if (meshfiles.size() == 1 || !options_.explodeView) {
+    title = meshfiles.front() == "-" ? QStringLiteral("stdin")
+                                     : QFileInfo(QStringFromUtf8(meshfiles.front())).fileName();
+  }
+  progressBar_ = new LoadProgressBar(title, vtkWidget_);
+  progressBar_->setGeometry(playbackBarGeometry(vtkWidget_));
+  progressBar_->raise();
+  progressBar_->show();
+  QObject::connect(
+      progressBar_, &LoadProgressBar::cancelRequested, this, [this]() { cancelLoading(); });
+
+  progressTimer_ = new QTimer(this);
+  progressTimer_->setInterval(100);
+  QObject::connect(progressTimer_, &QTimer::timeout, this, [this]() {
+    if (progressBar_) {
+      progressBar_->setProgress(loadedBytes_.load(), totalBytes_.load());
+    }
+  });
+  progressTimer_->start();
+
+  loadOptions.cancel = &cancelLoad_;
+  loadOptions.onProgress = [this](uint64_t done, uint64_t total) {
+    // Files loading side by side report out of order; keep the furthest count.
+    uint64_t shown = loadedBytes_.load();
+    while (done > shown && !loadedBytes_.compare_exchange_weak(shown, done)) {
+    }
+    totalBytes_ = total;
+  };
+  loadOptions.onFileLoaded = [this](const LoadedMeshes& added) {
+    QMetaObject::invokeMethod(
+        this, [this, added]() { addLoadedMeshes(added); }, Qt::QueuedConnection);
+  };
+
+  const bool explodeView = options_.explodeView;
+  loader_ = std::thread([this,
+                         meshfiles = std::move(meshfiles),
+                         loadOptions = std::move(loadOptions),
+                         explodeView]() {
+    MeshLoadResult result;
+    try {
+      result = loadMeshes(meshfiles, explodeView, loadOptions);
+    } catch (const std::exception& e) {
+      result.ok = false;
+      result.exitCode = 1;
+      result.error = std::string("vv: fatal: ") + e.what();
+    }
+    // The parts themselves already arrived through onFileLoaded.
+    result.meshes = {};
+    QMetaObject::invokeMethod(
+        this, [this, result]() { finishLoading(result); }, Qt::QueuedConnection);
+  });
+}
+
+void ViewerWindow::addLoadedMeshes(LoadedMeshes added) {
+  const size_t firstPart = load_.meshes.meshes.size();
+  const size_t firstGroup = load_.meshes.groups.size();
+  appendLoadedMeshes(load_.meshes, std::move(added));
+
+  const auto& meshes = load_.meshes.meshes;
+  for (size_t i = firstPart; i < meshes.size(); ++i) {
+    if (i < load_.meshes.partHasColors.size() && load_.meshes.partHasColors[i] &&
+        i < load_.meshes.partColors.size()) {
+      partColors_.push_back(load_.meshes.partColors[i]);
+    } else {
+      partColors_.push_back(generateDistinctColor(static_cast<int>(i)));
+    }
+  }
+
+  bool sharedCatChanged = false;
+  if (options_.commonCatLut) {
+    // Only the new parts are scanned; their values join those seen before.
+    std::vector<vtkDataSet*> ptrs;
+    ptrs.reserve(meshes.size() - firstPart);
+    std::transform(meshes.begin() + static_cast<std::ptrdiff_t>(firstPart),
+                   meshes.end(),
+                   std::back_inserter(ptrs),
+                   [](const auto& m) { return m.GetPointer(); });
+    const size_t knownValues = commonCatValues_.size();
+    addCommonCatValues(ptrs, commonCatValues_);
+    sharedCatChanged = commonCatValues_.size() != knownValues;
+    if (sharedCatChanged) {
+      renderer_.setSharedCatAnalysis(commonCatAnalysis(commonCatValues_));
+    }
+  }
+
+  if (options_.explodeView) {
+    if (sharedCatChanged) {
+      refreshFacetCategories();
+    }
+    setupFacetMode(firstPart);
+    return;
+  }
+  if (!sceneStarted_) {
+    sceneStarted_ = true;
+    setupNormalMode();
+    return;
+  }
+
+  const std::vector<vtkSmartPointer<vtkDataSet>> newMeshes(
+      meshes.begin() + static_cast<std::ptrdiff_t>(firstPart), meshes.end());
+  const std::vector<std::array<double, 3>> newColors(
+      partColors_.begin() + static_cast<std::ptrdiff_t>(firstPart), partColors_.end());
+  renderer_.addMeshes(newMeshes, newColors);
+  addPartsTreeGroups(firstGroup);
+
+  // Keep the active scalar (its range now spans the new parts too); the first
+  // parts with scalars at all select the first field, as at startup.
+  const std::vector<ScalarField> previous = std::move(scalarFields_);
+  scalarFields_ = collectScalarUnion(meshes);
+  if (activeScalarIdx_ >= 0) {
+    const ScalarField& active = previous[static_cast<size_t>(activeScalarIdx_)];
+    const auto it =
+        std::find_if(scalarFields_.begin(), scalarFields_.end(), [&](const ScalarField& field) {
+          return field.name == active.name && field.association == active.association;
+        });
+    applyScalarAtIndex(static_cast<int>(it - scalarFields_.begin()));
+  } else if (previous.empty() && !scalarFields_.empty()) {
+    applyScalarAtIndex(0);
+  }
+}
+
+void ViewerWindow::finishLoading(MeshLoadResult result) {
+  if (loader_.joinable()) {
+    loader_.join();
+  }
+  progressTimer_->stop();
+  if (progressBar_) {
+    progressBar_->deleteLater();
+  }
+
+  if (!result.ok && !result.cancelled) {
+    std::cerr << result.error << '\n';
+    QCoreApplication::exit(result.exitCode);
+    return;
+  }
+  if (load_.meshes.meshes.empty()) {
+    // Cancelled before anything was shown.
+    close();
+    return;
+  }
+
+  temporal_ = result.temporal;
+  if (!options_.explodeView && temporal_ && temporal_->playable()) {
+    setupPlayback();
+    // Re-apply the scalar so playback reads only its array and its color range
+    // spans the whole series.
+    if (activeScalarIdx_ >= 0) {
+      applyScalarAtIndex(activeScalarIdx_);
+    }
+  }
+}
+
+void ViewerWindow::cancelLoading() {
+  cancelLoad_ = true;
+}
+
 // ── playback toolbar for temporal (time-series) meshes ─────────────────
 void ViewerWindow::setupPlayback() {
   const int numSteps = temporal_->steps();
   playbackBar_ = new PlaybackBar(numSteps, vtkWidget_);
+  // The loaded mesh shows the initial step (the opened file of a numbered
+  // series), so playback starts there.
+  currentPlaybackStep_ = temporal_->initialStep();
+  playbackBar_->setStep(currentPlaybackStep_, temporal_->timeAt(currentPlaybackStep_));
   playbackBar_->setGeometry(playbackBarGeometry(vtkWidget_));
   playbackBar_->raise();
   playbackBar_->show();
 
   playTimer_ = new QTimer(this);
 
+  auto onPrefetched = [this](int step) {
+    QMetaObject::invokeMethod(
+        this, [this, step]() { onFramePrefetched(step); }, Qt::QueuedConnection);
+  };
+  prefetcher_ = std::make_unique<FramePrefetcher>(
+      *temporal_, load_.meshes.meshes.front(), onPrefetched, options_.frameCacheBytes);
+  if (!prefetcher_->valid()) {
+    prefetcher_.reset();
+  } else {
+    prefetcher_->setLoop(playbackBar_->loopEnabled());
+    applyPlayTimerInterval();
+  }
+  startRangeIndex();
+
   QObject::connect(playTimer_, &QTimer::timeout, this, [this, numSteps]() {
     int next = playbackBar_->currentStep() + 1;
     if (next >= numSteps) {
@@ -609,8 +816,12 @@ void ViewerWindow::setupPlayback() {
       playbackBar_, &PlaybackBar::stepRequested, this, [this](int step) { showFrame(step); });
 
   QObject::connect(playbackBar_, &PlaybackBar::speedChanged, this, [this](double) {
-    if (playTimer_->isActive()) {
-      applyPlayTimerInterval();
+    applyPlayTimerInterval();
+  });
+
+  QObject::connect(playbackBar_, &PlaybackBar::loopToggled, this, [this](bool loop) {
+    if (prefetcher_) {
+      prefetcher_->setLoop(loop);
     }
   });
 
@@ -618,21 +829,94 @@ void ViewerWindow::setupPlayback() {
       0, this, [this]() { playbackBar_->setGeometry(playbackBarGeometry(vtkWidget_)); });
 }
 
+// The exact range index: loaded from the file's sidecar if it is current,
+// otherwise built from every step on rangeScan_ (through a reader of its own)
+// and saved for the next open.
+void ViewerWindow::startRangeIndex() {
+  const std::string path = temporal_->fileName();
+  std::vector<std::string> inputs = temporal_->inputFiles();
+  auto index = std::make_shared<ScalarRangeIndex>();
+  if (!path.empty() && index->load(path, inputs) && index->steps() == temporal_->steps()) {
+    rangeIndex_ = std::move(index);
+    return;
+  }
+  std::shared_ptr<TemporalSource> scanner = temporal_->clone();
+  if (!scanner) {
+    return;
+  }
+  scanner->setActiveArray({});
+  vtkSmartPointer<vtkDataSet> prototype;
+  prototype.TakeReference(load_.meshes.meshes.front()->NewInstance());
+  prototype->ShallowCopy(load_.meshes.meshes.front());
+  rangeIndexPending_ = true;
+  rangeScan_ = std::thread([this, scanner, prototype, path, inputs = std::move(inputs), index]() {
+    std::shared_ptr<const ScalarRangeIndex> built;
+    if (index->build(*scanner, prototype, &cancelRangeScan_)) {
+      if (!path.empty()) {
+        index->save(path, inputs);
+      }
+      built = index;
+    }
+    QMetaObject::invokeMethod(
+        this, [this, built]() { onRangeIndexReady(built); }, Qt::QueuedConnection);
+  });
+}
+
+void ViewerWindow::onRangeIndexReady(std::shared_ptr<const ScalarRangeIndex> index) {
+  if (rangeScan_.joinable()) {
+    rangeScan_.join();
+  }
+  rangeIndexPending_ = false;
+  rangeIndex_ = std::move(index);
+  // Fix the active scalar's range now that it is known (or sample it if the
+  // scan failed).
+  if (activeScalarIdx_ >= 0) {
+    applyScalarAtIndex(activeScalarIdx_);
+  }
+}
+
 void ViewerWindow::showFrame(int step) {
   if (!temporal_ || step < 0 || step >= temporal_->steps() || load_.meshes.meshes.empty()) {
     return;
   }
-  temporal_->readStepInto(step, load_.meshes.meshes.front());
+  if (prefetcher_) {
+    // A step still being read is shown by onFramePrefetched; until then the
+    // current frame stays up and the play timer does not advance.
+    if (!prefetcher_->take(step, load_.meshes.meshes.front())) {
+      pendingStep_ = step;
+      return;
+    }
+  } else {
+    temporal_->readStepInto(step, load_.meshes.meshes.front());
+  }
+  pendingStep_ = -1;
   renderer_.refreshAfterDataChange();
   currentPlaybackStep_ = step;
   if (playbackBar_) {
     playbackBar_->setStep(step, temporal_->timeAt(step));
+    if (prefetcher_ && options_.frameCacheBytes > 0) {
+      const FrameCache::Stats stats = prefetcher_->cacheStats();
+      playbackBar_->setToolTip(QStringLiteral("Frame cache: %1 steps, %2 MB; %3 hits, %4 misses")
+                                   .arg(stats.frames)
+                                   .arg(stats.bytes >> 20)
+                                   .arg(stats.hits)
+                                   .arg(stats.misses));
+    }
+  }
+}
+
+void ViewerWindow::onFramePrefetched(int step) {
+  if (step == pendingStep_) {
+    showFrame(step);
   }
 }
 
 void ViewerWindow::applyPlayTimerInterval() {
-  const double fps = 15.0 * playbackBar_->speedMultiplier();
+  const double fps = kPlaybackFps * playbackBar_->speedMultiplier();
   playTimer_->setInterval(std::max(1, static_cast<int>(std::round(1000.0 / fps))));
+  if (prefetcher_) {
+    prefetcher_->setLookahead(static_cast<int>(std::ceil(fps * kPrefetchSeconds)));
+  }
 }
 
 // ── scalar handling ────────────────────────────────────────────────────
@@ -653,12 +937,15 @@ void ViewerWindow::applyScalarAtIndex(int index) {
   const std::string& scalarName = field.name;
 
   // Temporal: restrict frame reads to this array and reload the current frame so
-  // the mesh holds it before the scalar is applied. Reader array selection only
-  // covers point data, so cell fields fall back to reading all arrays per frame.
-  const bool temporalPoint =
-      temporal_ && temporal_->playable() && field.association == FieldAssociation::Point;
-  if (temporalPoint) {
-    temporal_->setActiveArray(scalarName);
+  // the mesh holds it before the scalar is applied.
+  const bool streamed = temporal_ && temporal_->playable();
+  // The reads below go through temporal_'s own reader: hold the prefetcher.
+  const FramePrefetcher::Pause pause(streamed ? prefetcher_.get() : nullptr);
+  if (streamed) {
+    temporal_->setActiveArray(field);
+    if (prefetcher_) {
+      prefetcher_->setActiveArray(field);
+    }
     temporal_->readStepInto(currentPlaybackStep_, load_.meshes.meshes.front());
   }
 
@@ -668,25 +955,16 @@ void ViewerWindow::applyScalarAtIndex(int index) {
   activeScalarIdx_ = index;
   colorBar_->setTitle(scalarTitle(field));
 
-  // For temporal data, fix the color range to the union across sampled steps so
+  // For temporal data, fix the color range to the union across all steps so
   // the colormap does not flicker as frames advance.
-  if (temporalPoint) {
-    auto cached = temporalRangeCache_.find(scalarName);
-    if (cached == temporalRangeCache_.end()) {
-      double sampled[2];
-      if (temporal_->sampledScalarRange(scalarName, sampled)) {
-        cached =
-            temporalRangeCache_.emplace(scalarName, std::array<double, 2>{sampled[0], sampled[1]})
-                .first;
-      }
-    }
-    if (cached != temporalRangeCache_.end()) {
-      renderer_.setActiveScalarRange(cached->second[0], cached->second[1]);
-    }
+  double fixedRange[2];
+  if (streamed && temporalScalarRange(field, fixedRange)) {
+    renderer_.setActiveScalarRange(fixedRange[0], fixedRange[1]);
   }
 
   double globalRange[2] = {0.0, 1.0};
-  if (!renderer_.getActiveScalarGlobalRange(globalRange)) {
+  if (!renderer_.getActiveScalarGlobalRange(globalRange) ||
+      renderer_.getActiveScalarAnalysis().directColors) {
     colorBar_->setVisible(false);
     return;
   }
@@ -704,6 +982,31 @@ void ViewerWindow::applyScalarAtIndex(int index) {
   }
 }
 
+// The range a temporal scalar keeps for the whole animation: exact once the
+// range index is there. While it is being built the current frame's range is
+// used, so selecting a scalar never waits on the disk; with no index coming,
+// the array is sampled at a few steps instead.
+bool ViewerWindow::temporalScalarRange(const ScalarField& field, double out[2]) {
+  if (rangeIndex_ && rangeIndex_->range(field.name, field.association, out)) {
+    return true;
+  }
+  if (rangeIndexPending_) {
+    return false;
+  }
+  const auto key = std::make_pair(field.association, field.name);
+  auto cached = temporalRangeCache_.find(key);
+  if (cached == temporalRangeCache_.end()) {
+    double sampled[2];
+    if (!temporal_->sampledScalarRange(field, sampled)) {
+      return false;
+    }
+    cached = temporalRangeCache_.emplace(key, std::array<double, 2>{sampled[0], sampled[1]}).first;
+  }
+  out[0] = cached->second[0];
+  out[1] = cached->second[1];
+  return true;
+}
+
 void ViewerWindow::cycleScalar() {
   if (scalarFields_.empty()) {
     applyNoScalar();
@@ -724,6 +1027,10 @@ void ViewerWindow::cycleScalar() {
 // ── overlay layout ─────────────────────────────────────────────────────
 void ViewerWindow::onViewportResize() {
   layoutFacetColorBars();
+  if (progressBar_) {
+    progressBar_->setGeometry(playbackBarGeometry(vtkWidget_));
+    progressBar_->raise();
+  }
   if (playbackBar_) {
     playbackBar_->setGeometry(playbackBarGeometry(vtkWidget_));
     playbackBar_->raise();
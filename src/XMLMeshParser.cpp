@@ -1,127 +1,294 @@
 #include "XMLMeshParser.h"
 
-#include "mesh_utils.h"
+#include "ByteSource.h"
+#include "XmlPullReader.h"
+#include "parallel_utils.h"
+#include "text_scan.h"
 
+#include <algorithm>
 #include <iostream>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <vtkCellArray.h>
 #include <vtkFieldData.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
-#include <vtkXMLDataElement.h>
-#include <vtkXMLUtilities.h>
 
-XMLMeshParser::~XMLMeshParser() = default;
+namespace {
+
+// Character data of one element, as a byte range of the mapped file.
+struct TextSpan {
+  const char* begin = nullptr;
+  const char* end = nullptr;
 
-// Helper: parse doubles from string (copied from main.cpp)
-static std::vector<double> ParseDoubles(const std::string& s) {
-  std::istringstream iss(s);
-  std::vector<double> v;
-  double x;
-  while (iss >> x)
-    v.push_back(x);
-  return v;
+  explicit operator bool() const {
+    return begin != nullptr;
+  }
+  size_t size() const {
+    return static_cast<size_t>(end - begin);
+  }
+};
+
+// Where one <Volume> keeps its data; filled by the sequential scan, parsed later.
+struct VolumeSpans {
+  std::string name;
+  TextSpan vertices;
+  TextSpan polygons;
+  TextSpan normals;
+};
+
+size_t countTokens(TextSpan text) {
+  size_t count = 0;
+  bool inToken = false;
+  for (const char* p = text.begin; p < text.end; ++p) {
+    const bool blank = *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+    if (!blank && !inToken)
+      ++count;
+    inToken = !blank;
+  }
+  return count;
 }
-// Helper: parse ids from string
-static std::vector<vtkIdType> ParseIds(const std::string& s) {
-  std::istringstream iss(s);
-  std::vector<vtkIdType> v;
-  long long x;
-  while (iss >> x)
-    v.push_back(static_cast<vtkIdType>(x));
-  return v;
+
+// Parse whitespace-separated reals into a new float array, stopping at the
+// first token that is not a number (as stream extraction did before).
+vtkSmartPointer<vtkFloatArray> parseReals(TextSpan text) {
+  auto values = vtkSmartPointer<vtkFloatArray>::New();
+  values->SetNumberOfValues(static_cast<vtkIdType>(countTokens(text)));
+  float* out = values->GetPointer(0);
+  const char* p = text.begin;
+  vtkIdType n = 0;
+  while (n < values->GetNumberOfValues() && scanReal(p, text.end, out[n]))
+    ++n;
+  values->SetNumberOfValues(n);
+  return values;
 }
 
-std::vector<vtkSmartPointer<vtkDataSet>> XMLMeshParser::parse(const std::string& filename) {
-  std::vector<vtkSmartPointer<vtkDataSet>> polys;
-  vtkSmartPointer<vtkXMLDataElement> root = vtkSmartPointer<vtkXMLDataElement>::Take(
-      vtkXMLUtilities::ReadElementFromFile(filename.c_str()));
-  if (!root) {
-    std::cerr << "Failed to read XML: " << filename << '\n';
-    return polys;
+// Same for ids; `sawZero` tells the caller whether the list is zero-based.
+vtkSmartPointer<vtkIdTypeArray> parseIds(TextSpan text, bool& sawZero) {
+  auto values = vtkSmartPointer<vtkIdTypeArray>::New();
+  values->SetNumberOfValues(static_cast<vtkIdType>(countTokens(text)));
+  vtkIdType* out = values->GetPointer(0);
+  const char* p = text.begin;
+  vtkIdType n = 0;
+  sawZero = false;
+  while (n < values->GetNumberOfValues() && scanInt(p, text.end, out[n])) {
+    sawZero = sawZero || out[n] == 0;
+    ++n;
   }
-  vtkXMLDataElement* body = root->FindNestedElementWithName("DIFBody");
-  if (!body)
-    body = root;
-  vtkXMLDataElement* vols = body->FindNestedElementWithName("Volumes");
-  if (!vols) {
-    std::cerr << "No <Volumes> in XML: " << filename << '\n';
-    return polys;
+  values->SetNumberOfValues(n);
+  return values;
+}
+
+vtkSmartPointer<vtkPolyData> buildVolume(const VolumeSpans& spans, const std::string& filename) {
+  if (!spans.vertices || !spans.polygons)
+    return nullptr;
+  vtkSmartPointer<vtkFloatArray> coords = parseReals(spans.vertices);
+  if (coords->GetNumberOfValues() % 3 != 0)
+    return nullptr;
+  bool zeroBased = false;
+  vtkSmartPointer<vtkIdTypeArray> connectivity = parseIds(spans.polygons, zeroBased);
+  const vtkIdType idCount = connectivity->GetNumberOfValues();
+  if (idCount % 3 != 0)
+    return nullptr;
+
+  // Ids are one-based unless any of them is zero.
+  vtkIdType* ids = connectivity->GetPointer(0);
+  const vtkIdType pointCount = coords->GetNumberOfValues() / 3;
+  if (!zeroBased)
+    std::for_each(ids, ids + idCount, [](vtkIdType& id) { --id; });
+  if (!std::all_of(ids, ids + idCount, [pointCount](vtkIdType id) {
+        return id >= 0 && id < pointCount;
+      })) {
+    std::cerr << "Volume '" << spans.name << "' has out-of-range polygon index in " << filename
+              << '\n';
+    return nullptr;
   }
-  for (int i = 0; i < vols->GetNumberOfNestedElements(); ++i) {
-    vtkXMLDataElement* vol = vols->GetNestedElement(i);
-    if (std::string(vol->GetName()) != "Volume")
-      continue;
-    vtkXMLDataElement* vertsElem = vol->FindNestedElementWithName("Vertices");
-    if (!vertsElem)
+
+  coords->SetNumberOfComponents(3);
+  coords->SetNumberOfTuples(pointCount);
+  vtkNew<vtkPoints> pts;
+  pts->SetData(coords);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(idCount / 3 + 1);
+  for (vtkIdType i = 0; i < offsets->GetNumberOfValues(); ++i)
+    offsets->SetValue(i, i * 3);
+  vtkNew<vtkCellArray> polysArr;
+  polysArr->SetData(offsets, connectivity);
+
+  auto poly = vtkSmartPointer<vtkPolyData>::New();
+  poly->SetPoints(pts);
+  poly->SetPolys(polysArr);
+
+  if (!spans.name.empty()) {
+    vtkNew<vtkStringArray> partNameArray;
+    partNameArray->SetName("vv_part_name");
+    partNameArray->InsertNextValue(spans.name);
+    poly->GetFieldData()->AddArray(partNameArray);
+  }
+
+  if (spans.normals) {
+    vtkSmartPointer<vtkFloatArray> normals = parseReals(spans.normals);
+    if (normals->GetNumberOfValues() == pointCount * 3) {
+      normals->SetName("Normals");
+      normals->SetNumberOfComponents(3);
+      normals->SetNumberOfTuples(pointCount);
+      poly->GetPointData()->SetNormals(normals);
+      poly->GetPointData()->AddArray(normals);
+    }
+  }
+  return poly;
+}
+
+// Read the children of the <Volume> the reader has just entered, keeping the
+// first Vertices, Polygons and Normals.
+bool scanVolume(XmlPullReader& xml, VolumeSpans& volume) {
+  const size_t depth = xml.depth();
+  while (true) {
+    const XmlPullReader::Event event = xml.next();
+    if (event == XmlPullReader::Event::Error || event == XmlPullReader::Event::EndDocument)
+      return false;
+    if (event == XmlPullReader::Event::EndElement && xml.depth() == depth)
+      return true;
+    if (event != XmlPullReader::Event::StartElement)
       continue;
-    auto verts = ParseDoubles(vertsElem->GetCharacterData() ? vertsElem->GetCharacterData() : "");
-    if (verts.size() % 3 != 0)
+    TextSpan* target = nullptr;
+    if (xml.name() == "Vertices")
+      target = &volume.vertices;
+    else if (xml.name() == "Polygons")
+      target = &volume.polygons;
+    else if (xml.name() == "Normals")
+      target = &volume.normals;
+    const char* contentBegin = xml.contentBegin();
+    if (!xml.skipElement())
+      return false;
+    if (target && !*target)
+      *target = {contentBegin, xml.tagBegin()};
+  }
+}
+
+// Sequential pass over the document that records where each volume's data
+// lives. Volumes come from the first <Volumes> under <DIFBody> (or under the
+// root element when there is no DIFBody).
+enum class ScanResult { Ok, Malformed, NoVolumes };
+
+ScanResult scanDocument(XmlPullReader& xml, std::vector<VolumeSpans>& volumes) {
+  using Event = XmlPullReader::Event;
+  if (xml.next() != Event::StartElement)
+    return ScanResult::Malformed;
+
+  // Root children: the volume container sits under the first DIFBody or, in
+  // files without one, directly under the root.
+  bool inBody = false;
+  bool sawBody = false;
+  bool found = false;
+  bool foundInBody = false;
+  std::vector<VolumeSpans> rootVolumes;
+  while (true) {
+    const Event event = xml.next();
+    if (event == Event::Error)
+      return ScanResult::Malformed;
+    if (event == Event::EndDocument)
+      break;
+    if (event == Event::EndElement) {
+      if (xml.depth() == 2 && xml.name() == "DIFBody")
+        inBody = false;
       continue;
-    vtkNew<vtkPoints> pts;
-    pts->SetNumberOfPoints(static_cast<vtkIdType>(verts.size() / 3));
-    for (vtkIdType vi = 0; vi < static_cast<vtkIdType>(verts.size() / 3); ++vi) {
-      const size_t vi3 = static_cast<size_t>(vi) * 3;
-      pts->SetPoint(vi, verts[vi3], verts[vi3 + 1], verts[vi3 + 2]);
     }
-    vtkXMLDataElement* polyElem = vol->FindNestedElementWithName("Polygons");
-    if (!polyElem)
+    const size_t depth = xml.depth();
+    if (depth == 2 && xml.name() == "DIFBody" && !sawBody) {
+      inBody = sawBody = true;
       continue;
-    auto ids = ParseIds(polyElem->GetCharacterData() ? polyElem->GetCharacterData() : "");
-    if (ids.size() % 3 != 0)
-      continue;
-    vtkNew<vtkCellArray> polysArr;
-    vtkIdType tri[3];
-    bool oneBased = true;
-    if (std::any_of(ids.begin(), ids.end(), [](vtkIdType v) { return v == 0; }))
-      oneBased = false;
-    for (size_t j = 0; j < ids.size(); j += 3) {
-      tri[0] = ids[j + 0] - (oneBased ? 1 : 0);
-      tri[1] = ids[j + 1] - (oneBased ? 1 : 0);
-      tri[2] = ids[j + 2] - (oneBased ? 1 : 0);
-      polysArr->InsertNextCell(3, tri);
     }
-    vtkNew<vtkPolyData> poly;
-    poly->SetPoints(pts);
-    poly->SetPolys(polysArr);
-
-    const char* volumeName = vol->GetAttribute("name");
-    if (volumeName && std::string(volumeName).size() > 0) {
-      vtkNew<vtkStringArray> partNameArray;
-      partNameArray->SetName("vv_part_name");
-      partNameArray->InsertNextValue(volumeName);
-      poly->GetFieldData()->AddArray(partNameArray);
+    const bool candidate = xml.name() == "Volumes" &&
+                           ((inBody && depth == 3 && !foundInBody) || (depth == 2 && !found));
+    if (!candidate) {
+      if (!xml.skipElement())
+        return ScanResult::Malformed;
+      continue;
     }
-
-    vtkXMLDataElement* normElem = vol->FindNestedElementWithName("Normals");
-    if (normElem) {
-      auto n = ParseDoubles(normElem->GetCharacterData() ? normElem->GetCharacterData() : "");
-      if (n.size() == verts.size()) {
-        vtkNew<vtkFloatArray> an;
-        an->SetName("Normals");
-        an->SetNumberOfComponents(3);
-        an->SetNumberOfTuples(static_cast<vtkIdType>(n.size() / 3));
-        for (vtkIdType ni = 0; ni < static_cast<vtkIdType>(n.size() / 3); ++ni) {
-          const size_t ni3 = static_cast<size_t>(ni) * 3;
-          const float tuple[3] = {static_cast<float>(n[ni3]),
-                                  static_cast<float>(n[ni3 + 1]),
-                                  static_cast<float>(n[ni3 + 2])};
-          an->SetTypedTuple(ni, tuple);
-        }
-        poly->GetPointData()->SetNormals(an);
-        poly->GetPointData()->AddArray(an);
+    std::vector<VolumeSpans>& out = inBody ? volumes : rootVolumes;
+    while (true) {
+      const Event child = xml.next();
+      if (child == Event::Error || child == Event::EndDocument)
+        return ScanResult::Malformed;
+      if (child == Event::EndElement)
+        break;
+      if (xml.name() != "Volume") {
+        if (!xml.skipElement())
+          return ScanResult::Malformed;
+        continue;
       }
+      VolumeSpans volume;
+      xml.attribute("name", volume.name);
+      if (!scanVolume(xml, volume))
+        return ScanResult::Malformed;
+      out.push_back(std::move(volume));
     }
-    polys.push_back(poly);
+    (inBody ? foundInBody : found) = true;
+  }
+  if (sawBody)
+    return foundInBody ? ScanResult::Ok : ScanResult::NoVolumes;
+  if (!found)
+    return ScanResult::NoVolumes;
+  volumes = std::move(rootVolumes);
+  return ScanResult::Ok;
+}
+
+} // namespace
+
+XMLMeshParser::~XMLMeshParser() = default;
+
+std::string XMLMeshParser::cacheTag() const {
+  return "dif-xml/2";
+}
+
+std::vector<vtkSmartPointer<vtkDataSet>> XMLMeshParser::parse(const std::string& filename) {
+  std::vector<vtkSmartPointer<vtkDataSet>> polys;
+  ByteSource file;
+  if (!openInput(file, filename)) {
+    std::cerr << "Failed to read XML: " << filename << '\n';
+    return polys;
+  }
+  XmlPullReader xml(file.begin(), file.end());
+  std::vector<VolumeSpans> volumes;
+  switch (scanDocument(xml, volumes)) {
+  case ScanResult::Malformed:
+    std::cerr << "Failed to read XML: " << filename << '\n';
+    return polys;
+  case ScanResult::NoVolumes:
+    std::cerr << "No <Volumes> in XML: " << filename << '\n';
+    return polys;
+  case ScanResult::Ok:
+    break;
+  }
+
+  // Volumes are independent; parse their numbers concurrently, then keep the
+  // valid ones in document order.
+  std::vector<vtkSmartPointer<vtkPolyData>> built(volumes.size());
+  parallelFor(volumes.size(), [&](size_t i) {
+    if (cancelled())
+      return;
+    const VolumeSpans& volume = volumes[i];
+    built[i] = buildVolume(volume, filename);
+    advance(volume.vertices.size() + volume.polygons.size() + volume.normals.size());
+  });
+  if (cancelled())
+    return polys;
+  for (auto& poly : built) {
+    if (poly)
+      polys.push_back(poly);
   }
   return polys;
 }
 
-bool XMLMeshParser::canParse(const std::string& filename) {
-  std::string header = readHeader(filename, 200);
-  return header.find("xml") != std::string::npos && header.find("DIF") != std::string::npos;
+bool XMLMeshParser::canParse(const FileHead& head) {
+  const std::string_view header = head.prefix(200);
+  return header.find("xml") != std::string_view::npos &&
+         header.find("DIF") != std::string_view::npos;
 }
@@ -0,0 +1,160 @@
+#include "XmlPullReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool isNameChar(char c) {
+  return c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '>' && c != '/' && c != '=';
+}
+
+// Position just past `terminator` at or after `from`, or nullptr.
+const char* skipPast(const char* from, const char* end, std::string_view terminator) {
+  const char* hit = std::search(from, end, terminator.begin(), terminator.end());
+  return hit == end ? nullptr : hit + terminator.size();
+}
+
+void appendDecoded(std::string_view raw, std::string& out) {
+  static const std::pair<std::string_view, char> entities[] = {
+      {"&lt;", '<'}, {"&gt;", '>'}, {"&amp;", '&'}, {"&quot;", '"'}, {"&apos;", '\''}};
+  out.clear();
+  out.reserve(raw.size());
+  for (size_t i = 0; i < raw.size();) {
+    bool decoded = false;
+    if (raw[i] == '&') {
+      for (const auto& [entity, c] : entities) {
+        if (raw.compare(i, entity.size(), entity) == 0) {
+          out.push_back(c);
+          i += entity.size();
+          decoded = true;
+          break;
+        }
+      }
+    }
+    if (!decoded)
+      out.push_back(raw[i++]);
+  }
+}
+
+} // namespace
+
+XmlPullReader::XmlPullReader(const char* begin, const char* end) : p_(begin), end_(end) {
+}
+
+XmlPullReader::Event XmlPullReader::next() {
+  if (pendingEnd_) {
+    pendingEnd_ = false;
+    return Event::EndElement;
+  }
+  while (true) {
+    const auto* lt = static_cast<const char*>(std::memchr(p_, '<', static_cast<size_t>(end_ - p_)));
+    if (!lt)
+      return stack_.empty() ? Event::EndDocument : Event::Error;
+    tagBegin_ = lt;
+    const char* q = lt + 1;
+    if (q >= end_)
+      return Event::Error;
+
+    // Markup that is not an element.
+    const char* skipped = nullptr;
+    if (*q == '?') {
+      skipped = skipPast(q, end_, "?>");
+    } else if (*q == '!') {
+      const std::string_view rest(q, static_cast<size_t>(end_ - q));
+      if (rest.compare(0, 3, "!--") == 0)
+        skipped = skipPast(q, end_, "-->");
+      else if (rest.compare(0, 8, "![CDATA[") == 0)
+        skipped = skipPast(q, end_, "]]>");
+      else
+        skipped = skipPast(q, end_, ">");
+    }
+    if (*q == '?' || *q == '!') {
+      if (!skipped)
+        return Event::Error;
+      p_ = skipped;
+      continue;
+    }
+
+    // Find the closing '>' outside quoted attribute values.
+    const bool closing = *q == '/';
+    if (closing)
+      ++q;
+    const char* gt = q;
+    char quote = 0;
+    for (; gt < end_; ++gt) {
+      if (quote) {
+        if (*gt == quote)
+          quote = 0;
+      } else if (*gt == '"' || *gt == '\'') {
+        quote = *gt;
+      } else if (*gt == '>') {
+        break;
+      }
+    }
+    if (gt >= end_)
+      return Event::Error;
+    const char* nameEnd = q;
+    while (nameEnd < gt && isNameChar(*nameEnd))
+      ++nameEnd;
+    name_ = std::string_view(q, static_cast<size_t>(nameEnd - q));
+    tagEnd_ = gt + 1;
+    p_ = tagEnd_;
+    if (name_.empty())
+      return Event::Error;
+
+    if (closing) {
+      if (stack_.empty() || stack_.back() != name_)
+        return Event::Error;
+      depth_ = stack_.size();
+      stack_.pop_back();
+      return Event::EndElement;
+    }
+    const bool selfClosing = gt[-1] == '/';
+    const char* attributesEnd = selfClosing ? gt - 1 : gt;
+    attributes_ = std::string_view(nameEnd, static_cast<size_t>(attributesEnd - nameEnd));
+    if (selfClosing)
+      pendingEnd_ = true;
+    else
+      stack_.push_back(name_);
+    depth_ = stack_.size() + (selfClosing ? 1u : 0u);
+    return Event::StartElement;
+  }
+}
+
+bool XmlPullReader::attribute(std::string_view attribute, std::string& value) const {
+  size_t pos = 0;
+  while (pos < attributes_.size()) {
+    pos = attributes_.find_first_not_of(" \t\r\n", pos);
+    if (pos == std::string_view::npos)
+      return false;
+    const size_t eq = attributes_.find('=', pos);
+    if (eq == std::string_view::npos)
+      return false;
+    std::string_view key = attributes_.substr(pos, eq - pos);
+    key = key.substr(0, key.find_last_not_of(" \t\r\n") + 1);
+    const size_t open = attributes_.find_first_of("\"'", eq);
+    if (open == std::string_view::npos)
+      return false;
+    const size_t close = attributes_.find(attributes_[open], open + 1);
+    if (close == std::string_view::npos)
+      return false;
+    if (key == attribute) {
+      appendDecoded(attributes_.substr(open + 1, close - open - 1), value);
+      return true;
+    }
+    pos = close + 1;
+  }
+  return false;
+}
+
+bool XmlPullReader::skipElement() {
+  const size_t target = depth_;
+  while (true) {
+    const Event event = next();
+    if (event == Event::Error || event == Event::EndDocument)
+      return false;
+    if (event == Event::EndElement && depth_ == target)
+      return true;
+  }
+}
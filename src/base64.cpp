@@ -0,0 +1,86 @@
+#include "base64.h"
+
+#include "text_scan.h"
+
+#include <array>
+#include <cstdint>
+
+namespace {
+
+const std::array<int8_t, 256>& alphabetValues() {
+  static const std::array<int8_t, 256> table = [] {
+    std::array<int8_t, 256> t{};
+    t.fill(-1);
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (int8_t i = 0; i < 64; ++i) {
+      t[static_cast<unsigned char>(alphabet[i])] = i;
+    }
+    return t;
+  }();
+  return table;
+}
+
+// Append the bytes of the quartet at `p` to `out` and move `p` past it. With
+// `unpadded`, text ending after two or three characters stands for padding.
+bool decodeQuartet(const char*& p, const char* end, bool unpadded, std::string& out) {
+  const std::array<int8_t, 256>& table = alphabetValues();
+  uint32_t bits = 0;
+  int padding = 0;
+  for (int i = 0; i < 4; ++i) {
+    p = skipBlanks(p, end);
+    if (p == end) {
+      if (!unpadded || i < 2) {
+        return false;
+      }
+      bits <<= 6 * (4 - i);
+      padding += 4 - i;
+      break;
+    }
+    const char c = *p++;
+    bits <<= 6;
+    if (c == '=') {
+      ++padding;
+      continue;
+    }
+    const int8_t value = table[static_cast<unsigned char>(c)];
+    if (value < 0 || padding > 0) {
+      return false;
+    }
+    bits |= static_cast<uint32_t>(value);
+  }
+  if (padding > 2) {
+    return false;
+  }
+  out.push_back(static_cast<char>((bits >> 16) & 0xFFu));
+  if (padding < 2) {
+    out.push_back(static_cast<char>((bits >> 8) & 0xFFu));
+  }
+  if (padding < 1) {
+    out.push_back(static_cast<char>(bits & 0xFFu));
+  }
+  return true;
+}
+
+} // namespace
+
+bool decodeBase64(std::string_view text, std::string& out) {
+  out.clear();
+  out.reserve(text.size() / 4 * 3);
+  const char* p = text.data();
+  const char* end = p + text.size();
+  while ((p = skipBlanks(p, end)) != end) {
+    if (!decodeQuartet(p, end, true, out)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool decodeBase64(const char*& p, const char* end, size_t size, std::string& out) {
+  while (out.size() < size) {
+    if (!decodeQuartet(p, end, false, out)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,40 @@
+#include "byte_order.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VV_BYTE_ORDER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+void byteSwap32Block(const char* src, void* dst, size_t count) {
+  auto* out = static_cast<char*>(dst);
+  size_t i = 0;
+#if defined(__SSSE3__)
+  const __m128i mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), _mm_shuffle_epi8(v, mask));
+  }
+#elif defined(VV_BYTE_ORDER_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+    // Swap the bytes of each 16-bit half, then the two halves of each word.
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+  }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+  for (; i + 4 <= count; i += 4) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i * 4));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out + i * 4), vrev32q_u8(v));
+  }
+#endif
+  for (; i < count; ++i) {
+    const uint32_t value = loadBigEndian32(src + i * 4);
+    std::memcpy(out + i * 4, &value, sizeof(value));
+  }
+}
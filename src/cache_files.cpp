@@ -0,0 +1,71 @@
+#include "cache_files.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+FileStamp stampOf(const std::string& path) {
+  FileStamp stamp;
+  std::error_code ec;
+  const auto size = fs::file_size(path, ec);
+  if (ec) {
+    return stamp;
+  }
+  const auto mtime = fs::last_write_time(path, ec);
+  if (ec) {
+    return stamp;
+  }
+  stamp.exists = true;
+  stamp.size = static_cast<uint64_t>(size);
+  stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+  return stamp;
+}
+
+std::string canonicalPath(const std::string& path) {
+  std::error_code ec;
+  std::string canonical = fs::weakly_canonical(path, ec).string();
+  return ec || canonical.empty() ? path : canonical;
+}
+
+std::string hashedFileName(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  static const char kHex[] = "0123456789abcdef";
+  std::string name(16, '0');
+  for (size_t i = 0; i < 16; ++i, hash >>= 4) {
+    name[15 - i] = kHex[hash & 0xf];
+  }
+  return name;
+}
+
+bool writeFileAtomically(const std::string& path,
+                         const std::function<bool(std::ostream&)>& write) {
+  std::error_code ec;
+  const fs::path directory = fs::path(path).parent_path();
+  if (!directory.empty()) {
+    fs::create_directories(directory, ec);
+  }
+  const std::string tmp = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+    const bool written = file && write(file);
+    file.flush();
+    if (!written || !file) {
+      file.close();
+      fs::remove(tmp, ec);
+      return false;
+    }
+  }
+  fs::rename(tmp, path, ec);
+  if (ec) {
+    fs::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,23 @@
+#include "hdf5_lock.h"
+
+#include <vtk_hdf5.h>
+
+namespace {
+
+bool threadsafeHDF5() {
+  static const bool threadsafe = [] {
+    hbool_t safe = 0;
+    return H5is_library_threadsafe(&safe) >= 0 && safe;
+  }();
+  return threadsafe;
+}
+
+} // namespace
+
+std::unique_lock<std::mutex> lockHDF5() {
+  static std::mutex mutex;
+  if (threadsafeHDF5()) {
+    return std::unique_lock<std::mutex>();
+  }
+  return std::unique_lock<std::mutex>(mutex);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only bytes of a parser's input, whatever holds them: a memory mapping
+// of the file (the default) or a buffer filled through std::ifstream. Parsers
+// scan begin()..end() and do not care which, so one code path serves both.
+class ByteSource {
+public:
+  enum class Backing {
+    Mapped, // MappedFile: zero-copy, paged in on demand
+    Stream, // read whole through std::ifstream into an owned buffer
+  };
+
+  ByteSource() = default;
+  ByteSource(const ByteSource&) = delete;
+  ByteSource& operator=(const ByteSource&) = delete;
+  ByteSource(ByteSource&& other) noexcept;
+  ByteSource& operator=(ByteSource&& other) noexcept;
+
+  // Open `path` as `backing` says. Returns false if the file cannot be opened
+  // or read.
+  bool open(const std::string& path, Backing backing = Backing::Mapped);
+  void close();
+
+  bool isOpen() const {
+    return open_;
+  }
+  Backing backing() const {
+    return backing_;
+  }
+  const char* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+  const char* begin() const {
+    return data_;
+  }
+  const char* end() const {
+    return data_ + size_;
+  }
+
+private:
+  MappedFile mapped_;
+  std::vector<char> buffer_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+  Backing backing_ = Backing::Mapped;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "MeshParser.h"
+
+#include <memory>
+
+// Parses LS-DYNA d3plot result databases. The whole model becomes one
+// unstructured grid (solids, thick shells, beams and shells, with a "Material"
+// cell array) showing the first state; when the database holds more than one
+// state, a TemporalSource streams the rest for playback.
+class D3plotMeshParser : public MeshParser {
+public:
+  D3plotMeshParser();
+  ~D3plotMeshParser() override;
+
+  std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+
+  // Valid after a successful parse(); null for single-state databases.
+  std::shared_ptr<TemporalSource> temporal() const override {
+    return temporal_;
+  }
+
+private:
+  std::shared_ptr<TemporalSource> temporal_;
+};
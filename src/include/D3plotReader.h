@@ -0,0 +1,144 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Reader for LS-DYNA d3plot result families (d3plot, d3plot01, d3plot02, ...).
+// open() maps every family file, decodes the control and geometry sections and
+// indexes the state records once; a state's nodal and element data are then
+// read straight from the mapping. Single- and double-precision little-endian
+// databases are supported; SPH, particle, adaptive, CFD and rigid-road
+// databases are rejected. All read functions are const and thread-safe.
+class D3plotReader {
+public:
+  enum class NodalField { Coordinates, Velocity, Acceleration, Temperature };
+
+  // Elements of one kind in database order: nodesPerElement 0-based node
+  // indices per element, and the material number of each element.
+  struct ElementBlock {
+    int nodesPerElement = 0;
+    std::vector<int> nodes;
+    std::vector<int> materials;
+
+    size_t size() const {
+      return materials.size();
+    }
+  };
+
+  // Cheap check on the first 512 bytes of a file (see readHeader).
+  static bool looksLikeD3plot(const std::string& header);
+
+  // Map `path` and its family files and index the states. Reports to std::cerr
+  // and returns false if the database cannot be read.
+  bool open(const std::string& path);
+
+  size_t nodeCount() const {
+    return numNodes_;
+  }
+  // Node coordinates of the undeformed geometry, x y z per node.
+  const std::vector<float>& initialCoordinates() const {
+    return coordinates_;
+  }
+
+  const ElementBlock& solids() const {
+    return solids_;
+  }
+  const ElementBlock& thickShells() const {
+    return thickShells_;
+  }
+  const ElementBlock& beams() const {
+    return beams_;
+  }
+  const ElementBlock& shells() const {
+    return shells_;
+  }
+  // Element data is indexed solids, thick shells, beams, shells.
+  size_t elementCount() const {
+    return solids_.size() + thickShells_.size() + beams_.size() + shells_.size();
+  }
+
+  size_t stateCount() const {
+    return states_.size();
+  }
+  double stateTime(size_t state) const {
+    return states_[state].time;
+  }
+
+  bool hasNodalField(NodalField field) const;
+  // One state's nodal field into `out`: 3 floats per node, 1 for Temperature.
+  bool readNodalField(size_t state, NodalField field, float* out) const;
+
+  // One state's von Mises stress and effective plastic strain per element, in
+  // element order (maximum over integration points for shells). Elements
+  // without stress output (beams, rigid shells) get 0.
+  bool readElementStress(size_t state, float* vonMises, float* plasticStrain) const;
+
+private:
+  struct StateLocation {
+    size_t file;
+    size_t word;
+    double time;
+  };
+
+  bool readControl();
+  bool readGeometry(size_t& endWord);
+  // Where the states start in the first file, given where the geometry ends.
+  size_t firstStateWord(size_t geometryEnd) const;
+  void indexStates(size_t firstStateWord);
+
+  int64_t intWord(size_t file, size_t word) const;
+  double floatWord(size_t file, size_t word) const;
+  size_t fileWords(size_t file) const;
+  // Copy `count` float words starting at `word` into `out` as float32.
+  void copyFloats(size_t file, size_t word, size_t count, float* out) const;
+
+  std::vector<MappedFile> files_;
+  size_t wordSize_ = 4;
+
+  // Control section values used to walk the database.
+  size_t numNodes_ = 0;
+  size_t numGlobals_ = 0;
+  int tempFlag_ = 0;
+  int idtdt_ = 0;
+  bool hasCoords_ = false;
+  bool hasVelocity_ = false;
+  bool hasAcceleration_ = false;
+  int64_t numSolids_ = 0;
+  size_t numThickShells_ = 0;
+  size_t numBeams_ = 0;
+  size_t numShells_ = 0;
+  size_t nv3d_ = 0;
+  size_t nv3dt_ = 0;
+  size_t nv1d_ = 0;
+  size_t nv2d_ = 0;
+  size_t neips_ = 0;
+  size_t maxInt_ = 0;
+  int deletionMode_ = 0;
+  bool ioshlStress_ = false;
+  bool ioshlPlastic_ = false;
+  bool materialTypes_ = false;
+  size_t numArbs_ = 0;
+  size_t extraWords_ = 0;
+
+  std::vector<float> coordinates_;
+  ElementBlock solids_;
+  ElementBlock thickShells_;
+  ElementBlock beams_;
+  ElementBlock shells_;
+  std::vector<bool> rigidShell_;
+  size_t numRigidShells_ = 0;
+
+  // Word offsets inside a state record.
+  size_t nodalOffset_ = 0;
+  size_t coordsOffset_ = 0;
+  size_t velocityOffset_ = 0;
+  size_t accelerationOffset_ = 0;
+  size_t elementOffset_ = 0;
+  size_t stateWords_ = 0;
+
+  std::vector<StateLocation> states_;
+};
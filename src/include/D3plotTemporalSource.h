@@ -0,0 +1,48 @@
+#pragma once
+
+#include "TemporalSource.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <vtkSmartPointer.h>
+
+class D3plotReader;
+class vtkFloatArray;
+
+// Streams the states of an LS-DYNA d3plot database into the grid built from its
+// geometry. Each frame moves the points to the state's coordinates and fills:
+//   point data  Displacement, Velocity, Acceleration (magnitudes), Temperature
+//   cell data   Von Mises stress, Plastic strain
+// whichever the database carries.
+class D3plotTemporalSource : public TemporalSource {
+public:
+  // cellElements[i] is the element index (D3plotReader element order) of cell i.
+  D3plotTemporalSource(std::shared_ptr<const D3plotReader> reader,
+                       std::vector<uint32_t> cellElements);
+  ~D3plotTemporalSource() override;
+
+  int steps() const override;
+  double timeAt(int step) const override;
+  bool readStepInto(int step, vtkDataSet* target) override;
+  bool
+  sampledScalarRange(const ScalarField& field, double out[2], int maxSamples = 16) override;
+  // Only the named array is computed per frame; the element stresses are not
+  // read at all while a point array is active.
+  void setActiveArray(const ScalarField& field) override;
+  // Shares the reader, whose reads are thread-safe.
+  std::unique_ptr<TemporalSource> clone() const override;
+
+private:
+  std::vector<std::string> pointArrayNames() const;
+  vtkSmartPointer<vtkFloatArray>
+  pointArray(size_t state, const std::string& name, const std::vector<float>& coords) const;
+  void cellArrays(size_t state,
+                  vtkSmartPointer<vtkFloatArray>& vonMises,
+                  vtkSmartPointer<vtkFloatArray>& plasticStrain) const;
+
+  std::shared_ptr<const D3plotReader> reader_;
+  std::vector<uint32_t> cellElements_;
+  ScalarField activeArray_;
+};
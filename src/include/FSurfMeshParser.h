@@ -5,8 +5,10 @@
 #include <vector>
 #include <vtkSmartPointer.h>
 
+// Reads FreeSurfer surfaces (.pial, .surf, .white). Sibling overlays of the
+// same hemisphere (see findFSurfOverlays) are loaded alongside as point data.
 class FSurfMeshParser : public MeshParser {
 public:
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
 };
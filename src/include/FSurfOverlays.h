@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <vtkDataArray.h>
+#include <vtkSmartPointer.h>
+
+// Per-vertex overlays that sit next to a FreeSurfer surface: morphometry
+// files (curv, thickness, sulc), parcellations (.annot) and labels (.label).
+struct FSurfOverlay {
+  enum class Kind { Morph, Annot, Label };
+
+  Kind kind = Kind::Morph;
+  std::string path;
+  std::string name; // point-data array name, e.g. "thickness" or "aparc"
+};
+
+// Overlays for the hemisphere of `surfacePath` (the "lh." / "rh." prefix of its
+// file name): <hemi>.curv, <hemi>.thickness and <hemi>.sulc next to the surface,
+// and <hemi>.*.annot / <hemi>.*.label next to it or in the subject's label/
+// directory. Morphometry comes first, then annotations and labels by name.
+std::vector<FSurfOverlay> findFSurfOverlays(const std::string& surfacePath);
+
+// Read one overlay for a surface of `vertexCount` vertices. Morphometry becomes
+// a float array; an annotation becomes an int array of structure indices (-1 =
+// unlabeled) carrying an indexed vtkLookupTable with the color table's
+// colors and names; a label becomes a 0/1 int membership array. Reports to
+// std::cerr and returns null if the file is unreadable or does not match the
+// surface.
+vtkSmartPointer<vtkDataArray> readFSurfOverlay(const FSurfOverlay& overlay, size_t vertexCount);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "FileSeriesTemporalSource.h"
+#include "MeshParser.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Time series stored one VTK file per step: ParaView .pvd collections and, when
+// enabled, a numbered VTK file (result_0000.vtu, frame12.vtk) opened together
+// with at least two siblings numbered like it (same prefix and extension, same
+// digit count when zero-padded). A collection's first step is rendered, a
+// numbered file's own step; the series plays back through a
+// FileSeriesTemporalSource.
+class FileSeriesMeshParser : public MeshParser {
+public:
+  explicit FileSeriesMeshParser(bool numberedSeries = true);
+  ~FileSeriesMeshParser() override;
+
+  std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+
+  // Valid after a successful parse(); null for a single-step series.
+  std::shared_ptr<TemporalSource> temporal() const override {
+    return temporal_;
+  }
+
+private:
+  bool numberedSeries_;
+  // The numbered files canParse found, for the parse() of the same path.
+  std::string listedPath_;
+  std::vector<FileSeriesTemporalSource::Step> listed_;
+  int listedOpened_ = 0;
+  std::shared_ptr<TemporalSource> temporal_;
+};
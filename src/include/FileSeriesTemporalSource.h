@@ -0,0 +1,72 @@
+#pragma once
+
+#include "TemporalSource.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <vtkSmartPointer.h>
+
+// A time series stored as one VTK file per step: the datasets of a ParaView
+// .pvd collection, or numbered files such as result_0000.vtu, result_0001.vtu.
+// Each step is read on demand with the VTK reader for its type, restricted to
+// the active array. Steps whose points and cells are byte for byte those of
+// the first step (the usual case for a fixed mesh, in uncompressed
+// little-endian XML files) skip the geometry: the frame shares the first
+// step's points and cells, and only its point and cell data arrays are decoded,
+// straight from the mapped file. Each step's geometry is compared with the
+// first step's once; later reads only check that its layout still matches.
+class FileSeriesTemporalSource : public TemporalSource {
+public:
+  struct Step {
+    std::string path;
+    double time = 0.0;
+  };
+
+  // `fileName` names the series for sidecar files (the .pvd); may be empty.
+  // The mesh open() returns shows `initialStep`.
+  FileSeriesTemporalSource(std::vector<Step> steps, std::string fileName, int initialStep = 0);
+  ~FileSeriesTemporalSource() override;
+
+  // Read the first step in full, with every array, then the initial step if it
+  // is another one. Returns the mesh to render (a copy sharing their arrays),
+  // or null if a file cannot be read. Steps are read relative to the first, so
+  // this comes before anything else.
+  vtkSmartPointer<vtkDataSet> open();
+
+  int steps() const override {
+    return static_cast<int>(steps_->size());
+  }
+  double timeAt(int step) const override;
+  int initialStep() const override {
+    return initialStep_;
+  }
+
+  bool readStepInto(int step, vtkDataSet* target) override;
+
+  bool
+  sampledScalarRange(const ScalarField& field, double out[2], int maxSamples = 16) override;
+
+  void setActiveArray(const ScalarField& field) override;
+
+  std::string fileName() const override {
+    return fileName_;
+  }
+  // The step files, when the series is named after a collection file.
+  std::vector<std::string> inputFiles() const override;
+
+  // Readers are created per step, so a copy reads independently.
+  std::unique_ptr<TemporalSource> clone() const override;
+
+private:
+  struct First;
+
+  // Read `step` into `target`, restricted to `only` unless its name is empty.
+  bool readFrame(int step, const ScalarField& only, vtkDataSet* target) const;
+
+  std::shared_ptr<const std::vector<Step>> steps_;
+  std::string fileName_;
+  int initialStep_ = 0;
+  std::shared_ptr<const First> first_;
+  ScalarField activeArray_;
+};
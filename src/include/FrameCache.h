@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vtkDataSet.h>
+#include <vtkSmartPointer.h>
+
+// Decoded temporal frames kept under a byte budget, least recently used first
+// out, so scrubbing back over steps already seen runs from memory. Frames are
+// keyed on the step alone: the owner clears the cache when the array being
+// read changes. Not thread-safe; FramePrefetcher calls it under its lock.
+class FrameCache {
+public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t bytes = 0;
+    size_t frames = 0;
+  };
+
+  // A zero budget disables the cache.
+  explicit FrameCache(uint64_t budgetBytes = 0);
+
+  bool enabled() const {
+    return budgetBytes_ > 0;
+  }
+  uint64_t budgetBytes() const {
+    return budgetBytes_;
+  }
+
+  // The frame for `step`, marked most recently used, or null. Counts a hit or
+  // a miss.
+  vtkSmartPointer<vtkDataSet> find(int step);
+  // Whether `step` is cached, without counting or touching recency.
+  bool contains(int step) const;
+
+  // Cache `frame`, `bytes` large, evicting the least recently used frames to
+  // make room. Frames larger than the whole budget are not kept.
+  void insert(int step, vtkSmartPointer<vtkDataSet> frame, uint64_t bytes);
+  // Drop every frame; the hit and miss counts are kept.
+  void clear();
+
+  Stats stats() const;
+
+private:
+  struct Entry {
+    int step;
+    vtkSmartPointer<vtkDataSet> frame;
+    uint64_t bytes;
+  };
+
+  void erase(std::list<Entry>::iterator it);
+
+  uint64_t budgetBytes_;
+  uint64_t bytes_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  // Most recently used at the front.
+  std::list<Entry> lru_;
+  std::unordered_map<int, std::list<Entry>::iterator> index_;
+};
+
+// Parse a size such as "4G", "512M", "1.5G" or "1073741824" (binary K/M/G/T
+// suffixes, an optional trailing "B" or "iB"). False on anything else.
+bool parseByteSize(const std::string& text, uint64_t& bytes);
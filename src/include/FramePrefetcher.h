@@ -0,0 +1,132 @@
+#pragma once
+
+#include "FrameCache.h"
+#include "ScalarVizUtils.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vtkDataSet.h>
+#include <vtkSmartPointer.h>
+
+class TemporalSource;
+
+// Reads the steps ahead of the one being shown on a dedicated I/O thread, so
+// playback never waits on the disk.
+//
+// The thread owns a clone of the temporal source (its own reader) and decodes
+// the next steps, in the direction playback is moving, into fresh datasets kept
+// in a bounded ring. Showing a ready step only shallow-copies it into the
+// rendered mesh. A step that is not ready is read before anything else and
+// announced through onReady.
+//
+// The ring holds as many frames as fit in a byte budget, sized on the frames
+// read so far. Frames shown or passed over can be kept on in a FrameCache, so
+// scrubbing back over them does not touch the disk.
+//
+// Reads the owner makes through its own source (the one playback was set up
+// with) should be bracketed by a Pause, so they do not queue behind prefetch
+// reads for the same file.
+class FramePrefetcher {
+public:
+  // `source` is cloned; `prototype` is the rendered mesh, whose geometry every
+  // frame starts from. onReady(step) is called on the I/O thread once a step
+  // that take() missed has been read. cacheBytes sizes the frame cache (zero:
+  // no cache).
+  FramePrefetcher(const TemporalSource& source,
+                  vtkDataSet* prototype,
+                  std::function<void(int step)> onReady,
+                  uint64_t cacheBytes = 0,
+                  uint64_t budgetBytes = uint64_t(512) << 20);
+  ~FramePrefetcher();
+  FramePrefetcher(const FramePrefetcher&) = delete;
+  FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+
+  // False if the source cannot be cloned; the owner then reads frames itself.
+  bool valid() const {
+    return source_ != nullptr;
+  }
+
+  // Show `step`: shallow-copies the prefetched frame into `target` and returns
+  // true, or queues the step ahead of everything else and returns false.
+  // Either way prefetching continues from `step`, in the direction of travel.
+  bool take(int step, vtkDataSet* target);
+
+  // Frames read ahead of the current step, e.g. half a second at the playback
+  // rate. Capped by what fits in the byte budget.
+  void setLookahead(int frames);
+  // Whether reading ahead past the last step wraps to the first.
+  void setLoop(bool loop);
+
+  // Restrict reads to one array, as TemporalSource::setActiveArray. Frames read
+  // for the previous array are dropped.
+  void setActiveArray(const ScalarField& field);
+
+  // Frame cache counters: a hit is a step take() found in the cache, a miss one
+  // it found neither there nor in the ring.
+  FrameCache::Stats cacheStats();
+
+  // Holds the I/O thread between reads for as long as it lives. A null
+  // prefetcher is allowed and does nothing.
+  class Pause {
+  public:
+    explicit Pause(FramePrefetcher* prefetcher);
+    ~Pause();
+    Pause(const Pause&) = delete;
+    Pause& operator=(const Pause&) = delete;
+
+  private:
+    FramePrefetcher* prefetcher_;
+  };
+
+private:
+  struct Frame {
+    int step = -1;
+    vtkSmartPointer<vtkDataSet> data;
+    uint64_t bytes = 0;
+  };
+
+  void run();
+  // The steps the ring should hold, nearest first.
+  std::vector<int> windowLocked() const;
+  bool wantedLocked(int step) const;
+  bool readyLocked(int step) const;
+  int nextStepLocked() const;
+  void trimLocked();
+  vtkSmartPointer<vtkDataSet> read(int step);
+  uint64_t frameBytes(vtkDataSet* frame) const;
+
+  std::unique_ptr<TemporalSource> source_;
+  vtkSmartPointer<vtkDataSet> prototype_;
+  std::function<void(int step)> onReady_;
+  uint64_t budgetBytes_;
+  int steps_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::vector<Frame> ring_;
+  FrameCache cache_;
+  // The last frame read; arrays a new frame shares with it cost nothing extra.
+  vtkSmartPointer<vtkDataSet> previous_;
+  size_t capacity_ = 2;
+  int lookahead_ = 8;
+  int cursor_ = 0;
+  int direction_ = 1;
+  bool loop_ = true;
+  // A step take() missed; read first.
+  int urgent_ = -1;
+  // Set after a failed read; cleared when the cursor moves.
+  bool stalled_ = false;
+  // Bumped by setActiveArray so frames read for the old array are dropped.
+  uint64_t generation_ = 0;
+  int pauses_ = 0;
+  bool reading_ = false;
+  bool stop_ = false;
+  std::thread thread_;
+};
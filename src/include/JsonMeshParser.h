@@ -1,9 +1,31 @@
 #pragma once
 #include "MeshParser.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+// Reads JSON triangle meshes (a part object, an array of parts, or an object
+// with a "surface" array of parts) with a streaming SAX parser that writes
+// numbers straight into the VTK arrays. "vertices", "indices" and "normals"
+// may instead reference little-endian binary data in an external file or a
+// base64 data URI.
 class JsonMeshParser : public MeshParser {
 public:
+  JsonMeshParser();
   ~JsonMeshParser() override;
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+  std::string cacheTag() const override;
+  // The external buffer files (`uri`) the last parsed document referenced.
+  std::vector<std::string> inputFiles() const override {
+    return bufferFiles_;
+  }
+
+private:
+  // Meshes of a document canParse had to read in full to recognise, handed to
+  // the parse() of the same file so it is not parsed twice.
+  struct Document;
+  std::unique_ptr<Document> sniffed_;
+  std::vector<std::string> bufferFiles_;
 };
@@ -3,7 +3,30 @@
 
 class LSDynaMeshParser : public MeshParser {
 public:
+  // How deck text is read. Mapped memory-maps each file and parses the bulk
+  // *NODE / *ELEMENT_ sections as parallel line-aligned chunks; Streamed reads
+  // line by line with std::getline on one thread, kept as fallback and
+  // benchmark baseline. Both share the card parser and part assembly.
+  enum class ReadMode { Mapped, Streamed };
+
+  // How parts store their nodes. PerPart gives every part its own vtkPoints with
+  // just the nodes it uses; Shared makes all parts reference one float32
+  // vtkPoints holding every node of the deck, so interface nodes are stored once.
+  enum class PointStorage { PerPart, Shared };
+
+  explicit LSDynaMeshParser(ReadMode mode = ReadMode::Mapped,
+                            PointStorage points = PointStorage::PerPart);
   ~LSDynaMeshParser() override;
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+  std::string cacheTag() const override;
+  // The *INCLUDE files of the last parsed deck.
+  std::vector<std::string> inputFiles() const override {
+    return includes_;
+  }
+
+private:
+  ReadMode mode_;
+  PointStorage points_;
+  std::vector<std::string> includes_;
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QWidget>
+#include <cstdint>
+
+class QLabel;
+class QProgressBar;
+class QToolButton;
+
+// Bottom-overlay bar shown while files load in the background: what is being
+// loaded, how far along it is (bytes parsed), and a cancel button.
+//
+// Like PlaybackBar it only reports intent; the owner cancels the load.
+class LoadProgressBar : public QWidget {
+  Q_OBJECT
+public:
+  explicit LoadProgressBar(const QString& title, QWidget* parent = nullptr);
+
+  void setProgress(uint64_t done, uint64_t total);
+
+signals:
+  void cancelRequested();
+
+private:
+  QLabel* label_ = nullptr;
+  QProgressBar* bar_ = nullptr;
+  QToolButton* cancelButton_ = nullptr;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Parsers that scan large text or
+// binary files use this instead of ifstream so the OS pages data in on demand
+// and several threads can parse disjoint byte ranges of the same buffer.
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // Map `path` read-only. Returns false if the file cannot be opened or mapped.
+  // An empty file maps successfully with size() == 0 and data() == nullptr.
+  bool open(const std::string& path);
+  void close();
+
+  bool isOpen() const {
+    return open_;
+  }
+  const char* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+  const char* begin() const {
+    return data_;
+  }
+  const char* end() const {
+    return data_ + size_;
+  }
+
+private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+#ifdef _WIN32
+  void* fileHandle_ = nullptr;
+  void* mappingHandle_ = nullptr;
+#endif
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "cache_files.h"
+
+#include <string>
+#include <vector>
+#include <vtkDataSet.h>
+#include <vtkSmartPointer.h>
+
+// On-disk cache of parsed meshes, so reopening an unchanged text model (LS-DYNA
+// deck, Carto, JSON, DIF XML) skips parsing. An entry is keyed on the file's
+// canonical path, size and mtime plus the parser's cacheTag(); any extra input
+// files (includes) are recorded with their size and mtime and checked on load.
+//
+// Entries hold the parser output itself — points, cells, point/cell/field
+// arrays including vv_part_name and vv_part_color — as raw arrays at 64-byte
+// aligned offsets, so a hit maps the file and copies the arrays out without
+// decoding anything. Arrays shared between parts (shared point storage) are
+// stored once and shared again on load. Poly data and unstructured grids are
+// supported; other outputs are simply not cached.
+class MeshCache {
+public:
+  // Entries live in `directory` (created on first store). Empty disables the cache.
+  explicit MeshCache(std::string directory);
+
+  // $VV_CACHE_DIR, else the platform cache directory + "/vv/meshes"
+  // ($XDG_CACHE_HOME or ~/.cache, %LOCALAPPDATA% on Windows).
+  static std::string defaultDirectory();
+
+  bool enabled() const {
+    return !directory_.empty();
+  }
+
+  // Cached meshes for `path` as parsed by a parser with `parserTag`, or empty
+  // on a miss (no entry, stale entry, or unreadable entry).
+  std::vector<vtkSmartPointer<vtkDataSet>> load(const std::string& path,
+                                                const std::string& parserTag) const;
+
+  // Write the entry for `path`, parsed while it had `parsedStamp` (taken with
+  // stampOf() before parsing). Nothing is stored if the file has changed since,
+  // since the meshes may then hold its old contents. The file is streamed to a
+  // temporary name and renamed into place, so concurrent viewers never see a
+  // partial entry.
+  bool store(const std::string& path,
+             const FileStamp& parsedStamp,
+             const std::string& parserTag,
+             const std::vector<std::string>& inputFiles,
+             const std::vector<vtkSmartPointer<vtkDataSet>>& meshes) const;
+
+  // store() on a background thread, so a cold load hands its meshes to the
+  // viewer without waiting for the entry to be written. The files are stamped
+  // and the meshes shallow-copied before this returns; `path` is stamped again
+  // just before writing. Entries are written one at a time, in the order
+  // queued; those still queued at exit are finished first.
+  void storeInBackground(const std::string& path,
+                         const FileStamp& parsedStamp,
+                         const std::string& parserTag,
+                         const std::vector<std::string>& inputFiles,
+                         const std::vector<vtkSmartPointer<vtkDataSet>>& meshes) const;
+
+  // Block until every entry queued by storeInBackground() is written.
+  static void waitForBackgroundStores();
+
+private:
+  std::string entryPath(const std::string& key) const;
+
+  std::string directory_;
+};
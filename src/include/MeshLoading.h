@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,12 +28,51 @@ struct LoadedMeshes {
 
 struct MeshLoadResult {
   bool ok = false;
+  // The load was abandoned through MeshLoadOptions::cancel (ok is false too).
+  bool cancelled = false;
   int exitCode = 0;
   std::string error;
   LoadedMeshes meshes;
-  // Non-null and playable when a temporal VTKHDF file was loaded; meshes[0] is the
-  // rendered object playback streams successive frames into.
+  // Non-null and playable when a temporal file (VTKHDF, d3plot, VTK file
+  // series) was loaded; meshes[0] is the rendered object playback streams
+  // successive frames into.
   std::shared_ptr<TemporalSource> temporal;
 };
 
-MeshLoadResult loadMeshes(const std::vector<std::string>& meshfiles, bool explodeView);
+struct MeshLoadOptions {
+  // LS-DYNA: all parts of a deck share one point array instead of each part
+  // copying the nodes it uses. Saves memory on heavily partitioned models.
+  bool sharedPoints = false;
+  // Reuse parsed text models from the on-disk mesh cache (see MeshCache) and
+  // store newly parsed ones there. Empty cacheDirectory means the default one.
+  bool useCache = true;
+  std::string cacheDirectory;
+  // Open a numbered VTK file (result_0000.vtu) together with its numbered
+  // siblings as one time series. Only applies when a single file is loaded.
+  bool fileSeries = true;
+
+  // Hooks for a load running off the GUI thread; all of them are called from
+  // loader threads.
+  // Bytes parsed so far, out of the total size of the files being loaded.
+  std::function<void(uint64_t done, uint64_t total)> onProgress;
+  // The parts of one file, as soon as it and every file before it are loaded,
+  // so they arrive in argument order. Part indices in the group are final.
+  std::function<void(const LoadedMeshes& added)> onFileLoaded;
+  // Set to abandon the load: parsers stop at their next progress report and
+  // loadMeshes returns with cancelled set.
+  const std::atomic<bool>* cancel = nullptr;
+};
+
+// Append `added`, whose part indices follow on from the parts in `meshes`.
+void appendLoadedMeshes(LoadedMeshes& meshes, LoadedMeshes added);
+
+// Check what loadMeshes would check before parsing anything: every file exists,
+// stdin is named at most once and some parser recognizes each file. Returns the
+// error and exit code loadMeshes would fail with (meshes stay empty), or ok.
+MeshLoadResult checkMeshFiles(const std::vector<std::string>& meshfiles,
+                              bool explodeView,
+                              const MeshLoadOptions& options = {});
+
+MeshLoadResult loadMeshes(const std::vector<std::string>& meshfiles,
+                          bool explodeView,
+                          const MeshLoadOptions& options = {});
@@ -1,14 +1,98 @@
 #pragma once
+#include "ByteSource.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <vtkDataSet.h>
 #include <vtkSmartPointer.h>
 
+class TemporalSource;
+class vtkAlgorithm;
+class vtkObject;
+
+// The first bytes of a file, read once by loadMeshes and shared by every
+// parser's canParse, so format detection costs one read instead of one per
+// parser.
+struct FileHead {
+  static constexpr size_t kBytes = 4096;
+
+  std::string path;
+  std::string bytes; // up to kBytes, fewer for short files
+
+  static FileHead read(const std::string& path);
+
+  // The first n bytes (or all of them, if there are fewer).
+  std::string_view prefix(size_t n) const {
+    return std::string_view(bytes).substr(0, n);
+  }
+};
+
 class MeshParser {
 public:
+  // Receives the number of further input bytes parse() has got through and
+  // returns false once the load has been cancelled. Called from whichever thread
+  // is parsing, worker threads included.
+  using ProgressCallback = std::function<bool(uint64_t bytes)>;
+
   virtual ~MeshParser();
   // Parse the file and return a vector of vtkDataSet (empty on failure)
   virtual std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) = 0;
-  // Return true if this parser can handle the file
-  virtual bool canParse(const std::string& filename) = 0;
+  // Return true if this parser can handle the file. Decide from head.bytes
+  // where possible; a parser that has to read further may keep what it read
+  // for the parse() of the same path that follows a positive answer.
+  virtual bool canParse(const FileHead& head) = 0;
+  // Time series behind the last parse(), if the format has one (null otherwise)
+  virtual std::shared_ptr<TemporalSource> temporal() const;
+  // Identifies this parser's output in the on-disk mesh cache (MeshCache).
+  // Bump the version inside it whenever parse() output changes for the same
+  // input. Empty (the default) means results are never cached.
+  virtual std::string cacheTag() const;
+  // Other files the last parse() read (e.g. LS-DYNA *INCLUDEs); a cached result
+  // is only reused while these are unchanged too.
+  virtual std::vector<std::string> inputFiles() const;
+
+  // Progress and cancellation hook for the parse() calls that follow (none by
+  // default: parsing runs to completion).
+  void setProgressCallback(ProgressCallback callback);
+  // Report `bytes` more of the input parsed. False means the load was
+  // cancelled: parse() should stop and return an empty result.
+  bool advance(uint64_t bytes) const;
+  bool cancelled() const {
+    return !advance(0);
+  }
+
+  // How parse() reads the files it scans itself (VTK and HDF5 readers open
+  // theirs by path regardless). Mapped by default; benchmarks compare Stream.
+  void setInputBacking(ByteSource::Backing backing);
+  // Open one of parse()'s inputs with that backing.
+  bool openInput(ByteSource& source, const std::string& path) const;
+
+private:
+  ProgressCallback progress_;
+  ByteSource::Backing inputBacking_ = ByteSource::Backing::Mapped;
+};
+
+// Forwards a VTK reader's progress events to parser.advance() as a share of
+// `bytes`, and aborts the reader once the load is cancelled. Lives on the stack
+// around the reader's Update().
+class VtkProgressRelay {
+public:
+  VtkProgressRelay(const MeshParser& parser, vtkAlgorithm* algorithm, uint64_t bytes);
+  ~VtkProgressRelay();
+  VtkProgressRelay(const VtkProgressRelay&) = delete;
+  VtkProgressRelay& operator=(const VtkProgressRelay&) = delete;
+
+private:
+  void onProgress(vtkObject* caller, unsigned long event, void* callData);
+
+  const MeshParser& parser_;
+  vtkAlgorithm* algorithm_;
+  uint64_t bytes_;
+  uint64_t reported_ = 0;
+  unsigned long observer_ = 0;
 };
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <vtkActor.h>
+#include <vtkBoundingBox.h>
 #include <vtkDataSet.h>
 #include <vtkDataSetMapper.h>
 #include <vtkLookupTable.h>
@@ -38,6 +39,11 @@ public:
   void setup(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
              const std::vector<std::string>& names,
              const std::vector<std::array<double, 3>>& colorsHex);
+  // Add parts to the single-view scene built by setup() (e.g. files that finish
+  // loading later). Part indices continue after the existing ones; the caller
+  // re-applies the active scalar.
+  void addMeshes(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                 const std::vector<std::array<double, 3>>& colorsHex);
   void start();
 
   // When set, all categorical scalars use this shared LUT instead of per-scalar detection.
@@ -67,11 +73,19 @@ public:
   void setupFacetGrid(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
                       const std::vector<std::string>& names,
                       const std::vector<std::array<double, 3>>& colorsHex);
+  // Append the panels of more meshes to the grid built by setupFacetGrid()
+  // (e.g. files that finish loading later); existing panels keep their state
+  // and only move to their new grid cell.
+  void addFacetMeshes(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                      const std::vector<std::array<double, 3>>& colorsHex);
   void startFacetGrid();
 
   RendererContext context;
 
 private:
+  void addActors(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                 const std::vector<std::array<double, 3>>& colorsHex);
+
   vtkSmartPointer<vtkRenderer> renderer;
   vtkSmartPointer<vtkRenderWindowInteractor> interactor;
   std::vector<vtkSmartPointer<vtkDataSet>> sceneMeshes;
@@ -83,14 +97,26 @@ private:
   double activeScalarGlobalRange[2] = {0.0, 1.0};
   double clipRange[2] = {0.0, 1.0};
   struct FacetPanelState {
+    vtkSmartPointer<vtkRenderer> renderer;
     vtkSmartPointer<vtkDataSetMapper> mapper;
     std::string title;
+    bool hasScalar = false;
+    // The panel mesh's own analysis; `analysis` is what it is colored with
+    // (the shared categorical one under --common-cat-lut).
+    ScalarAnalysis meshAnalysis;
     ScalarAnalysis analysis;
     double globalRange[2] = {0.0, 1.0};
     double clipRange[2] = {0.0, 1.0};
     double viewport[4] = {0.0, 0.0, 1.0, 1.0};
   };
+  void appendFacetPanels(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes,
+                         const std::vector<std::array<double, 3>>& colorsHex);
+  void layoutFacetPanels();
+  void applyFacetPanelAnalysis(FacetPanelState& panel);
+
   std::vector<FacetPanelState> facetPanels;
+  size_t facetMeshCount = 0;
+  vtkBoundingBox facetBounds;
   // Keeps the facet-grid cameras synchronized (observer shared by all panels).
   vtkSmartPointer<vtkCallbackCommand> camLinkCb_;
   bool embeddedMode = false;
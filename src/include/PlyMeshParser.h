@@ -0,0 +1,15 @@
+#pragma once
+#include "MeshParser.h"
+
+// Reads Stanford PLY files (ascii, binary little- and big-endian) from a
+// memory mapping. Vertex x/y/z become float32 points and the face lists become
+// polygons (32-bit connectivity when it fits); binary files whose vertices and
+// faces have a fixed size are decoded in parallel. Normals, red/green/blue
+// colors and any other scalar property are kept as point or cell data. A file
+// without faces loads as a point cloud.
+class PlyMeshParser : public MeshParser {
+public:
+  ~PlyMeshParser() override;
+  std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+};
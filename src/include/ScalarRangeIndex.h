@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ScalarVizUtils.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <vtkDataSet.h>
+
+class TemporalSource;
+
+// Exact min/max of every point and cell array at every step of a time series,
+// so playback can fix a color range that covers transient peaks without
+// reading frames when a scalar is selected.
+//
+// build() reads each step once, with all arrays, and is meant for a
+// background thread. The index is stored in a small sidecar, `<file>.vvrange`
+// next to the data file or, where that directory is read-only, in the mesh
+// cache directory. It is reused while the size and mtime of the file, and of
+// the input files it reads its steps from (a .pvd's datasets), are unchanged.
+class ScalarRangeIndex {
+public:
+  bool empty() const {
+    return series_.empty();
+  }
+  int steps() const {
+    return steps_;
+  }
+
+  // Read every step of `source` (set to read all arrays) into copies of
+  // `prototype`. Returns false if a step cannot be read or `cancel` is set.
+  bool build(TemporalSource& source, vtkDataSet* prototype, const std::atomic<bool>* cancel);
+
+  // Load the index stored for `path` and its `inputFiles`; false if there is
+  // none or it is stale.
+  bool load(const std::string& path, const std::vector<std::string>& inputFiles = {});
+  // Store the index for `path`, recording the stamps of its `inputFiles`.
+  // Reports to std::cerr and returns false if it cannot be written anywhere.
+  bool save(const std::string& path, const std::vector<std::string>& inputFiles = {}) const;
+
+  // Range of the array over every step holding it.
+  bool range(const std::string& name, FieldAssociation association, double out[2]) const;
+  // Range of the array at one step.
+  bool stepRange(const std::string& name,
+                 FieldAssociation association,
+                 int step,
+                 double out[2]) const;
+
+private:
+  struct Series {
+    std::string name;
+    FieldAssociation association = FieldAssociation::Point;
+    // min, max per step; NaN where the step lacks the array.
+    std::vector<double> bounds;
+  };
+
+  const Series* find(const std::string& name, FieldAssociation association) const;
+  Series& series(const std::string& name, FieldAssociation association);
+
+  int steps_ = 0;
+  std::vector<Series> series_;
+};
@@ -25,6 +25,12 @@ struct ScalarField {
 struct ScalarAnalysis {
   bool categorical = false;
   std::set<double> uniqueValues; // populated iff categorical == true
+  // Categories the array brings itself (an indexed, annotated LUT attached to it,
+  // e.g. a FreeSurfer parcellation); used instead of a generated tab10/tab20 LUT.
+  vtkSmartPointer<vtkLookupTable> lookupTable;
+  // 8-bit RGB/RGBA array (PLY vertex colors, STL facet colors): drawn as the
+  // colors it holds, with no lookup table or colorbar.
+  bool directColors = false;
 };
 
 // Fetch a named array from the point- or cell-data container of a dataset.
@@ -33,15 +39,21 @@ vtkDataArray*
 arrayForAssociation(vtkDataSet* mesh, const std::string& name, FieldAssociation association);
 
 // Inspect scalar field across all meshes: detect categorical (2–20 unique integer-domain values)
-// vs continuous. Integer-typed VTK arrays are always treated as categorical candidates.
+// vs continuous. Integer-typed VTK arrays are always treated as categorical candidates; integer
+// arrays carrying their own indexed lookup table are categorical whatever their value count.
+// Unsigned char arrays with 3 or 4 components are flagged as direct colors instead.
 ScalarAnalysis analyzeScalar(const std::vector<vtkDataSet*>& meshes,
                              const std::string& scalarName,
                              FieldAssociation association);
 
-// Build a shared categorical analysis from the union of unique values across ALL categorical
-// scalar fields (point and cell) in the given meshes. Non-categorical scalars are skipped.
+// Add the unique values of ALL categorical scalar fields (point and cell) in the given meshes to
+// `unionValues`. Non-categorical scalars are skipped. Meshes loaded a few at a time are added as
+// they arrive, each batch scanned once.
+void addCommonCatValues(const std::vector<vtkDataSet*>& meshes, std::set<double>& unionValues);
+
+// Build a shared categorical analysis from the union collected by addCommonCatValues.
 // Used with --common-cat-lut to assign consistent value→color mapping across scalars.
-ScalarAnalysis buildCommonCatAnalysis(const std::vector<vtkDataSet*>& meshes);
+ScalarAnalysis commonCatAnalysis(const std::set<double>& unionValues);
 
 bool computeScalarGlobalRange(const std::vector<vtkDataSet*>& meshes,
                               const std::string& scalarName,
@@ -54,7 +66,7 @@ vtkSmartPointer<vtkLookupTable> createDefaultLookupTable(const double range[2]);
 // Categorical LUT using tab10 (n≤10) or tab20 (n≤20). Uses indexed lookup.
 vtkSmartPointer<vtkLookupTable> createCategoricalLookupTable(const std::set<double>& uniqueValues);
 
-// Build LUT from a pre-computed ScalarAnalysis.
+// Build LUT from a pre-computed ScalarAnalysis (a copy of the array's own LUT if it has one).
 vtkSmartPointer<vtkLookupTable> buildLookupTable(const ScalarAnalysis& analysis,
                                                  const double range[2]);
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// stdin ("-") made readable by path, for parsers that map or reopen their input
+// like any other file.
+//
+// On Linux, stdin that already is a regular file (`vv - < mesh.vtk`) is used in
+// place, and a pipe is spliced into an anonymous in-memory file (memfd), so a
+// multi-GB pipe costs neither disk space nor a second write; parsers map it
+// through /proc/self/fd. Elsewhere stdin is copied to a temp file, removed again
+// when the StdinFile goes away.
+class StdinFile {
+public:
+  StdinFile() = default;
+  ~StdinFile();
+  StdinFile(const StdinFile&) = delete;
+  StdinFile& operator=(const StdinFile&) = delete;
+
+  // Drain stdin. onRead(bytes) is told about every block as it arrives and may
+  // return false to stop reading. Returns false if stdin could not be stored
+  // or reading was stopped.
+  bool open(const std::function<bool(uint64_t bytes)>& onRead = {});
+
+  // The path parsers open; valid while this object lives.
+  const std::string& path() const {
+    return path_;
+  }
+  uint64_t size() const {
+    return size_;
+  }
+
+private:
+  void close();
+
+  std::string path_;
+  uint64_t size_ = 0;
+  int fd_ = -1;
+  bool removeOnClose_ = false;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include "MeshParser.h"
+
+// Reads binary and ascii STL files from a memory mapping. STL stores every
+// triangle with its own three corners; corners with identical coordinates are
+// welded into shared float32 points (hashed in parallel) so the surface is
+// connected. Binary facet colors (VisCAM/SolidView or Materialise attribute
+// bits) are kept as an "RGB" cell array.
+class StlMeshParser : public MeshParser {
+public:
+  ~StlMeshParser() override;
+  std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+};
@@ -1,49 +1,53 @@
 #pragma once
 
+#include "ScalarVizUtils.h"
+
+#include <memory>
 #include <string>
 #include <vector>
 #include <vtkDataSet.h>
-#include <vtkSmartPointer.h>
-
-class vtkHDFReader;
 
-// Wraps a live vtkHDFReader for a temporal (time-series) VTKHDF file. Frames are
-// streamed on demand — only the current step is held in memory — because result
-// files routinely span thousands of steps and gigabytes on disk.
+// A time series behind a loaded mesh. Frames are streamed on demand — only the
+// current step is held in memory — because result files routinely span
+// thousands of steps and gigabytes on disk. Implemented per file format
+// (VTKHDFTemporalSource, D3plotTemporalSource).
 class TemporalSource {
 public:
-  TemporalSource();
-  ~TemporalSource();
+  virtual ~TemporalSource();
 
   // Number of time steps; >1 means the file is playable.
-  int steps() const {
-    return numSteps_;
-  }
+  virtual int steps() const = 0;
   bool playable() const {
-    return numSteps_ > 1;
+    return steps() > 1;
   }
-  double timeAt(int step) const;
-
-  // Read the given step and shallow-copy its dataset into `target` (the rendered
-  // object the mappers point at). Returns false on out-of-range or read failure.
-  bool readStepInto(int step, vtkDataSet* target);
-
-  // Union of a point-data array's range across up to maxSamples evenly spaced
-  // steps. Used to fix a stable color range for the whole animation.
-  bool sampledScalarRange(const std::string& scalarName, double out[2], int maxSamples = 16);
-
-  // Restrict per-frame reads to a single point-data array. Static geometry is
-  // cached (UseCache) and the other arrays are skipped, so streaming a frame only
-  // touches the array actually being colored — the dominant playback speed-up.
-  void setActiveArray(const std::string& scalarName);
-
-  // Called by the parser once the reader is constructed and information is read.
-  void init(const vtkSmartPointer<vtkHDFReader>& reader, std::vector<double> timeValues);
-
-private:
-  bool updateToStep(int step);
-
-  vtkSmartPointer<vtkHDFReader> reader_;
-  std::vector<double> timeValues_;
-  int numSteps_ = 0;
+  virtual double timeAt(int step) const = 0;
+  // The step the loaded mesh shows, where playback starts: 0 unless the file
+  // opened was a later step of its series.
+  virtual int initialStep() const;
+
+  // Read the given step into `target` (the rendered object the mappers point
+  // at). Returns false on out-of-range or read failure.
+  virtual bool readStepInto(int step, vtkDataSet* target) = 0;
+
+  // Union of a point- or cell-data array's range across up to maxSamples evenly
+  // spaced steps. Used to fix a stable color range for the whole animation.
+  virtual bool
+  sampledScalarRange(const ScalarField& field, double out[2], int maxSamples = 16) = 0;
+
+  // Restrict per-frame reads to a single point- or cell-data array, so streaming
+  // a frame only touches the array actually being colored: the other point, cell
+  // and field arrays are skipped. An empty name reads every array again.
+  virtual void setActiveArray(const ScalarField& field) = 0;
+
+  // The file the steps are read from, which sidecar files (ScalarRangeIndex)
+  // are named after; empty if there is no single such file.
+  virtual std::string fileName() const;
+  // Other files the steps are read from (a .pvd's datasets), whose stamps
+  // decide with fileName()'s whether a sidecar is current.
+  virtual std::vector<std::string> inputFiles() const;
+
+  // An independent source over the same data, with its own reader and the same
+  // active array, so frames can be read on another thread (FramePrefetcher).
+  // Null if the format cannot open a second reader.
+  virtual std::unique_ptr<TemporalSource> clone() const = 0;
 };
@@ -4,8 +4,6 @@
 
 #include <memory>
 
-class TemporalSource;
-
 // Parses VTKHDF files (.vtkhdf — HDF5-backed VTK). Loads the first time step for
 // rendering; if the file is temporal, exposes a TemporalSource for playback.
 class VTKHDFMeshParser : public MeshParser {
@@ -14,10 +12,10 @@ public:
   ~VTKHDFMeshParser() override;
 
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
 
   // Valid after a successful parse(); null if the file is not temporal.
-  std::shared_ptr<TemporalSource> temporal() const {
+  std::shared_ptr<TemporalSource> temporal() const override {
     return temporal_;
   }
 
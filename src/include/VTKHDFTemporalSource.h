@@ -0,0 +1,50 @@
+#pragma once
+
+#include "TemporalSource.h"
+
+#include <string>
+#include <vector>
+#include <vtkSmartPointer.h>
+
+class vtkHDFReader;
+
+// Wraps a live vtkHDFReader for a temporal (time-series) VTKHDF file. Unless
+// HDF5 is built threadsafe, the reads of every instance (clones on other
+// threads included) take turns (see lockHDF5).
+class VTKHDFTemporalSource : public TemporalSource {
+public:
+  VTKHDFTemporalSource();
+  ~VTKHDFTemporalSource() override;
+
+  int steps() const override {
+    return numSteps_;
+  }
+  double timeAt(int step) const override;
+
+  // Shallow-copies the step's dataset into `target`. While an array is active
+  // the target keeps its own field data, which such reads skip.
+  bool readStepInto(int step, vtkDataSet* target) override;
+
+  bool
+  sampledScalarRange(const ScalarField& field, double out[2], int maxSamples = 16) override;
+
+  // Static geometry is cached (UseCache) and the other point, cell and field
+  // arrays are skipped — the dominant playback speed-up. The skipped point and
+  // cell arrays are absent from frames read while the array is active.
+  void setActiveArray(const ScalarField& field) override;
+
+  // Opens a second vtkHDFReader on the file.
+  std::unique_ptr<TemporalSource> clone() const override;
+  std::string fileName() const override;
+
+  // Called by the parser once the reader is constructed and information is read.
+  void init(const vtkSmartPointer<vtkHDFReader>& reader, std::vector<double> timeValues);
+
+private:
+  bool updateToStep(int step);
+
+  vtkSmartPointer<vtkHDFReader> reader_;
+  std::vector<double> timeValues_;
+  ScalarField activeArray_;
+  int numSteps_ = 0;
+};
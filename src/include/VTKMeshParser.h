@@ -1,9 +1,12 @@
 #pragma once
 #include "MeshParser.h"
 
+// Legacy .vtk files and the VTK XML family, dispatched on the <VTKFile> type:
+// serial datasets, partitioned summaries (pieces read in parallel and appended)
+// and multiblock files (one mesh per block).
 class VTKMeshParser : public MeshParser {
 public:
   ~VTKMeshParser() override;
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
 };
@@ -7,13 +7,21 @@
 #include <QMainWindow>
 #include <QPointer>
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class ColorBarWidget;
+class FramePrefetcher;
+class LoadProgressBar;
 class PlaybackBar;
+class ScalarRangeIndex;
 class QTimer;
 class QTreeWidget;
 class QVTKOpenGLNativeWidget;
@@ -22,38 +30,65 @@ class TemporalSource;
 struct ViewerOptions {
   bool explodeView = false;
   bool commonCatLut = false;
+  // Byte budget of the temporal frame cache (FrameCache); 0 disables it.
+  uint64_t frameCacheBytes = 0;
 };
 
 // Main application window: owns the VTK viewport, the overlay widgets
 // (colorbar, parts tree, playback bar) and all viewer state previously held as
 // lambda captures in main().
+//
+// The window opens at once and loads its files on a worker thread: each file's
+// parts are added to the view as soon as it is parsed, a progress bar shows the
+// bytes parsed so far and can cancel the load. A failed load quits the
+// application with loadMeshes' exit code.
 class ViewerWindow : public QMainWindow {
   Q_OBJECT
 public:
-  ViewerWindow(MeshLoadResult loadResult, const ViewerOptions& options, QWidget* parent = nullptr);
+  ViewerWindow(std::vector<std::string> meshfiles,
+               MeshLoadOptions loadOptions,
+               const ViewerOptions& options,
+               QWidget* parent = nullptr);
+  ~ViewerWindow() override;
+
+protected:
+  void closeEvent(QCloseEvent* event) override;
 
 private:
   // ── setup ─────────────────────────────────────────────────────────
   void buildViewport();
-  void setupFacetMode();
+  void setupFacetMode(size_t firstPart);
+  void refreshFacetCategories();
   void setupNormalMode();
-  void buildPartsTree();
+  void connectPartsTree();
+  void addPartsTreeGroups(size_t firstGroup);
   void setupPlayback();
+  void startRangeIndex();
+  void onRangeIndexReady(std::shared_ptr<const ScalarRangeIndex> index);
+
+  // ── background loading ────────────────────────────────────────────
+  void startLoading(std::vector<std::string> meshfiles, MeshLoadOptions loadOptions);
+  void addLoadedMeshes(LoadedMeshes added);
+  void finishLoading(MeshLoadResult result);
+  void cancelLoading();
 
   // ── scalar handling ───────────────────────────────────────────────
   void applyScalarAtIndex(int index);
   void applyNoScalar();
   void cycleScalar();
+  bool temporalScalarRange(const ScalarField& field, double out[2]);
 
   // ── layout / playback ─────────────────────────────────────────────
   void layoutFacetColorBars();
   void onViewportResize();
   void showFrame(int step);
   void applyPlayTimerInterval();
+  void onFramePrefetched(int step);
 
   // ── state ─────────────────────────────────────────────────────────
   MeshLoadResult load_;
   ViewerOptions options_;
+  bool sceneStarted_ = false;
   std::vector<std::array<double, 3>> partColors_;
 
   MeshRenderer renderer_;
@@ -61,16 +96,37 @@ private:
   ColorBarWidget* colorBar_ = nullptr;
   QTreeWidget* partsTree_ = nullptr;
   std::vector<ColorBarWidget*> facetColorBars_;
+  // --common-cat-lut: categorical values of every part loaded so far.
+  std::set<double> commonCatValues_;
 
   std::vector<ScalarField> scalarFields_;
   int activeScalarIdx_ = -1;
 
   // Temporal (playable) support: when a time-series file is loaded, the color
-  // range is fixed across the whole animation (sampled once per scalar) so the
-  // colormap stays stable while frames advance.
+  // range is fixed across the whole animation so the colormap stays stable
+  // while frames advance. It comes from the exact per-step range index, loaded
+  // from its sidecar or built on rangeScan_; without one it is sampled once per
+  // scalar. Frames are read ahead on the prefetcher's I/O thread; a step asked
+  // for before it is ready is remembered in pendingStep_ and shown when it
+  // arrives.
   std::shared_ptr<TemporalSource> temporal_;
-  std::map<std::string, std::array<double, 2>> temporalRangeCache_;
+  std::unique_ptr<FramePrefetcher> prefetcher_;
+  std::shared_ptr<const ScalarRangeIndex> rangeIndex_;
+  std::thread rangeScan_;
+  std::atomic<bool> cancelRangeScan_{false};
+  bool rangeIndexPending_ = false;
+  std::map<std::pair<FieldAssociation, std::string>, std::array<double, 2>> temporalRangeCache_;
   QPointer<PlaybackBar> playbackBar_;
   QTimer* playTimer_ = nullptr;
   int currentPlaybackStep_ = 0;
+  int pendingStep_ = -1;
+
+  // Background load: progress is published by loader threads and polled by
+  // progressTimer_, parts and the final result arrive as queued calls.
+  std::thread loader_;
+  std::atomic<bool> cancelLoad_{false};
+  std::atomic<uint64_t> loadedBytes_{0};
+  std::atomic<uint64_t> totalBytes_{0};
+  QPointer<LoadProgressBar> progressBar_;
+  QTimer* progressTimer_ = nullptr;
 };
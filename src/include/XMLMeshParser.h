@@ -5,5 +5,6 @@ class XMLMeshParser : public MeshParser {
 public:
   ~XMLMeshParser() override;
   std::vector<vtkSmartPointer<vtkDataSet>> parse(const std::string& filename) override;
-  bool canParse(const std::string& filename) override;
+  bool canParse(const FileHead& head) override;
+  std::string cacheTag() const override;
 };
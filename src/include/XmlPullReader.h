@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal pull parser over an XML document held in memory (usually a
+// MappedFile). It reports start and end tags one at a time and never builds a
+// tree or copies character data: an element's text is the byte range between
+// its start and end tags, which callers parse in place. Comments, processing
+// instructions, DOCTYPE declarations and CDATA sections are skipped. Entity
+// references are decoded in attribute values only.
+class XmlPullReader {
+public:
+  enum class Event { StartElement, EndElement, EndDocument, Error };
+
+  XmlPullReader(const char* begin, const char* end);
+
+  // Advance to the next tag. A self-closing element yields StartElement then
+  // EndElement. Mismatched or unterminated tags yield Error.
+  Event next();
+
+  // Name of the current element (start or end tag).
+  std::string_view name() const {
+    return name_;
+  }
+  // Nesting depth of the current element (start or end tag); the root is 1.
+  size_t depth() const {
+    return depth_;
+  }
+  // For a start tag: first byte after it, where the element's content begins.
+  const char* contentBegin() const {
+    return tagEnd_;
+  }
+  // For an end tag: its '<', where the element's content ends.
+  const char* tagBegin() const {
+    return tagBegin_;
+  }
+
+  // Decoded value of attribute `attribute` of the current start tag.
+  bool attribute(std::string_view attribute, std::string& value) const;
+
+  // Skip the rest of the current element (after its StartElement), leaving the
+  // reader on its EndElement. Returns false on malformed input.
+  bool skipElement();
+
+private:
+  const char* p_;
+  const char* end_;
+  const char* tagBegin_ = nullptr;
+  const char* tagEnd_ = nullptr;
+  std::string_view name_;
+  std::string_view attributes_;
+  std::vector<std::string_view> stack_;
+  size_t depth_ = 0;
+  bool pendingEnd_ = false; // self-closing tag: EndElement comes next
+};
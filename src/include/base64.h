@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Base64 decoding for the parsers that read it inline: JSON data URIs and VTK
+// XML binary arrays. Whitespace between characters is skipped.
+
+// Decode all of `text` into `out`, replacing its contents. The last quartet
+// may leave out its padding.
+bool decodeBase64(std::string_view text, std::string& out);
+
+// Decode from `p` until `out` holds `size` bytes, leaving `p` after the last
+// quartet used. VTK encodes a block's byte count and its data as separately
+// padded runs, so padding ends a quartet rather than the text.
+bool decodeBase64(const char*& p, const char* end, size_t size, std::string& out);
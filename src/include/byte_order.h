@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Helpers for big-endian binary formats (FreeSurfer). vv only targets
+// little-endian hosts, so reading big-endian data is always a byte swap.
+
+inline uint32_t byteSwap32(uint32_t value) {
+#if defined(_MSC_VER)
+  return _byteswap_ulong(value);
+#elif defined(__clang__) || defined(__GNUC__)
+  return __builtin_bswap32(value);
+#else
+  return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
+         ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+#endif
+}
+
+// Big-endian 32-bit word at `p` (no alignment required).
+inline uint32_t loadBigEndian32(const char* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return byteSwap32(value);
+}
+
+// Byte-swap `count` 32-bit words from `src` into `dst`. Neither pointer needs
+// to be aligned; `dst` may equal `src`. Runs 16 bytes at a time with SSSE3,
+// SSE2 or NEON shuffles where the target has them.
+void byteSwap32Block(const char* src, void* dst, size_t count);
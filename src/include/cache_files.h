@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// File helpers shared by the on-disk caches: MeshCache entries and
+// ScalarRangeIndex sidecars.
+
+// What a cached file is checked against: its size and mtime. `exists` is false
+// if either cannot be read.
+struct FileStamp {
+  bool exists = false;
+  uint64_t size = 0;
+  int64_t mtime = 0;
+
+  bool operator==(const FileStamp& other) const {
+    return exists == other.exists && size == other.size && mtime == other.mtime;
+  }
+};
+
+FileStamp stampOf(const std::string& path);
+
+// `path` made absolute with symlinks resolved where it exists; `path` itself
+// if that fails.
+std::string canonicalPath(const std::string& path);
+
+// 16 hex digits of the 64-bit FNV-1a hash of `key`, for naming the file that
+// holds it.
+std::string hashedFileName(const std::string& key);
+
+// Create `path` through `write`, which fills the stream and returns false to
+// abandon it. The file is written under a temporary name (its directory created
+// first) and renamed into place, so a concurrent reader never sees a partial
+// one. False, with no file left behind, if anything fails.
+bool writeFileAtomically(const std::string& path, const std::function<bool(std::ostream&)>& write);
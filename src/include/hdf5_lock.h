@@ -0,0 +1,11 @@
+#pragma once
+
+#include <mutex>
+
+// HDF5 is not thread-safe unless built with its threadsafe option, so every
+// vtkHDFReader call that reaches it (CanReadFile, UpdateInformation, Update,
+// and the destructor, which closes the file) holds this lock: one process-wide
+// mutex, whichever file and thread it is for. When the HDF5 VTK links against
+// reports itself threadsafe (H5is_library_threadsafe), the lock is empty and
+// .vtkhdf files are read in parallel.
+std::unique_lock<std::mutex> lockHDF5();
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vtkCellType.h>
+
+// LS-DYNA stores every solid with 8 node ids; tets, pyramids and pentahedra
+// repeat nodes (1 2 3 4 4 4 4 4, 1 2 3 4 5 5 5 5, 1 2 3 4 5 5 6 6). Picks the
+// matching VTK cell, writes its node ids in VTK order to `out`, sets `count`
+// and returns the cell type. Missing trailing ids (0) repeat the last one given;
+// returns VTK_EMPTY_CELL if one of the first four is missing. Shared by the
+// keyword deck and the d3plot readers; `Id` is whatever id type they store.
+template <typename Id> int lsdynaSolidCell(Id n[8], Id out[8], int& count) {
+  count = 0;
+  if (!(n[0] && n[1] && n[2] && n[3]))
+    return VTK_EMPTY_CELL;
+  for (int i = 4; i < 8; ++i) {
+    if (n[i] == 0)
+      n[i] = n[i - 1];
+  }
+
+  int type = VTK_HEXAHEDRON;
+  if (n[4] == n[3] && n[5] == n[3] && n[6] == n[3] && n[7] == n[3]) {
+    type = VTK_TETRA;
+    count = 4;
+    for (int i = 0; i < 4; ++i)
+      out[i] = n[i];
+  } else if (n[5] == n[4] && n[6] == n[4] && n[7] == n[4]) {
+    type = VTK_PYRAMID;
+    count = 5;
+    for (int i = 0; i < 5; ++i)
+      out[i] = n[i];
+  } else if (n[4] == n[5] && n[6] == n[7]) {
+    // Triangles (1 2 5) and (4 3 7) of the collapsed hex.
+    type = VTK_WEDGE;
+    count = 6;
+    const Id wedge[6] = {n[0], n[1], n[4], n[3], n[2], n[6]};
+    for (int i = 0; i < 6; ++i)
+      out[i] = wedge[i];
+  } else if (n[2] == n[3] && n[6] == n[7]) {
+    // Triangles (1 2 3) and (5 6 7); VTK wants the first one facing outward.
+    type = VTK_WEDGE;
+    count = 6;
+    const Id wedge[6] = {n[0], n[2], n[1], n[4], n[6], n[5]};
+    for (int i = 0; i < 6; ++i)
+      out[i] = wedge[i];
+  } else {
+    count = 8;
+    for (int i = 0; i < 8; ++i)
+      out[i] = n[i];
+  }
+  return type;
+}
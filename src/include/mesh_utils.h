@@ -10,6 +10,3 @@ std::array<double, 3> generateDistinctColor(int i);
 std::string readHeader(FILE* f, size_t nbytes = 200);
 // Read up to nbytes from filename
 std::string readHeader(const std::string& filename, size_t nbytes = 200);
-
-// Write all of stdin to a newly created temp file, return temp file path or empty on error
-std::string stdinToTempFile();
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Number of worker threads parallel loops may use: the hardware concurrency,
+// capped by setWorkerThreadLimit(). Always at least 1.
+unsigned workerThreadCount();
+
+// Cap the worker threads used by parallelFor (0 = no cap). Used by benchmarks to
+// measure scaling; the viewer runs uncapped.
+void setWorkerThreadLimit(unsigned limit);
+
+namespace parallel_detail {
+// True while the calling thread is executing a parallelFor body. Nested loops run
+// inline instead of spawning threads-of-threads.
+bool& insideParallelRegion();
+
+// Worker threads the parallelTasks task running on this thread may use for its
+// own loops (0 = no task running). Applied by workerThreadCount().
+unsigned& taskThreadShare();
+
+// Claim indices from next until count and run fn on each. The first exception
+// is kept in error and stops further claims.
+template <typename Fn>
+void drainIndices(size_t count,
+                  std::atomic<size_t>& next,
+                  Fn& fn,
+                  std::exception_ptr& error,
+                  std::mutex& errorMutex) {
+  for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+    try {
+      fn(i);
+    } catch (...) {
+      const std::lock_guard<std::mutex> lock(errorMutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next.store(count);
+    }
+  }
+}
+
+// Run worker on `threads` threads, the calling one included, and join them.
+template <typename Worker> void runOnThreads(size_t threads, Worker& worker) {
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (size_t t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : pool) {
+    thread.join();
+  }
+}
+} // namespace parallel_detail
+
+// Run fn(i) for every i in [0, count), distributing indices over worker threads.
+// Blocks until all iterations finish; the first exception thrown by any
+// iteration is rethrown on the calling thread.
+template <typename Fn> void parallelFor(size_t count, Fn&& fn) {
+  if (count == 0) {
+    return;
+  }
+  size_t threads = workerThreadCount();
+  if (threads > count) {
+    threads = count;
+  }
+  if (threads <= 1 || parallel_detail::insideParallelRegion()) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    parallel_detail::insideParallelRegion() = true;
+    parallel_detail::drainIndices(count, next, fn, error, errorMutex);
+    parallel_detail::insideParallelRegion() = false;
+  };
+  parallel_detail::runOnThreads(threads, worker);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Run fn(i) for every i in [0, count) as coarse, independent tasks (one file
+// each, say), up to workerThreadCount() at a time. Unlike a parallelFor body, a
+// task may run parallel loops of its own: the worker threads are split evenly
+// between the concurrent tasks. Blocks and rethrows like parallelFor.
+template <typename Fn> void parallelTasks(size_t count, Fn&& fn) {
+  if (count == 0) {
+    return;
+  }
+  const size_t workers = workerThreadCount();
+  const size_t threads = workers < count ? workers : count;
+  if (threads <= 1 || parallel_detail::insideParallelRegion()) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  const auto share = static_cast<unsigned>(workers / threads);
+  std::atomic<size_t> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    unsigned& taskShare = parallel_detail::taskThreadShare();
+    const unsigned outerShare = taskShare;
+    taskShare = share;
+    parallel_detail::drainIndices(count, next, fn, error, errorMutex);
+    taskShare = outerShare;
+  };
+  parallel_detail::runOnThreads(threads, worker);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
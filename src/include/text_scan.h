@@ -0,0 +1,114 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Allocation-free scanning of text formats held in memory (usually a
+// MappedFile): a line reader, splitting of a section into line-aligned chunks
+// for parallelFor, and number parsing straight from the buffer.
+
+// Lines of an in-memory buffer, without the trailing "\n" / "\r\n".
+class LineReader {
+public:
+  LineReader(const char* begin, const char* end) : p_(begin), end_(end) {
+  }
+
+  bool next(std::string_view& line) {
+    if (p_ >= end_)
+      return false;
+    const auto* nl =
+        static_cast<const char*>(std::memchr(p_, '\n', static_cast<size_t>(end_ - p_)));
+    const char* lineEnd = nl ? nl : end_;
+    line = std::string_view(p_, static_cast<size_t>(lineEnd - p_));
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+    p_ = nl ? nl + 1 : end_;
+    return true;
+  }
+
+  const char* position() const {
+    return p_;
+  }
+  void seek(const char* p) {
+    p_ = p;
+  }
+
+private:
+  const char* p_;
+  const char* end_;
+};
+
+using ChunkStartFn = bool (*)(std::string_view);
+
+inline bool acceptAnyLine(std::string_view) {
+  return true;
+}
+
+// Split [begin, end) into at most `parts` byte ranges. Every range starts at
+// the beginning of a line accepted by `isChunkStart`, so each range can be
+// parsed independently of the others.
+std::vector<std::pair<const char*, const char*>> splitSection(const char* begin,
+                                                              const char* end,
+                                                              size_t parts,
+                                                              ChunkStartFn isChunkStart);
+
+// How many chunks to split [begin, end) into: up to four per worker thread, but
+// none smaller than 1 MB (thread start-up costs more than it saves below that).
+size_t chunkCountFor(const char* begin, const char* end);
+
+// Number scanning: each function skips leading whitespace at `p` (newlines
+// included, so multi-line character data reads as one list), parses one number,
+// and on success advances `p` past it. Integers and, where the standard library
+// provides it, floating point go through std::from_chars (locale-independent,
+// no allocation); otherwise floating point falls back to strtod on a stack copy
+// of the token.
+
+inline const char* skipBlanks(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    ++p;
+  return p;
+}
+
+template <typename T> bool scanInt(const char*& p, const char* end, T& out) {
+  const char* start = skipBlanks(p, end);
+  if (start < end && *start == '+')
+    ++start;
+  const auto [next, ec] = std::from_chars(start, end, out);
+  if (ec != std::errc())
+    return false;
+  p = next;
+  return true;
+}
+
+template <typename T> bool scanReal(const char*& p, const char* end, T& out) {
+  const char* start = skipBlanks(p, end);
+  if (start < end && *start == '+')
+    ++start;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const auto [next, ec] = std::from_chars(start, end, out);
+  if (ec != std::errc())
+    return false;
+  p = next;
+  return true;
+#else
+  char buf[64];
+  size_t n = 0;
+  while (start + n < end && n < sizeof(buf) - 1 && start[n] != ' ' && start[n] != '\t' &&
+         start[n] != '\r' && start[n] != '\n' && start[n] != ',')
+    ++n;
+  std::memcpy(buf, start, n);
+  buf[n] = '\0';
+  char* endp = nullptr;
+  const double value = std::strtod(buf, &endp);
+  if (endp == buf)
+    return false;
+  out = static_cast<T>(value);
+  p = start + (endp - buf);
+  return true;
+#endif
+}
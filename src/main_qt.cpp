@@ -1,3 +1,4 @@
+#include "FrameCache.h"
 #include "MeshLoading.h"
 #include "ViewerWindow.h"
 #include "version.h"
@@ -40,6 +41,11 @@ struct Args {
   std::vector<std::string> meshfiles;
   bool explode_view = false;
   bool common_cat_lut = false;
+  bool shared_points = false;
+  bool no_cache = false;
+  bool no_series = false;
+  std::string frame_cache;
+  uint64_t frame_cache_bytes = 0;
   bool version = false;
   bool help = false;
   std::string thumbnail_output; // non-empty → offscreen render to PNG and exit
@@ -55,6 +61,19 @@ Args parseArgs(int argc, char* argv[], bool requireFiles = true) {
       "C,common-cat-lut",
       "Share one categorical colormap across all categorical scalars for cross-scalar comparison",
       cxxopts::value<bool>(args.common_cat_lut))(
+      "shared-points",
+      "LS-DYNA: all parts reference one shared point array (less memory for many-part decks)",
+      cxxopts::value<bool>(args.shared_points))(
+      "no-cache",
+      "Always parse text models instead of reusing the mesh cache",
+      cxxopts::value<bool>(args.no_cache))(
+      "no-series",
+      "Open a numbered VTK file (result_0000.vtu) alone, not as a time series of its siblings",
+      cxxopts::value<bool>(args.no_series))(
+      "frame-cache",
+      "Keep up to SIZE of decoded time steps in memory for scrubbing (e.g. 4G)",
+      cxxopts::value<std::string>(args.frame_cache),
+      "SIZE")(
       "v,version", "Show version and exit", cxxopts::value<bool>(args.version))(
       "h,help", "Show help and exit", cxxopts::value<bool>(args.help))(
       "T,thumbnail",
@@ -81,6 +100,10 @@ Args parseArgs(int argc, char* argv[], bool requireFiles = true) {
     std::cout << "vv version " << VV_VERSION << " (built " << VV_BUILD_DATE << ")\n";
     std::exit(0);
   }
+  if (!args.frame_cache.empty() && !parseByteSize(args.frame_cache, args.frame_cache_bytes)) {
+    std::cerr << "vv: invalid --frame-cache size: " << args.frame_cache << '\n';
+    std::exit(1);
+  }
   if (args.meshfiles.empty() && requireFiles && args.thumbnail_output.empty()) {
     std::cerr << "Usage: vv <meshfile> [<meshfile2> ...]\n" << options.help() << '\n';
     std::exit(1);
@@ -90,7 +113,11 @@ Args parseArgs(int argc, char* argv[], bool requireFiles = true) {
 
 // Offscreen render of meshFile → PNG at outPath. Used by the macOS QLGenerator.
 int renderThumbnail(const std::string& meshFile, const std::string& outPath) {
-  MeshLoadResult result = loadMeshes({meshFile}, false);
+  // A preview neither writes a cache entry nor expands into a series.
+  MeshLoadOptions loadOptions;
+  loadOptions.useCache = false;
+  loadOptions.fileSeries = false;
+  MeshLoadResult result = loadMeshes({meshFile}, false, loadOptions);
   if (!result.ok || result.meshes.meshes.empty()) {
     std::cerr << "vv --thumbnail: failed to load " << meshFile << "\n";
     return 1;
@@ -221,7 +248,8 @@ int main(int argc, char* argv[]) try {
         nullptr,
         "Open mesh file",
         QString(),
-        "Mesh files (*.vtk *.vtp *.vtu *.vtkhdf *.ply *.k *.key *.json);;All files (*)");
+        "Mesh files (*.vtk *.vtp *.vtu *.vts *.vtr *.vti *.vtm *.pvd *.pvtp *.pvtu *.vtkhdf "
+        "*.ply *.stl *.k *.key *.json d3plot*);;All files (*)");
     if (path.isEmpty())
       return 0;
 
@@ -242,17 +270,26 @@ int main(int argc, char* argv[]) try {
     args.explode_view = explodeCheck->isChecked();
   }
 
-  MeshLoadResult loadResult = loadMeshes(args.meshfiles, args.explode_view);
-  if (!loadResult.ok) {
-    std::cerr << loadResult.error << '\n';
-    return loadResult.exitCode;
-  }
+  MeshLoadOptions loadOptions;
+  loadOptions.sharedPoints = args.shared_points;
+  loadOptions.useCache = !args.no_cache;
+  loadOptions.fileSeries = !args.no_series;
 
   ViewerOptions viewerOptions;
   viewerOptions.explodeView = args.explode_view;
   viewerOptions.commonCatLut = args.common_cat_lut;
+  viewerOptions.frameCacheBytes = args.frame_cache_bytes;
+
+  // Missing files and unknown formats fail before any window opens.
+  const MeshLoadResult check = checkMeshFiles(args.meshfiles, args.explode_view, loadOptions);
+  if (!check.ok) {
+    std::cerr << check.error << '\n';
+    return check.exitCode;
+  }
 
-  ViewerWindow window(std::move(loadResult), viewerOptions);
+  // The window opens right away and loads the files in the background; a
+  // parse error quits the event loop with loadMeshes' exit code.
+  ViewerWindow window(args.meshfiles, std::move(loadOptions), viewerOptions);
   window.show();
   return QApplication::exec();
 } catch (const std::exception& e) {
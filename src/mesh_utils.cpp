@@ -1,18 +1,9 @@
 #include "mesh_utils.h"
 
-#include <cstdio>
-#include <string>
-#ifdef _WIN32
-#include <io.h>
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
 #include <array>
 #include <cmath>
-#include <cstdlib>
-#include <cstring>
-#include <vector>
+#include <cstdio>
+#include <string>
 
 std::string readHeader(FILE* f, size_t nbytes) {
   if (!f)
@@ -65,49 +56,3 @@ std::array<double, 3> generateDistinctColor(int i) {
   double v = 1.0;
   return hsv2rgb(h, s, v);
 }
-
-std::string stdinToTempFile() {
-  std::string tmpPath;
-#ifdef _WIN32
-  // GetTempFileName creates the file atomically (no tmpnam race).
-  char tmpDir[MAX_PATH + 1];
-  const DWORD dirLen = GetTempPathA(MAX_PATH, tmpDir);
-  if (dirLen == 0 || dirLen > MAX_PATH)
-    return {};
-  char tmpName[MAX_PATH + 1];
-  if (GetTempFileNameA(tmpDir, "vv", 0, tmpName) == 0)
-    return {};
-  tmpPath = tmpName;
-  FILE* out = fopen(tmpPath.c_str(), "wb");
-  if (!out) {
-    remove(tmpPath.c_str());
-    return {};
-  }
-#else
-  const char* tmpDir = getenv("TMPDIR");
-  std::string tmplStr = std::string(tmpDir && *tmpDir ? tmpDir : "/tmp") + "/vvstdinXXXXXX";
-  std::vector<char> tmpl(tmplStr.begin(), tmplStr.end());
-  tmpl.push_back('\0');
-  int fd = mkstemp(tmpl.data());
-  if (fd == -1)
-    return {};
-  FILE* out = fdopen(fd, "wb");
-  if (!out) {
-    close(fd);
-    unlink(tmpl.data());
-    return {};
-  }
-  tmpPath = tmpl.data();
-#endif
-  char buf[8192];
-  size_t n;
-  while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0) {
-    if (fwrite(buf, 1, n, out) != n) {
-      fclose(out);
-      remove(tmpPath.c_str());
-      return {};
-    }
-  }
-  fclose(out);
-  return tmpPath;
-}
@@ -0,0 +1,34 @@
+#include "parallel_utils.h"
+
+#include <algorithm>
+
+namespace {
+std::atomic<unsigned> gWorkerThreadLimit{0};
+} // namespace
+
+unsigned workerThreadCount() {
+  unsigned count = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned limit = gWorkerThreadLimit.load();
+  if (limit > 0) {
+    count = std::min(count, limit);
+  }
+  const unsigned share = parallel_detail::taskThreadShare();
+  if (share > 0) {
+    count = std::min(count, share);
+  }
+  return count;
+}
+
+void setWorkerThreadLimit(unsigned limit) {
+  gWorkerThreadLimit.store(limit);
+}
+
+bool& parallel_detail::insideParallelRegion() {
+  thread_local bool inside = false;
+  return inside;
+}
+
+unsigned& parallel_detail::taskThreadShare() {
+  thread_local unsigned share = 0;
+  return share;
+}
@@ -0,0 +1,49 @@
+#include "text_scan.h"
+
+#include "parallel_utils.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kMinChunkBytes = size_t{1} << 20;
+
+} // namespace
+
+std::vector<std::pair<const char*, const char*>> splitSection(const char* begin,
+                                                              const char* end,
+                                                              size_t parts,
+                                                              ChunkStartFn isChunkStart) {
+  std::vector<std::pair<const char*, const char*>> ranges;
+  const size_t bytes = static_cast<size_t>(end - begin);
+  const char* chunkBegin = begin;
+  for (size_t i = 1; i < parts; ++i) {
+    const char* cut = begin + bytes / parts * i;
+    if (cut <= chunkBegin)
+      continue;
+    if (cut[-1] != '\n') {
+      const auto* nl =
+          static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+      cut = nl ? nl + 1 : end;
+    }
+    LineReader lines(cut, end);
+    std::string_view line;
+    const char* lineStart = lines.position();
+    while (lines.next(line) && !isChunkStart(line)) {
+      lineStart = lines.position();
+    }
+    cut = std::min(lineStart, end);
+    if (cut >= end)
+      break;
+    ranges.emplace_back(chunkBegin, cut);
+    chunkBegin = cut;
+  }
+  ranges.emplace_back(chunkBegin, end);
+  return ranges;
+}
+
+size_t chunkCountFor(const char* begin, const char* end) {
+  const size_t bytes = static_cast<size_t>(end - begin);
+  return std::max<size_t>(
+      1, std::min<size_t>(size_t{workerThreadCount()} * 4, bytes / kMinChunkBytes));
+}
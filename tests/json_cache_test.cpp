@@ -0,0 +1,76 @@
+// A JSON mesh whose vertices live in an external .bin buffer is cached with the
+// buffer as an input file: editing only the .bin invalidates the entry, and a
+// file that changed while it was parsed is not stored.
+#include "JsonMeshParser.h"
+#include "MeshCache.h"
+#include "test_support.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <vtkPointSet.h>
+#include <vtkPoints.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeVertices(const fs::path& path, float x) {
+  const std::vector<float> vertices = {x, 0, 0, 1, 0, 0, 0, 1, 0};
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(vertices.data()),
+            static_cast<std::streamsize>(vertices.size() * sizeof(float)));
+}
+
+double firstX(const std::vector<vtkSmartPointer<vtkDataSet>>& meshes) {
+  auto* mesh = meshes.empty() ? nullptr : vtkPointSet::SafeDownCast(meshes.front());
+  if (!mesh || !mesh->GetPoints() || mesh->GetNumberOfPoints() == 0) {
+    return -1.0;
+  }
+  double point[3];
+  mesh->GetPoints()->GetPoint(0, point);
+  return point[0];
+}
+
+} // namespace
+
+int main() {
+  const fs::path dir = scratchDirectory("json_cache");
+  const std::string json = (dir / "part.json").string();
+  const fs::path bin = dir / "part.bin";
+  {
+    std::ofstream out(json);
+    out << R"({"name": "part",
+  "vertices": {"uri": "part.bin", "count": 9, "type": "float32"},
+  "indices": [0, 1, 2]})";
+  }
+  writeVertices(bin, 0.0f);
+
+  const MeshCache cache((dir / "cache").string());
+  JsonMeshParser parser;
+  const FileStamp parsedStamp = stampOf(json);
+  const auto parsed = parser.parse(json);
+  CHECK(firstX(parsed) == 0.0);
+  const std::vector<std::string> inputs = parser.inputFiles();
+  CHECK(inputs.size() == 1 && fs::equivalent(inputs.front(), bin));
+  // A file that changed while it was parsed is not stored.
+  FileStamp rewritten = parsedStamp;
+  rewritten.mtime -= 1;
+  CHECK(!cache.store(json, rewritten, parser.cacheTag(), inputs, parsed));
+  CHECK(cache.store(json, parsedStamp, parser.cacheTag(), inputs, parsed));
+  CHECK(firstX(cache.load(json, parser.cacheTag())) == 0.0);
+
+  // Same size, new contents and mtime; the .json is untouched.
+  const auto jsonTime = fs::last_write_time(json);
+  const auto binTime = fs::last_write_time(bin);
+  writeVertices(bin, 5.0f);
+  fs::last_write_time(bin, binTime + std::chrono::seconds(2));
+  CHECK(fs::last_write_time(json) == jsonTime);
+
+  CHECK(cache.load(json, parser.cacheTag()).empty());
+  CHECK(firstX(JsonMeshParser().parse(json)) == 5.0);
+  return testResult();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+// Minimal assertions for the vv_core tests. CHECK reports a failed condition
+// and carries on; a test's main() returns testResult(), non-zero on failure.
+inline int& checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                                           \
+  do {                                                                                             \
+    if (!(condition)) {                                                                            \
+      std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK failed: " #condition << '\n';          \
+      ++checkFailures();                                                                           \
+    }                                                                                              \
+  } while (false)
+
+inline int testResult() {
+  if (checkFailures() > 0) {
+    std::cerr << checkFailures() << " check(s) failed\n";
+    return 1;
+  }
+  return 0;
+}
+
+// A new, empty directory for the files of test `name` under the system
+// temporary directory.
+inline std::filesystem::path scratchDirectory(const std::string& name) {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / ("vv_test_" + name);
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+  std::filesystem::create_directories(dir);
+  return dir;
+}
@@ -0,0 +1,176 @@
+// Stepping through a temporal VTKHDF file with an active array reads only that
+// array: the other point and cell arrays drop out of the frame, the field data
+// (part color) stays, and clearing the selection brings everything back.
+#include "ScalarVizUtils.h"
+#include "TemporalSource.h"
+#include "VTKHDFMeshParser.h"
+#include "test_support.h"
+
+#include <iostream>
+#include <string>
+#include <vtkVersionMacros.h>
+
+#if VTK_VERSION_NUMBER >= VTK_VERSION_CHECK(9, 4, 0)
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkHDFWriter.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+namespace {
+
+constexpr int kSteps = 3;
+
+// One triangle over kSteps time steps: point arrays `pressure` (the step's
+// time) and `temperature`, cell array `material` and a `vv_part_color` field
+// array.
+class StepSource : public vtkPolyDataAlgorithm {
+public:
+  static StepSource* New();
+  vtkTypeMacro(StepSource, vtkPolyDataAlgorithm);
+
+protected:
+  StepSource() {
+    SetNumberOfInputPorts(0);
+  }
+
+  int RequestInformation(vtkInformation*,
+                         vtkInformationVector**,
+                         vtkInformationVector* outputVector) override {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double times[kSteps];
+    for (int step = 0; step < kSteps; ++step) {
+      times[step] = static_cast<double>(step);
+    }
+    const double range[2] = {times[0], times[kSteps - 1]};
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, kSteps);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+  }
+
+  int RequestData(vtkInformation*,
+                  vtkInformationVector**,
+                  vtkInformationVector* outputVector) override {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double time = 0.0;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())) {
+      time = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    }
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+
+    vtkNew<vtkPoints> points;
+    points->InsertNextPoint(0.0, 0.0, 0.0);
+    points->InsertNextPoint(1.0, 0.0, 0.0);
+    points->InsertNextPoint(0.0, 1.0, 0.0);
+    vtkNew<vtkCellArray> triangles;
+    const vtkIdType corners[3] = {0, 1, 2};
+    triangles->InsertNextCell(3, corners);
+    output->SetPoints(points);
+    output->SetPolys(triangles);
+
+    vtkNew<vtkFloatArray> pressure;
+    pressure->SetName("pressure");
+    pressure->SetNumberOfTuples(3);
+    pressure->Fill(time);
+    output->GetPointData()->AddArray(pressure);
+    vtkNew<vtkFloatArray> temperature;
+    temperature->SetName("temperature");
+    temperature->SetNumberOfTuples(3);
+    temperature->Fill(300.0 + time);
+    output->GetPointData()->AddArray(temperature);
+    vtkNew<vtkIntArray> material;
+    material->SetName("material");
+    material->SetNumberOfTuples(1);
+    material->SetValue(0, 7);
+    output->GetCellData()->AddArray(material);
+    vtkNew<vtkDoubleArray> color;
+    color->SetName("vv_part_color");
+    color->SetNumberOfComponents(3);
+    color->InsertNextTuple3(0.5, 0.25, 1.0);
+    output->GetFieldData()->AddArray(color);
+
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    return 1;
+  }
+};
+vtkStandardNewMacro(StepSource);
+
+bool hasPointArray(vtkDataSet* mesh, const char* name) {
+  return arrayForAssociation(mesh, name, FieldAssociation::Point) != nullptr;
+}
+
+bool hasCellArray(vtkDataSet* mesh, const char* name) {
+  return arrayForAssociation(mesh, name, FieldAssociation::Cell) != nullptr;
+}
+
+bool hasPartColor(vtkDataSet* mesh) {
+  return mesh->GetFieldData() && mesh->GetFieldData()->GetArray("vv_part_color");
+}
+
+double pressureAt(vtkDataSet* mesh) {
+  vtkDataArray* pressure = arrayForAssociation(mesh, "pressure", FieldAssociation::Point);
+  return pressure ? pressure->GetComponent(0, 0) : -1.0;
+}
+
+} // namespace
+
+int main() {
+  const std::string path = (scratchDirectory("vtkhdf_active_array") / "run.vtkhdf").string();
+  {
+    vtkNew<StepSource> source;
+    vtkNew<vtkHDFWriter> writer;
+    writer->SetInputConnection(source->GetOutputPort());
+    writer->SetFileName(path.c_str());
+    writer->SetWriteAllTimeSteps(true);
+    CHECK(writer->Write() == 1);
+  }
+
+  VTKHDFMeshParser parser;
+  const auto meshes = parser.parse(path);
+  const auto temporal = parser.temporal();
+  CHECK(meshes.size() == 1);
+  CHECK(temporal && temporal->steps() == kSteps);
+  if (meshes.empty() || !temporal) {
+    return testResult();
+  }
+  vtkDataSet* mesh = meshes.front();
+  CHECK(hasPointArray(mesh, "temperature") && hasCellArray(mesh, "material"));
+  CHECK(hasPartColor(mesh));
+
+  temporal->setActiveArray({"pressure", FieldAssociation::Point});
+  for (int step = 1; step < kSteps; ++step) {
+    CHECK(temporal->readStepInto(step, mesh));
+    CHECK(pressureAt(mesh) == step);
+    CHECK(!hasPointArray(mesh, "temperature"));
+    CHECK(!hasCellArray(mesh, "material"));
+    CHECK(hasPartColor(mesh));
+  }
+
+  temporal->setActiveArray({});
+  CHECK(temporal->readStepInto(0, mesh));
+  CHECK(pressureAt(mesh) == 0.0);
+  CHECK(hasPointArray(mesh, "temperature") && hasCellArray(mesh, "material"));
+  CHECK(hasPartColor(mesh));
+  return testResult();
+}
+
+#else
+
+int main() {
+  std::cout << "vtkhdf_active_array_test: writing VTKHDF needs VTK 9.4; skipped\n";
+  return 0;
+}
+
+#endif